@@ -0,0 +1,35 @@
+#ifndef BUFFEREDDATASINK_H
+#define BUFFEREDDATASINK_H
+
+#include "DataSink.h"
+#include <memory>
+
+// Data sink that collects puts and writes in a buffer and passes them to another sink in writes of
+// the buffer's size. A write at least as large as the buffer is passed on directly after the
+// buffered bytes. A failure of the other sink is returned by the put or write that filled the
+// buffer, or by Flush. The destructor flushes.
+class CBufferedDataSink : public CDataSink{
+    private:
+        std::shared_ptr<CDataSink> DSink;
+        // Sized to DBufferSize up front, the first DLength bytes are buffered
+        std::vector<char> DBuffer;
+        std::size_t DBufferSize;
+        std::size_t DLength = 0;
+        // Reused to pass on a partially filled buffer
+        std::vector<char> DPartial;
+
+        bool Drain() noexcept;
+    public:
+        static constexpr std::size_t DefaultBufferSize = 65536;
+
+        CBufferedDataSink(std::shared_ptr<CDataSink> sink, std::size_t buffersize = DefaultBufferSize);
+        ~CBufferedDataSink();
+
+        std::size_t BufferSize() const noexcept;
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+        bool Flush() noexcept override;
+};
+
+#endif
@@ -22,6 +22,15 @@ class CBusSystem{
             virtual TStopID GetStopID(std::size_t index) const noexcept = 0;
         };
 
+        // Street nodes a bus follows from the node of one stop to the node of the next
+        struct SPath{
+            virtual ~SPath(){};
+            virtual CStreetMap::TNodeID StartNodeID() const noexcept = 0;
+            virtual CStreetMap::TNodeID EndNodeID() const noexcept = 0;
+            virtual std::size_t NodeCount() const noexcept = 0;
+            virtual CStreetMap::TNodeID GetNodeID(std::size_t index) const noexcept = 0;
+        };
+
         virtual ~CBusSystem(){};
 
         virtual std::size_t StopCount() const noexcept = 0;
@@ -30,6 +39,14 @@ class CBusSystem{
         virtual std::shared_ptr<SStop> StopByID(TStopID id) const noexcept = 0;
         virtual std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept = 0;
         virtual std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept = 0;
+
+        // Bus systems without path geometry have no paths
+        virtual std::size_t PathCount() const noexcept{
+            return 0;
+        }
+        virtual std::shared_ptr<SPath> PathByIndex(std::size_t) const noexcept{
+            return nullptr;
+        }
 };
 
 #endif
@@ -9,7 +9,7 @@ class CCSVBusSystem : public CBusSystem{
         struct SImplementation;
         std::unique_ptr< SImplementation > DImplementation;
     public:
-        CCSVBusSystem(std::shared_ptr< CDSVReader > stopsrc, std::shared_ptr< CDSVReader > routesrc);
+        CCSVBusSystem(std::shared_ptr< CDSVReader > stopsrc, std::shared_ptr< CDSVReader > routesrc, std::shared_ptr< CDSVReader > pathsrc = nullptr);
         ~CCSVBusSystem();
 
         std::size_t StopCount() const noexcept override;
@@ -18,6 +18,8 @@ class CCSVBusSystem : public CBusSystem{
         std::shared_ptr<SStop> StopByID(TStopID id) const noexcept override;
         std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept override;
         std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept override;
+        std::size_t PathCount() const noexcept override;
+        std::shared_ptr<SPath> PathByIndex(std::size_t index) const noexcept override;
 };
 
 #endif
@@ -0,0 +1,33 @@
+#ifndef CONTRACTIONHIERARCHYPATHROUTER_H
+#define CONTRACTIONHIERARCHYPATHROUTER_H
+
+#include "PathRouter.h"
+#include <memory>
+
+class CContractionHierarchyPathRouter : public CPathRouter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        CContractionHierarchyPathRouter();
+        ~CContractionHierarchyPathRouter();
+
+        // Number of vertices contracted by the last Precompute, the rest form the uncontracted core
+        std::size_t ContractedCount() const noexcept;
+        std::size_t ShortcutCount() const noexcept;
+
+        std::size_t VertexCount() const noexcept;
+        TVertexID AddVertex(std::any tag) noexcept;
+        std::any GetVertexTag(TVertexID id) const noexcept;
+        bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept;
+        bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept;
+        double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept;
+        std::unique_ptr<SQueryWorkspace> CreateWorkspace() const;
+        double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept;
+        std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept;
+        std::vector< std::vector<double> > FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept;
+        std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept;
+        bool ConcurrentQueries() const noexcept;
+};
+
+#endif
@@ -8,6 +8,10 @@ class CDataSink{
         virtual ~CDataSink(){};
         virtual bool Put(const char &ch) noexcept = 0;
         virtual bool Write(const std::vector<char> &buf) noexcept = 0;
+        // Passes anything the sink holds on to its destination, sinks without a buffer have nothing to do
+        virtual bool Flush() noexcept{
+            return true;
+        }
 };
 
 #endif
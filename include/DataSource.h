@@ -1,6 +1,7 @@
 #ifndef DATASOURCE_H
 #define DATASOURCE_H
 
+#include <utility>
 #include <vector>
 
 class CDataSource{
@@ -10,6 +11,14 @@ class CDataSource{
         virtual bool Get(char &ch) noexcept = 0;
         virtual bool Peek(char &ch) noexcept = 0;
         virtual bool Read(std::vector<char> &buf, std::size_t count) noexcept = 0;
+        // Contiguous view of the next unread bytes, empty only at the end. The view is valid until the
+        // next call on the source. Advance marks up to count bytes of it as read.
+        virtual std::pair< const char *, std::size_t > Chunk() noexcept = 0;
+        virtual void Advance(std::size_t count) noexcept = 0;
+        // True if every chunk stays valid after Advance for as long as the source lives
+        virtual bool StableChunks() const noexcept{
+            return false;
+        }
 };
 
 #endif
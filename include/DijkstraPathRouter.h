@@ -3,21 +3,53 @@
 
 #include "PathRouter.h"
 #include <memory>
+#include <functional>
+
+class CMultiMetricGraph;
 
 class CDijkstraPathRouter : public CPathRouter{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
     public:
-        CDijkstraPathRouter();
+        enum class EQueueType {Rebuild, BinaryHeap, QuaternaryHeap};
+        // Lower bound on the path weight from vertex to dest, must never overestimate
+        using THeuristic = std::function< double(TVertexID vertex, TVertexID dest) >;
+
+        CDijkstraPathRouter(EQueueType queuetype = EQueueType::QuaternaryHeap);
         ~CDijkstraPathRouter();
 
+        EQueueType QueueType() const noexcept;
+        void SetHeuristic(THeuristic heuristic) noexcept;
+
+        // Landmarks selected by the next Precompute for ALT lower bounds, zero disables them
+        void SetLandmarkCount(std::size_t count) noexcept;
+        std::size_t LandmarkCount() const noexcept;
+        std::size_t SelectedLandmarkCount() const noexcept;
+        std::size_t LandmarkBytes() const noexcept;
+        std::chrono::steady_clock::duration LandmarkSelectionTime() const noexcept;
+        // Selected landmarks and their distance tables, to restore them into a router with the same
+        // graph so its next Precompute does not select them again. Setting fails if the tables do not
+        // fit the graph.
+        void GetLandmarkTables(std::vector< TVertexID > &landmarks, std::vector< double > &from, std::vector< double > &to) const;
+        bool SetLandmarkTables(std::vector< TVertexID > landmarks, std::vector< double > from, std::vector< double > to) noexcept;
+
+        // Searches metric of a frozen graph shared with other routers in place of the router's own
+        // vertices and edges, which are dropped. AddVertex and AddEdge fail from then on.
+        bool ShareGraph(std::shared_ptr< const CMultiMetricGraph > graph, std::size_t metric) noexcept;
+
         std::size_t VertexCount() const noexcept;
         TVertexID AddVertex(std::any tag) noexcept;
         std::any GetVertexTag(TVertexID id) const noexcept;
         bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept;
         bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept;
         double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept;
+        std::unique_ptr<SQueryWorkspace> CreateWorkspace() const;
+        double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept;
+        std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept;
+        std::vector< std::vector<double> > FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept;
+        std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept;
+        bool ConcurrentQueries() const noexcept;
 };
 
 #endif
@@ -2,20 +2,67 @@
 #define DIJKSTRATRANSPORTATIONPLANNER_H
 
 #include "TransportationPlanner.h"
+#include <functional>
+
+class CThreadPool;
+class CPathCache;
 
 class CDijkstraTransportationPlanner : public CTransportationPlanner{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
+
+        CDijkstraTransportationPlanner(std::unique_ptr<SImplementation> implementation);
     public:
-        CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config);
+        // Creates the empty router used for each travel metric, defaults to CDijkstraPathRouter
+        using TRouterFactory = std::function< std::shared_ptr< CPathRouter >() >;
+        using TNodePair = std::pair< TNodeID, TNodeID >;
+        // How FindFastestPath finds trips on foot and by bus: a search of the layered walk/bus router,
+        // or RAPTOR rounds over the bus routes with walks to, from and between the stops
+        enum class ETransitEngine {Graph, Raptor};
+
+        CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config, TRouterFactory routerfactory = nullptr, ETransitEngine transitengine = ETransitEngine::Graph);
         ~CDijkstraTransportationPlanner();
 
+        // Writes the built graph, its node tables, the transit routes and the selected landmarks to a
+        // snapshot file tagged with sourcekey, such as CGraphSnapshot::FileKey of the input files
+        bool SaveSnapshot(const std::string &path, uint64_t sourcekey) const;
+        // Builds a planner from a snapshot without the street map or bus system of config, which only
+        // gives the speeds and precompute time. Returns nullptr, so the caller can build from the
+        // sources instead, if the snapshot is missing or damaged, of another format version, saved
+        // from other sources than sourcekey, or saved with another transit engine or other speeds.
+        static std::shared_ptr<CDijkstraTransportationPlanner> LoadSnapshot(const std::string &path, uint64_t sourcekey, std::shared_ptr<SConfiguration> config, TRouterFactory routerfactory = nullptr, ETransitEngine transitengine = ETransitEngine::Graph);
+
         std::size_t NodeCount() const noexcept override;
         std::shared_ptr<CStreetMap::SNode> SortedNodeByIndex(std::size_t index) const noexcept override;
 
         double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path) override;
         double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path) override;
+        std::unique_ptr<SQueryContext> CreateQueryContext() const override;
+        double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path, SQueryContext &context) const override;
+        double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path, SQueryContext &context) const override;
+        // Batch queries spread over the pool with one query context per worker, the results are in
+        // the order of pairs
+        std::vector< double > FindShortestPaths(const std::vector< TNodePair > &pairs, std::vector< std::vector< TNodeID > > &paths, CThreadPool &pool) const;
+        std::vector< double > FindFastestPaths(const std::vector< TNodePair > &pairs, std::vector< std::vector< TTripStep > > &paths, CThreadPool &pool) const;
+        // One-to-many and many-to-many queries that search from each source once for all of the
+        // destinations. Entries with no path, or with a node not in the map, are CPathRouter::NoPathExists.
+        std::vector< double > FindShortestDistances(TNodeID src, const std::vector< TNodeID > &dests, SQueryContext &context) const;
+        std::vector< double > FindFastestTimes(TNodeID src, const std::vector< TNodeID > &dests, SQueryContext &context) const;
+        std::vector< std::vector< double > > FindShortestDistanceMatrix(const std::vector< TNodeID > &srcs, const std::vector< TNodeID > &dests, SQueryContext &context) const;
+        std::vector< std::vector< double > > FindFastestTimeMatrix(const std::vector< TNodeID > &srcs, const std::vector< TNodeID > &dests, SQueryContext &context) const;
+        // Nodes reachable from src within budget in order of travel cost. The budget is in seconds of
+        // travel by mode, by bike or on foot and by bus for Walk and Bus, or in miles for ReachableWithinDistance.
+        std::vector< TNodeID > ReachableWithin(TNodeID src, double budget, ETransportationMode mode, SQueryContext &context) const;
+        std::vector< TNodeID > ReachableWithinDistance(TNodeID src, double budget, SQueryContext &context) const;
+        // Convex hull of the node locations, such as a reachable region to write with CKMLWriter::CreatePolygon
+        std::vector< CStreetMap::TLocation > RegionOutline(const std::vector< TNodeID > &nodes) const;
+        // Keeps up to entries shortest and fastest path results, least recently used first out, which all
+        // of the path queries share. Zero turns the cache off, which is the default. Not safe to call
+        // while queries run.
+        void SetPathCacheCapacity(std::size_t entries);
+        // The path cache with its hit and miss counters, nullptr when it is off
+        CPathCache *PathCache() const noexcept;
         bool GetPathDescription(const std::vector< TTripStep > &path, std::vector< std::string > &desc) const override;
 };
 
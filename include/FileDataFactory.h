@@ -4,12 +4,17 @@
 #include "DataFactory.h"
 
 class CFileDataFactory : public CDataFactory{
+    public:
+        // Sources read through std::ifstream, or from the file mapped into memory by CMMapDataSource
+        enum class ESourceType {Stream, MemoryMapped};
+
     private:
         std::string DBasePath;
+        ESourceType DSourceType;
 
     public:
-        CFileDataFactory(const std::string &path);
-;
+        CFileDataFactory(const std::string &path, ESourceType sourcetype = ESourceType::Stream);
+
         std::shared_ptr< CDataSource > CreateSource(const std::string &name) noexcept override;
         std::shared_ptr< CDataSink > CreateSink(const std::string &name) noexcept override;
 };
@@ -12,6 +12,7 @@ class CFileDataSink : public CDataSink{
 
         bool Put(const char &ch) noexcept override;
         bool Write(const std::vector<char> &buf) noexcept override;
+        bool Flush() noexcept override;
 };
 
 #endif
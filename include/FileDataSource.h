@@ -7,6 +7,12 @@
 class CFileDataSource : public CDataSource{
     private:
         std::ifstream DFile;
+        // Block read from the file, the unread bytes are [DIndex, DBuffer.size()). It is refilled as
+        // soon as it runs out, so it is only empty at the end of the file.
+        std::vector<char> DBuffer;
+        std::size_t DIndex = 0;
+
+        void Fill();
     public:
         CFileDataSource(const std::string &filename);
 
@@ -14,6 +20,8 @@ class CFileDataSource : public CDataSource{
         bool Get(char &ch) noexcept override;
         bool Peek(char &ch) noexcept override;
         bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+        std::pair< const char *, std::size_t > Chunk() noexcept override;
+        void Advance(std::size_t count) noexcept override;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #define GEOGRAPHICUTILS_H
 
 #include "StreetMap.h"
+#include <vector>
 
 struct SGeographicUtils{
     static double DegreesToRadians(double deg);
@@ -10,6 +11,10 @@ struct SGeographicUtils{
     static double CalculateBearing(CStreetMap::TLocation src, CStreetMap::TLocation dest);
     static std::string BearingToDirection(double bearing);
     static std::string ConvertLLToDMS(CStreetMap::TLocation loc);
+    // Convex hull of the locations in counterclockwise order, treating latitude and longitude as
+    // planar coordinates. Fewer than three distinct locations are returned as they are, and collinear
+    // locations give their two end points.
+    static std::vector< CStreetMap::TLocation > ConvexHull(std::vector< CStreetMap::TLocation > locs);
 };
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Versioned binary file of typed arrays, called sections, each named by a number. The header holds
+// the format version, a key of the sources the file was built from and a checksum of everything
+// after the header. Open maps the file read only with mmap and verifies it, so the sections are
+// read in place or with one copy each instead of being parsed.
+class CGraphSnapshot{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+        CGraphSnapshot();
+        std::pair< const void *, std::size_t > RawSection(uint32_t id, std::size_t elementsize) const noexcept;
+
+    public:
+        static constexpr uint32_t Version = 1;
+
+        // Collects sections in memory and writes them out as one snapshot
+        class CWriter{
+            private:
+                struct SSection{
+                    uint32_t DID;
+                    uint32_t DElementSize;
+                    std::vector< char > DData;
+                };
+                std::vector< SSection > DSections;
+
+            public:
+                template <typename T>
+                void Add(uint32_t id, const std::vector< T > &values){
+                    static_assert(std::is_trivially_copyable< T >::value, "snapshot sections hold plain values");
+                    SSection Section{id, uint32_t(sizeof(T)), std::vector< char >(values.size() * sizeof(T))};
+                    if(!values.empty()){
+                        std::memcpy(Section.DData.data(), values.data(), Section.DData.size());
+                    }
+                    DSections.push_back(std::move(Section));
+                }
+
+                // Writes a temporary file and renames it over path, so a reader never sees a partial snapshot
+                bool Write(const std::string &path, uint64_t sourcekey) const;
+        };
+
+        ~CGraphSnapshot();
+
+        // Maps and verifies the snapshot at path. Returns nullptr if it is missing, truncated, of
+        // another version or byte order, built from other sources than sourcekey, or fails its checksum.
+        static std::unique_ptr< CGraphSnapshot > Open(const std::string &path, uint64_t sourcekey);
+        // Key of source files from their sizes and modification times, it changes when one is replaced
+        // or edited
+        static uint64_t FileKey(const std::vector< std::string > &paths);
+
+        uint64_t SourceKey() const noexcept;
+        std::size_t Bytes() const noexcept;
+        std::size_t SectionCount() const noexcept;
+        bool HasSection(uint32_t id) const noexcept;
+
+        // The section's values in the mapping, valid while the snapshot is open. Null if the section is
+        // missing or holds values of another size, an empty section is not null.
+        template <typename T>
+        std::pair< const T *, std::size_t > View(uint32_t id) const noexcept{
+            static_assert(std::is_trivially_copyable< T >::value, "snapshot sections hold plain values");
+            auto Raw = RawSection(id, sizeof(T));
+            return std::make_pair(static_cast< const T * >(Raw.first), Raw.second);
+        }
+
+        // Copies the section's values out of the mapping, fails like View
+        template <typename T>
+        bool Read(uint32_t id, std::vector< T > &values) const{
+            auto Section = View< T >(id);
+            if(!Section.first){
+                return false;
+            }
+            values.assign(Section.first, Section.first + Section.second);
+            return true;
+        }
+};
+
+#endif
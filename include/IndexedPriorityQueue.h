@@ -0,0 +1,224 @@
+#ifndef INDEXEDPRIORITYQUEUE_H
+#define INDEXEDPRIORITYQUEUE_H
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+// Min-priority queue over the keys [0, capacity) backed by an Arity-ary heap.
+// A position map from key to heap slot allows a queued key to have its priority
+// lowered in place (decrease-key), so every key is in the heap at most once.
+template <std::size_t Arity>
+class CIndexedPriorityQueue{
+    static_assert(Arity >= 2, "Heap arity must be at least two");
+    public:
+        using TKey = std::size_t;
+        static constexpr std::size_t NotQueued = std::numeric_limits<std::size_t>::max();
+
+    private:
+        std::vector< std::pair< double, TKey > > DHeap;
+        std::vector< std::size_t > DPositions;
+
+        void Place(std::size_t index, const std::pair< double, TKey > &entry){
+            DHeap[index] = entry;
+            DPositions[entry.second] = index;
+        }
+
+        void SiftUp(std::size_t index){
+            auto Entry = DHeap[index];
+            while(index){
+                std::size_t Parent = (index - 1) / Arity;
+                if(DHeap[Parent].first <= Entry.first){
+                    break;
+                }
+                Place(index, DHeap[Parent]);
+                index = Parent;
+            }
+            Place(index, Entry);
+        }
+
+        void SiftDown(std::size_t index){
+            auto Entry = DHeap[index];
+            std::size_t Count = DHeap.size();
+            while(true){
+                std::size_t FirstChild = index * Arity + 1;
+                if(FirstChild >= Count){
+                    break;
+                }
+                std::size_t LastChild = std::min(FirstChild + Arity, Count);
+                std::size_t Smallest = FirstChild;
+                for(std::size_t Child = FirstChild + 1; Child < LastChild; Child++){
+                    if(DHeap[Child].first < DHeap[Smallest].first){
+                        Smallest = Child;
+                    }
+                }
+                if(Entry.first <= DHeap[Smallest].first){
+                    break;
+                }
+                Place(index, DHeap[Smallest]);
+                index = Smallest;
+            }
+            Place(index, Entry);
+        }
+
+    public:
+        CIndexedPriorityQueue(std::size_t capacity = 0) : DPositions(capacity, NotQueued){
+
+        }
+
+        // Grows the key space, keys already queued keep their positions.
+        void Reserve(std::size_t capacity){
+            if(DPositions.size() < capacity){
+                DPositions.resize(capacity, NotQueued);
+            }
+        }
+
+        std::size_t Capacity() const noexcept{
+            return DPositions.size();
+        }
+
+        bool Empty() const noexcept{
+            return DHeap.empty();
+        }
+
+        std::size_t Size() const noexcept{
+            return DHeap.size();
+        }
+
+        bool Contains(TKey key) const noexcept{
+            return (key < DPositions.size())&&(NotQueued != DPositions[key]);
+        }
+
+        // Inserts key, or lowers its priority if it is already queued with a larger one.
+        void Push(TKey key, double priority){
+            if(NotQueued == DPositions[key]){
+                DHeap.push_back(std::make_pair(priority, key));
+                DPositions[key] = DHeap.size() - 1;
+                SiftUp(DHeap.size() - 1);
+            }
+            else if(priority < DHeap[DPositions[key]].first){
+                DHeap[DPositions[key]].first = priority;
+                SiftUp(DPositions[key]);
+            }
+        }
+
+        TKey Top() const noexcept{
+            return DHeap.front().second;
+        }
+
+        double TopPriority() const noexcept{
+            return DHeap.front().first;
+        }
+
+        TKey Pop(){
+            TKey Key = DHeap.front().second;
+            DPositions[Key] = NotQueued;
+            if(1 < DHeap.size()){
+                auto Last = DHeap.back();
+                DHeap.pop_back();
+                Place(0, Last);
+                SiftDown(0);
+            }
+            else{
+                DHeap.pop_back();
+            }
+            return Key;
+        }
+
+        // Empties the queue, only the keys still queued have their positions reset.
+        void Clear() noexcept{
+            for(auto &Entry : DHeap){
+                DPositions[Entry.second] = NotQueued;
+            }
+            DHeap.clear();
+        }
+};
+
+// Priority queue with the same interface that keeps an unordered pending list
+// and rebuilds a binary heap over it with std::make_heap on every pop. This is
+// the frontier the router originally used and is kept as a baseline to compare
+// the indexed heaps against.
+class CRebuildPriorityQueue{
+    public:
+        using TKey = std::size_t;
+        static constexpr std::size_t NotQueued = std::numeric_limits<std::size_t>::max();
+
+    private:
+        std::vector< std::pair< double, TKey > > DPending;
+        std::vector< std::size_t > DPositions;
+
+        static bool EntryCompare(const std::pair< double, TKey > &left, const std::pair< double, TKey > &right){
+            return left.first > right.first;
+        }
+
+    public:
+        CRebuildPriorityQueue(std::size_t capacity = 0) : DPositions(capacity, NotQueued){
+
+        }
+
+        void Reserve(std::size_t capacity){
+            if(DPositions.size() < capacity){
+                DPositions.resize(capacity, NotQueued);
+            }
+        }
+
+        std::size_t Capacity() const noexcept{
+            return DPositions.size();
+        }
+
+        bool Empty() const noexcept{
+            return DPending.empty();
+        }
+
+        std::size_t Size() const noexcept{
+            return DPending.size();
+        }
+
+        bool Contains(TKey key) const noexcept{
+            return (key < DPositions.size())&&(NotQueued != DPositions[key]);
+        }
+
+        void Push(TKey key, double priority){
+            if(NotQueued == DPositions[key]){
+                DPositions[key] = DPending.size();
+                DPending.push_back(std::make_pair(priority, key));
+            }
+            else if(priority < DPending[DPositions[key]].first){
+                DPending[DPositions[key]].first = priority;
+            }
+        }
+
+        TKey Top(){
+            std::make_heap(DPending.begin(), DPending.end(), EntryCompare);
+            for(std::size_t Index = 0; Index < DPending.size(); Index++){
+                DPositions[DPending[Index].second] = Index;
+            }
+            return DPending.front().second;
+        }
+
+        double TopPriority(){
+            Top();
+            return DPending.front().first;
+        }
+
+        TKey Pop(){
+            TKey Key = Top();
+            std::pop_heap(DPending.begin(), DPending.end(), EntryCompare);
+            DPending.pop_back();
+            DPositions[Key] = NotQueued;
+            for(std::size_t Index = 0; Index < DPending.size(); Index++){
+                DPositions[DPending[Index].second] = Index;
+            }
+            return Key;
+        }
+
+        void Clear() noexcept{
+            for(auto &Entry : DPending){
+                DPositions[Entry.second] = NotQueued;
+            }
+            DPending.clear();
+        }
+};
+
+#endif
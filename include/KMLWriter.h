@@ -18,9 +18,12 @@ class CKMLWriter{
         
         bool CreatePointStyle(const std::string &stylename, unsigned int color);
         bool CreateLineStyle(const std::string &stylename, unsigned int color, int width);
+        bool CreatePolygonStyle(const std::string &stylename, unsigned int linecolor, unsigned int fillcolor, int width);
 
         bool CreatePoint(const std::string &name, const std::string &desc, const std::string &stylename, CStreetMap::TLocation point);
         bool CreatePath(const std::string &name, const std::string &stylename, const std::vector< CStreetMap::TLocation > &points);
+        // The outer boundary is closed back to the first point, which points need not repeat
+        bool CreatePolygon(const std::string &name, const std::string &stylename, const std::vector< CStreetMap::TLocation > &points);
 };
 
 #endif
@@ -0,0 +1,34 @@
+#ifndef MMAPDATASOURCE_H
+#define MMAPDATASOURCE_H
+
+#include "DataSource.h"
+#include <string>
+#include <utility>
+
+// Data source over a file mapped read only into memory. Get, Peek and Read are served straight
+// from the mapping, and Chunk gives the unread bytes without copying them. A file that cannot be
+// opened or mapped reads as empty.
+class CMMapDataSource : public CDataSource{
+    private:
+        const char *DData = nullptr;
+        std::size_t DSize = 0;
+        std::size_t DPosition = 0;
+
+    public:
+        CMMapDataSource(const std::string &filename);
+        ~CMMapDataSource();
+        CMMapDataSource(const CMMapDataSource &) = delete;
+        CMMapDataSource &operator=(const CMMapDataSource &) = delete;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        // The unread bytes are all in one chunk, which stays valid while the source lives
+        std::pair< const char *, std::size_t > Chunk() noexcept override;
+        void Advance(std::size_t count) noexcept override;
+        bool StableChunks() const noexcept override;
+};
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef MULTIMETRICGRAPH_H
+#define MULTIMETRICGRAPH_H
+
+#include "PathRouter.h"
+#include <any>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Directed graph whose vertices and edges are stored once for several metrics. Each edge carries
+// one weight per metric, and a weight of NoPathExists leaves the edge out of that metric. Freeze
+// packs the edges into compressed sparse row arrays with one weight array per metric, so a search
+// over one metric reads the shared targets and only that metric's weights. Routers such as
+// CDijkstraPathRouter can search a metric of a frozen graph without copying it. Adding to a frozen
+// graph thaws it, and routers sharing it must not search it until it is frozen again.
+class CMultiMetricGraph{
+    public:
+        using TVertexID = CPathRouter::TVertexID;
+        using TCompactIndex = uint32_t;
+
+    private:
+        std::size_t DMetricCount;
+        std::vector< std::any > DVertexTags;
+
+        // Edges in the order they were added while the graph is being built, DPendingWeights holds
+        // DMetricCount weights per edge
+        std::vector< TVertexID > DPendingSources;
+        std::vector< TVertexID > DPendingTargets;
+        std::vector< double > DPendingWeights;
+
+        // Compressed sparse row arrays built by Freeze, the outgoing edges of vertex v are the
+        // entries [DEdgeOffsets[v], DEdgeOffsets[v+1]) of the targets and of each metric's weights
+        bool DFrozen = false;
+        std::vector< TCompactIndex > DEdgeOffsets;
+        std::vector< TCompactIndex > DEdgeTargets;
+        std::vector< std::vector< double > > DEdgeWeights;
+
+        void AddPendingEdge(TVertexID src, TVertexID dest, const std::vector< double > &weights){
+            DPendingSources.push_back(src);
+            DPendingTargets.push_back(dest);
+            DPendingWeights.insert(DPendingWeights.end(), weights.begin(), weights.end());
+        }
+
+    public:
+        CMultiMetricGraph(std::size_t metriccount) : DMetricCount(metriccount), DEdgeWeights(metriccount){
+
+        }
+
+        std::size_t MetricCount() const noexcept{
+            return DMetricCount;
+        }
+
+        std::size_t VertexCount() const noexcept{
+            return DVertexTags.size();
+        }
+
+        std::size_t EdgeCount() const noexcept{
+            return DFrozen ? DEdgeTargets.size() : DPendingTargets.size();
+        }
+
+        bool Frozen() const noexcept{
+            return DFrozen;
+        }
+
+        TVertexID AddVertex(std::any tag){
+            Thaw();
+            DVertexTags.push_back(std::move(tag));
+            return DVertexTags.size() - 1;
+        }
+
+        std::any GetVertexTag(TVertexID id) const noexcept{
+            if(id < DVertexTags.size()){
+                return DVertexTags[id];
+            }
+            return std::any();
+        }
+
+        // weights holds one weight per metric. Fails for unknown vertices, negative weights or a wrong
+        // number of weights.
+        bool AddEdge(TVertexID src, TVertexID dest, const std::vector< double > &weights, bool bidir = false){
+            if((VertexCount() <= src) || (VertexCount() <= dest) || (weights.size() != DMetricCount)){
+                return false;
+            }
+            for(auto Weight : weights){
+                if(Weight < 0.0){
+                    return false;
+                }
+            }
+            Thaw();
+            AddPendingEdge(src, dest, weights);
+            if(bidir){
+                AddPendingEdge(dest, src, weights);
+            }
+            return true;
+        }
+
+        // Packs the edges into the compressed sparse row arrays, keeping each vertex's edges in the
+        // order they were added. Fails if the graph is too large for the compact index type.
+        bool Freeze(){
+            if(DFrozen){
+                return true;
+            }
+            auto EdgeCount = DPendingTargets.size();
+            if((std::numeric_limits<TCompactIndex>::max() <= VertexCount())||(std::numeric_limits<TCompactIndex>::max() <= EdgeCount)){
+                return false;
+            }
+            DEdgeOffsets.assign(VertexCount() + 1, 0);
+            for(auto Source : DPendingSources){
+                DEdgeOffsets[Source + 1]++;
+            }
+            for(std::size_t Index = 1; Index <= VertexCount(); Index++){
+                DEdgeOffsets[Index] += DEdgeOffsets[Index - 1];
+            }
+            DEdgeTargets.resize(EdgeCount);
+            for(auto &Weights : DEdgeWeights){
+                Weights.resize(EdgeCount);
+            }
+            std::vector< TCompactIndex > NextSlot(DEdgeOffsets.begin(), DEdgeOffsets.end() - 1);
+            for(std::size_t Edge = 0; Edge < EdgeCount; Edge++){
+                auto Slot = NextSlot[DPendingSources[Edge]]++;
+                DEdgeTargets[Slot] = DPendingTargets[Edge];
+                for(std::size_t Metric = 0; Metric < DMetricCount; Metric++){
+                    DEdgeWeights[Metric][Slot] = DPendingWeights[Edge * DMetricCount + Metric];
+                }
+            }
+            std::vector< TVertexID >().swap(DPendingSources);
+            std::vector< TVertexID >().swap(DPendingTargets);
+            std::vector< double >().swap(DPendingWeights);
+            DFrozen = true;
+            return true;
+        }
+
+        // Expands the compressed sparse row arrays back into the pending edges, grouped by source
+        void Thaw(){
+            if(!DFrozen){
+                return;
+            }
+            for(TVertexID VertexID = 0; VertexID + 1 < DEdgeOffsets.size(); VertexID++){
+                for(auto Index = DEdgeOffsets[VertexID]; Index < DEdgeOffsets[VertexID + 1]; Index++){
+                    DPendingSources.push_back(VertexID);
+                    DPendingTargets.push_back(DEdgeTargets[Index]);
+                    for(auto &Weights : DEdgeWeights){
+                        DPendingWeights.push_back(Weights[Index]);
+                    }
+                }
+            }
+            std::vector< TCompactIndex >().swap(DEdgeOffsets);
+            std::vector< TCompactIndex >().swap(DEdgeTargets);
+            for(auto &Weights : DEdgeWeights){
+                std::vector< double >().swap(Weights);
+            }
+            DFrozen = false;
+        }
+
+        // Compressed sparse row arrays of a frozen graph, such as to save it
+        const std::vector< TCompactIndex > &EdgeOffsets() const noexcept{
+            return DEdgeOffsets;
+        }
+
+        const std::vector< TCompactIndex > &EdgeTargets() const noexcept{
+            return DEdgeTargets;
+        }
+
+        const std::vector< double > &EdgeWeights(std::size_t metric) const noexcept{
+            return DEdgeWeights[metric];
+        }
+
+        // Replaces the graph with frozen arrays, such as ones saved from another graph. Fails and
+        // leaves the graph unchanged if the arrays do not describe a graph with one weight array per metric.
+        bool Assign(std::vector< std::any > tags, std::vector< TCompactIndex > offsets, std::vector< TCompactIndex > targets, std::vector< std::vector< double > > weights){
+            if((offsets.size() != tags.size() + 1) || offsets.front() || (offsets.back() != targets.size()) || (weights.size() != DMetricCount) || (std::numeric_limits<TCompactIndex>::max() <= tags.size())){
+                return false;
+            }
+            for(std::size_t Index = 1; Index < offsets.size(); Index++){
+                if(offsets[Index] < offsets[Index - 1]){
+                    return false;
+                }
+            }
+            for(auto Target : targets){
+                if(tags.size() <= Target){
+                    return false;
+                }
+            }
+            for(auto &Weights : weights){
+                if(Weights.size() != targets.size()){
+                    return false;
+                }
+            }
+            DVertexTags = std::move(tags);
+            std::vector< TVertexID >().swap(DPendingSources);
+            std::vector< TVertexID >().swap(DPendingTargets);
+            std::vector< double >().swap(DPendingWeights);
+            DEdgeOffsets = std::move(offsets);
+            DEdgeTargets = std::move(targets);
+            DEdgeWeights = std::move(weights);
+            DFrozen = true;
+            return true;
+        }
+
+        // Calls function(target, weight) for each outgoing edge of the vertex that metric has, the
+        // graph must be frozen
+        template <typename TFunction>
+        void ForEachEdge(TVertexID id, std::size_t metric, TFunction function) const{
+            const double *Weights = DEdgeWeights[metric].data();
+            auto End = DEdgeOffsets[id + 1];
+            for(auto Index = DEdgeOffsets[id]; Index < End; Index++){
+                if(CPathRouter::NoPathExists != Weights[Index]){
+                    function(TVertexID(DEdgeTargets[Index]), Weights[Index]);
+                }
+            }
+        }
+
+        // Calls function(source, target, weight) for each edge that metric has, whether or not the
+        // graph is frozen
+        template <typename TFunction>
+        void ForEachEdge(std::size_t metric, TFunction function) const{
+            if(DFrozen){
+                for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+                    ForEachEdge(VertexID, metric, [&](TVertexID target, double weight){
+                        function(VertexID, target, weight);
+                    });
+                }
+                return;
+            }
+            for(std::size_t Edge = 0; Edge < DPendingTargets.size(); Edge++){
+                auto Weight = DPendingWeights[Edge * DMetricCount + metric];
+                if(CPathRouter::NoPathExists != Weight){
+                    function(DPendingSources[Edge], DPendingTargets[Edge], Weight);
+                }
+            }
+        }
+};
+
+#endif
@@ -4,15 +4,32 @@
 #include "XMLReader.h"
 #include "StreetMap.h"
 
+class CThreadPool;
+
 class COpenStreetMap : public CStreetMap{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
 
     public:
+        static constexpr std::size_t MinParallelChunkSize = 256 * 1024;
+        static constexpr std::size_t ParallelChunksPerThread = 4;
+
         COpenStreetMap(std::shared_ptr<CXMLReader> src);
+        // Builds the map straight from expat's callbacks without queuing entities, the fast path
+        // for loading a whole OSM file. chunksize is the most bytes parsed at a time.
+        COpenStreetMap(std::shared_ptr<CDataSource> src, std::size_t chunksize = CXMLReader::DefaultChunkSize);
+        // Reads the whole source, splits it before top level node and way elements into chunks of
+        // about splitsize bytes and parses them on the pool, chunksize bytes at a time. The map is the
+        // same as parsing it in one pass, which is done instead if a chunk fails to parse. Zero
+        // splitsize makes ParallelChunksPerThread chunks per thread of at least MinParallelChunkSize.
+        COpenStreetMap(std::shared_ptr<CDataSource> src, CThreadPool &pool, std::size_t splitsize = 0, std::size_t chunksize = CXMLReader::DefaultChunkSize);
         ~COpenStreetMap();
 
+        // Bytes parsed to build the map and the time spent parsing them, which includes building the
+        // nodes and ways for the expat ingest
+        CXMLReader::SParseStatistics ParseStatistics() const noexcept;
+
         std::size_t NodeCount() const noexcept override;
         std::size_t WayCount() const noexcept override;
         std::shared_ptr<CStreetMap::SNode> NodeByIndex(std::size_t index) const noexcept override;
@@ -0,0 +1,58 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "TransportationPlanner.h"
+#include <memory>
+#include <vector>
+
+// Bounded least recently used cache of path query results keyed by source, destination and
+// metric. The entries are split over shards by key, each with its own lock and recency list, so
+// threads querying different pairs rarely wait on each other. Hits and misses are counted.
+class CPathCache{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        using TNodeID = CTransportationPlanner::TNodeID;
+        using TTripStep = CTransportationPlanner::TTripStep;
+
+        enum class EMetric {Distance, Time};
+
+        struct SKey{
+            TNodeID DSource;
+            TNodeID DDestination;
+            EMetric DMetric;
+
+            bool operator==(const SKey &key) const noexcept{
+                return DSource == key.DSource && DDestination == key.DDestination && DMetric == key.DMetric;
+            }
+        };
+
+        // Cost of the query and its path, nodes for a distance and trip steps for a time
+        struct SEntry{
+            double DCost;
+            std::vector< TNodeID > DNodes;
+            std::vector< TTripStep > DSteps;
+        };
+
+        // Holds at most capacity entries, rounded up to a multiple of the shard count. A capacity of
+        // zero stores nothing.
+        CPathCache(std::size_t capacity, std::size_t shards = 16);
+        ~CPathCache();
+
+        std::size_t Capacity() const noexcept;
+        std::size_t ShardCount() const noexcept;
+        std::size_t Size() const;
+        std::size_t Hits() const noexcept;
+        std::size_t Misses() const noexcept;
+
+        // Copies the entry of key and marks it most recently used, returns false on a miss
+        bool Find(const SKey &key, SEntry &entry);
+        // Stores or replaces the entry of key, evicting the shard's least recently used entry when full
+        void Insert(const SKey &key, SEntry entry);
+        // Drops every entry, the counters are kept
+        void Clear();
+        void ResetCounters() noexcept;
+};
+
+#endif
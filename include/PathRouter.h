@@ -2,9 +2,11 @@
 #define PATHROUTER_H
 
 #include <vector>
+#include <algorithm>
 #include <limits>
 #include <any>
 #include <chrono>
+#include <memory>
 
 class CPathRouter{
     public:
@@ -13,6 +15,12 @@ class CPathRouter{
         static constexpr TVertexID InvalidVertexID = std::numeric_limits<TVertexID>::max();
         static constexpr double NoPathExists = std::numeric_limits<double>::max();
 
+        // Scratch state for queries, created by the router that uses it. A query through a workspace
+        // does not modify the router, so threads that each own a workspace can share one router.
+        struct SQueryWorkspace{
+            virtual ~SQueryWorkspace(){};
+        };
+
         virtual ~CPathRouter(){};
 
         virtual std::size_t VertexCount() const noexcept = 0;
@@ -21,6 +29,61 @@ class CPathRouter{
         virtual bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept = 0;
         virtual bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept = 0;
         virtual double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept = 0;
+
+        // The queries below default to calls of FindShortestPath(src, dest, path), so a router only
+        // has to implement the methods above. Routers override them with faster searches.
+        virtual std::unique_ptr<SQueryWorkspace> CreateWorkspace() const{
+            return std::make_unique<SQueryWorkspace>();
+        }
+
+        // True if the workspace queries leave the router unchanged, so threads that each own a
+        // workspace can query it at once. The defaults below run the router's own query, which may
+        // modify it, so a router only returns true once it overrides them all.
+        virtual bool ConcurrentQueries() const noexcept{
+            return false;
+        }
+
+        virtual double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &) const noexcept{
+            return const_cast<CPathRouter *>(this)->FindShortestPath(src, dest, path);
+        }
+
+        // Distances from src to each of dests, NoPathExists where there is no path
+        virtual std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+            std::vector<double> Distances;
+            std::vector<TVertexID> Path;
+            for(auto Dest : dests){
+                Distances.push_back(FindShortestPath(src, Dest, Path, workspace));
+            }
+            return Distances;
+        }
+
+        // Row i holds the distances from sources[i] to each of dests
+        virtual std::vector< std::vector<double> > FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+            std::vector< std::vector<double> > Matrix;
+            for(auto Source : sources){
+                Matrix.push_back(FindDistances(Source, dests, workspace));
+            }
+            return Matrix;
+        }
+
+        // Vertices within budget of src paired with their distances, in order of distance
+        virtual std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+            std::vector< std::pair<TVertexID, double> > Vertices;
+            if(VertexCount() <= src){
+                return Vertices;
+            }
+            std::vector<TVertexID> Path;
+            for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+                auto Distance = FindShortestPath(src, VertexID, Path, workspace);
+                if((Distance != NoPathExists) && (Distance <= budget)){
+                    Vertices.push_back(std::make_pair(VertexID, Distance));
+                }
+            }
+            std::stable_sort(Vertices.begin(), Vertices.end(), [](const std::pair<TVertexID, double> &left, const std::pair<TVertexID, double> &right){
+                return left.second < right.second;
+            });
+            return Vertices;
+        }
 };
 
 #endif
@@ -0,0 +1,76 @@
+#ifndef RAPTORROUTER_H
+#define RAPTORROUTER_H
+
+#include <memory>
+#include <vector>
+#include <limits>
+#include <utility>
+
+// Round-based transit router (RAPTOR) over routes given as sequences of stops. The routes have no
+// timetable, a bus leaves a stop as soon as a rider has boarded, so each round scans every route
+// served by a stop improved in the previous round once, from the earliest stop it can be boarded
+// at. Round k finds the fastest arrival at every stop using at most k rides, with the foot path
+// transfers between stops walked after each ride. The router is immutable once built, so threads
+// that each own a workspace can query it concurrently.
+class CRaptorRouter{
+    public:
+        using TStopIndex = std::size_t;
+        using TRouteIndex = std::size_t;
+        static constexpr double NoPathExists = std::numeric_limits<double>::max();
+        static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+        // A route visits DStops in order, DRideTimes[i] is the time from DStops[i] to DStops[i + 1]
+        struct SRoute{
+            std::vector< TStopIndex > DStops;
+            std::vector< double > DRideTimes;
+        };
+
+        // A walk between two stops
+        struct STransfer{
+            TStopIndex DSource;
+            TStopIndex DDestination;
+            double DTime;
+        };
+
+        // A leg of a journey. Access walks from the origin to DDestination, a ride stays on DRoute
+        // from stop position DBoardIndex to DAlightIndex, a transfer walks between two stops and
+        // egress walks from DSource to the destination.
+        enum class ELegType {Access, Ride, Transfer, Egress};
+        struct SLeg{
+            ELegType DType;
+            TStopIndex DSource;
+            TStopIndex DDestination;
+            TRouteIndex DRoute;
+            std::size_t DBoardIndex;
+            std::size_t DAlightIndex;
+        };
+
+        // Caller owned scratch state of a query
+        struct SQueryWorkspace{
+            virtual ~SQueryWorkspace(){};
+        };
+
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // Boarding and alighting each take their time on top of the ride times
+        CRaptorRouter(std::size_t stopcount, const std::vector< SRoute > &routes, const std::vector< STransfer > &transfers, double boardtime, double alighttime);
+        ~CRaptorRouter();
+
+        std::size_t StopCount() const noexcept;
+        std::size_t RouteCount() const noexcept;
+        std::size_t TransferCount() const noexcept;
+        // Stop at position index of route, InvalidIndex if either is out of range
+        TStopIndex RouteStop(TRouteIndex route, std::size_t index) const noexcept;
+
+        std::unique_ptr< SQueryWorkspace > CreateWorkspace() const;
+        // Fastest journey with at least one and at most maxrounds rides from the origin to the
+        // destination. access holds the stops reachable from the origin with the time to reach them,
+        // egress the stops the destination is reachable from with the time from them. Returns the
+        // journey time and fills legs, or NoPathExists.
+        double FindFastestJourney(const std::vector< std::pair< TStopIndex, double > > &access, const std::vector< std::pair< TStopIndex, double > > &egress, std::size_t maxrounds, std::vector< SLeg > &legs, SQueryWorkspace &workspace) const;
+};
+
+#endif
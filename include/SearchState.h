@@ -0,0 +1,136 @@
+#ifndef SEARCHSTATE_H
+#define SEARCHSTATE_H
+
+#include "PathRouter.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Per-vertex state of one shortest path search, meant to be kept in a query workspace and reused.
+// Each entry is stamped with the generation of the query that wrote it, so Reset only advances the
+// generation and clears the queued keys instead of refilling arrays the size of the graph.
+template <typename TQueue>
+class CSearchState{
+    private:
+        using TVertexID = CPathRouter::TVertexID;
+
+        TQueue DQueue;
+        std::vector< double > DDistances;
+        std::vector< TVertexID > DPrevious;
+        std::vector< uint32_t > DGenerations;
+        uint32_t DGeneration = 0;
+
+    public:
+        // Starts a new search over vertexcount vertices, every vertex reads as unreached.
+        void Reset(std::size_t vertexcount){
+            if(DGenerations.size() < vertexcount){
+                DDistances.resize(vertexcount);
+                DPrevious.resize(vertexcount);
+                DGenerations.resize(vertexcount, 0);
+                DQueue.Reserve(vertexcount);
+            }
+            DQueue.Clear();
+            DGeneration++;
+            if(!DGeneration){
+                // The stamps wrapped around, old entries could look current
+                std::fill(DGenerations.begin(), DGenerations.end(), 0);
+                DGeneration = 1;
+            }
+        }
+
+        TQueue &Queue() noexcept{
+            return DQueue;
+        }
+
+        bool Reached(TVertexID vertex) const noexcept{
+            return DGenerations[vertex] == DGeneration;
+        }
+
+        double Distance(TVertexID vertex) const noexcept{
+            return Reached(vertex) ? DDistances[vertex] : CPathRouter::NoPathExists;
+        }
+
+        TVertexID Previous(TVertexID vertex) const noexcept{
+            return Reached(vertex) ? DPrevious[vertex] : CPathRouter::InvalidVertexID;
+        }
+
+        void Update(TVertexID vertex, double distance, TVertexID previous) noexcept{
+            DGenerations[vertex] = DGeneration;
+            DDistances[vertex] = distance;
+            DPrevious[vertex] = previous;
+        }
+};
+
+// Dijkstra search from src that stops once every vertex of targets has been settled, following the
+// edges given by adjacency(vertex, function(target, weight)). Returns the distances in the order of
+// targets, NoPathExists for targets that are unreachable or out of range.
+template <typename TQueue, typename TAdjacency>
+std::vector< double > FindTargetDistances(CSearchState<TQueue> &search, std::size_t vertexcount, CPathRouter::TVertexID src, const std::vector< CPathRouter::TVertexID > &targets, TAdjacency adjacency){
+    std::vector< double > Distances(targets.size(), CPathRouter::NoPathExists);
+    if(src >= vertexcount){
+        return Distances;
+    }
+    // Targets still to be settled, sorted so each settled vertex can be looked up
+    std::vector< CPathRouter::TVertexID > Remaining;
+    for(auto Target : targets){
+        if(Target < vertexcount){
+            Remaining.push_back(Target);
+        }
+    }
+    std::sort(Remaining.begin(), Remaining.end());
+    Remaining.erase(std::unique(Remaining.begin(), Remaining.end()), Remaining.end());
+    std::size_t RemainingCount = Remaining.size();
+    search.Reset(vertexcount);
+    search.Update(src, 0.0, CPathRouter::InvalidVertexID);
+    search.Queue().Push(src, 0.0);
+    while(RemainingCount && !search.Queue().Empty()){
+        auto CurrentID = search.Queue().Pop();
+        if(std::binary_search(Remaining.begin(), Remaining.end(), CurrentID)){
+            RemainingCount--;
+        }
+        auto CurrentDistance = search.Distance(CurrentID);
+        adjacency(CurrentID, [&](CPathRouter::TVertexID DestID, double EdgeWeight){
+            auto TotalDistance = CurrentDistance + EdgeWeight;
+            if(TotalDistance < search.Distance(DestID)){
+                search.Update(DestID, TotalDistance, CurrentID);
+                search.Queue().Push(DestID, TotalDistance);
+            }
+        });
+    }
+    for(std::size_t Index = 0; Index < targets.size(); Index++){
+        if(targets[Index] < vertexcount){
+            Distances[Index] = search.Distance(targets[Index]);
+        }
+    }
+    return Distances;
+}
+
+// Dijkstra search from src that settles every vertex within budget of it, following the edges given
+// by adjacency(vertex, function(target, weight)). Returns the settled vertices with their distances
+// in order of distance, or nothing if src is out of range.
+template <typename TQueue, typename TAdjacency>
+std::vector< std::pair< CPathRouter::TVertexID, double > > FindVerticesWithin(CSearchState<TQueue> &search, std::size_t vertexcount, CPathRouter::TVertexID src, double budget, TAdjacency adjacency){
+    std::vector< std::pair< CPathRouter::TVertexID, double > > Settled;
+    if((src >= vertexcount)||(budget < 0.0)){
+        return Settled;
+    }
+    search.Reset(vertexcount);
+    search.Update(src, 0.0, CPathRouter::InvalidVertexID);
+    search.Queue().Push(src, 0.0);
+    while(!search.Queue().Empty()){
+        auto CurrentID = search.Queue().Pop();
+        auto CurrentDistance = search.Distance(CurrentID);
+        Settled.push_back(std::make_pair(CurrentID, CurrentDistance));
+        adjacency(CurrentID, [&](CPathRouter::TVertexID DestID, double EdgeWeight){
+            auto TotalDistance = CurrentDistance + EdgeWeight;
+            // Vertices past the budget are never queued, so the search ends at the budget
+            if((TotalDistance <= budget)&&(TotalDistance < search.Distance(DestID))){
+                search.Update(DestID, TotalDistance, CurrentID);
+                search.Queue().Push(DestID, TotalDistance);
+            }
+        });
+    }
+    return Settled;
+}
+
+#endif
@@ -8,6 +8,7 @@ class CStandardDataSink : public CDataSink{
     public:
         bool Put(const char &ch) noexcept override;
         bool Write(const std::vector<char> &buf) noexcept override;
+        bool Flush() noexcept override;
 };
 
 #endif
@@ -5,11 +5,16 @@
 
 class CStandardDataSource : public CDataSource{
     private:
+        // Line taken from std::cin by Chunk, the unread bytes are [DIndex, DBuffer.size())
+        std::vector<char> DBuffer;
+        std::size_t DIndex = 0;
     public:
         bool End() const noexcept override;
         bool Get(char &ch) noexcept override;
         bool Peek(char &ch) noexcept override;
         bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+        std::pair< const char *, std::size_t > Chunk() noexcept override;
+        void Advance(std::size_t count) noexcept override;
 };
 
 #endif
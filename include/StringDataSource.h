@@ -15,6 +15,10 @@ class CStringDataSource : public CDataSource{
         bool Get(char &ch) noexcept override;
         bool Peek(char &ch) noexcept override;
         bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+        std::pair< const char *, std::size_t > Chunk() noexcept override;
+        void Advance(std::size_t count) noexcept override;
+        // Chunks point into the string, which is never changed
+        bool StableChunks() const noexcept override;
 };
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <functional>
+#include <memory>
+
+// Fixed set of worker threads that run index ranges split into chunks. Each worker takes chunks
+// from the back of its own queue and steals from the front of the others once its queue is empty.
+class CThreadPool{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        // Called with an index and the worker running it, worker is in [0, ThreadCount())
+        using TTask = std::function< void(std::size_t index, std::size_t worker) >;
+
+        // Zero threads uses one per hardware thread
+        CThreadPool(std::size_t threads = 0);
+        ~CThreadPool();
+
+        std::size_t ThreadCount() const noexcept;
+        // Runs task for every index in [0, count) and returns once all have finished. The first
+        // exception thrown by a task is rethrown here after the remaining work completes.
+        void ParallelFor(std::size_t count, const TTask &task);
+};
+
+#endif
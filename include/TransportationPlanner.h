@@ -22,6 +22,12 @@ class CTransportationPlanner{
             virtual int PrecomputeTime() const noexcept = 0;
         };
 
+        // Caller owned scratch state for the const queries. Queries through a context do not modify
+        // the planner, so threads that each own a context can share one planner.
+        struct SQueryContext{
+            virtual ~SQueryContext(){};
+        };
+
         virtual ~CTransportationPlanner(){};
 
         virtual std::size_t NodeCount() const noexcept = 0;
@@ -29,6 +35,9 @@ class CTransportationPlanner{
 
         virtual double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path) = 0;
         virtual double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path) = 0;
+        virtual std::unique_ptr<SQueryContext> CreateQueryContext() const = 0;
+        virtual double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path, SQueryContext &context) const = 0;
+        virtual double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path, SQueryContext &context) const = 0;
         virtual bool GetPathDescription(const std::vector< TTripStep > &path, std::vector< std::string > &desc) const = 0;
 };
 
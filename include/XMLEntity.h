@@ -1,8 +1,11 @@
 #ifndef XMLENTITY_H
 #define XMLENTITY_H
 
+#include <cstdint>
+#include <limits>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <vector>
 
 struct SXMLEntity{
@@ -44,5 +47,44 @@ struct SXMLEntity{
         return true;
     };
 };
-   
+
+// Entity read in place by CXMLReader. Element and attribute names are interned by the reader, so
+// attributes are looked up by comparing IDs. The views are valid until the reader's next read.
+// Attribute values, and the empty value of a missing attribute, are followed by a null so they can be
+// passed to C conversions such as strtod.
+struct SXMLEntityView{
+    using TNameID = uint32_t;
+    static constexpr TNameID InvalidNameID = std::numeric_limits<TNameID>::max();
+    struct SAttribute{
+        TNameID DNameID;
+        std::string_view DName;
+        std::string_view DValue;
+    };
+    SXMLEntity::EType DType;
+    // Name of an element, InvalidNameID for character data
+    TNameID DNameID = InvalidNameID;
+    // Name of an element or the character data
+    std::string_view DNameData;
+    const SAttribute *DAttributes = nullptr;
+    std::size_t DAttributeCount = 0;
+
+    bool AttributeExists(TNameID name) const{
+        for(std::size_t Index = 0; Index < DAttributeCount; Index++){
+            if(DAttributes[Index].DNameID == name){
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::string_view AttributeValue(TNameID name) const{
+        for(std::size_t Index = 0; Index < DAttributeCount; Index++){
+            if(DAttributes[Index].DNameID == name){
+                return DAttributes[Index].DValue;
+            }
+        }
+        return std::string_view("");
+    };
+};
+
 #endif
@@ -0,0 +1,79 @@
+#ifndef XMLPARSEFEEDER_H
+#define XMLPARSEFEEDER_H
+
+#include "XMLReader.h"
+#include <expat.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Feeds a data source to an expat parser. Each Feed copies the source's chunks into the buffer from
+// XML_GetBuffer and parses it with XML_ParseBuffer. The bytes fed start at CXMLReader::MinChunkSize
+// and double after each full chunk up to the chunk size. The bytes, chunks, suspensions and time
+// spent are counted in the statistics.
+class CXMLParseFeeder{
+    private:
+        std::shared_ptr<CDataSource> DSource;
+        std::size_t DChunkSize;
+        std::size_t DNextChunkSize = CXMLReader::MinChunkSize;
+        bool DEndOfData = false;
+        CXMLReader::SParseStatistics DStatistics;
+
+        XML_Status Count(XML_Status status, std::chrono::steady_clock::time_point start){
+            DStatistics.DSuspendCount += status == XML_STATUS_SUSPENDED ? 1 : 0;
+            DStatistics.DParseSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return status;
+        }
+
+    public:
+        // chunksize is clamped to [MinChunkSize, MaxChunkSize] of CXMLReader
+        CXMLParseFeeder(std::shared_ptr<CDataSource> src, std::size_t chunksize)
+        : DSource(src), DChunkSize(std::clamp(chunksize, CXMLReader::MinChunkSize, CXMLReader::MaxChunkSize)){
+
+        }
+
+        // True once the last chunk, which expat was told is final, has been fed
+        bool EndOfData() const noexcept{
+            return DEndOfData;
+        }
+
+        const CXMLReader::SParseStatistics &Statistics() const noexcept{
+            return DStatistics;
+        }
+
+        // Copies and parses the next chunk of the source, the source is empty once EndOfData is true
+        XML_Status Feed(XML_Parser parser){
+            auto ParseStart = std::chrono::steady_clock::now();
+            auto Buffer = static_cast<char *>(XML_GetBuffer(parser, DNextChunkSize));
+            if(!Buffer){
+                DEndOfData = true;
+                return XML_STATUS_ERROR;
+            }
+            std::size_t Length = 0;
+            while(Length < DNextChunkSize){
+                auto Chunk = DSource->Chunk();
+                if(!Chunk.second){
+                    break;
+                }
+                auto Count = std::min(Chunk.second, DNextChunkSize - Length);
+                std::memcpy(Buffer + Length, Chunk.first, Count);
+                DSource->Advance(Count);
+                Length += Count;
+            }
+            DEndOfData = !Length || DSource->End(); // No more data to read, call XML_ParseBuffer with isFinal = true
+            if(Length == DNextChunkSize){
+                DNextChunkSize = std::min(DNextChunkSize * 2, DChunkSize);
+            }
+            DStatistics.DBytesParsed += Length;
+            DStatistics.DChunkCount++;
+            return Count(XML_ParseBuffer(parser, Length, DEndOfData), ParseStart);
+        }
+
+        // Resumes a parser stopped with XML_StopParser, parsing the rest of the last chunk
+        XML_Status Resume(XML_Parser parser){
+            auto ParseStart = std::chrono::steady_clock::now();
+            return Count(XML_ResumeParser(parser), ParseStart);
+        }
+};
+
+#endif
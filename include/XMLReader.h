@@ -11,11 +11,41 @@ class CXMLReader{
         std::unique_ptr<SImplementation> DImplementation;
         
     public:
-        CXMLReader(std::shared_ptr< CDataSource > src);
+        // Bounds of the bytes handed to expat at a time. Parsing starts with MinChunkSize and doubles
+        // it after each full chunk up to the reader's chunk size.
+        static constexpr std::size_t MinChunkSize = 64 * 1024;
+        static constexpr std::size_t MaxChunkSize = 1024 * 1024;
+        static constexpr std::size_t DefaultChunkSize = 256 * 1024;
+        // Entities parsed ahead of the reads, parsing is suspended when this many are waiting. The end
+        // of an empty element is reported with its start, so one more entity may be queued.
+        static constexpr std::size_t DefaultMaxQueuedEntities = 4096;
+
+        struct SParseStatistics{
+            std::size_t DBytesParsed = 0;
+            std::size_t DChunkCount = 0;
+            std::size_t DSuspendCount = 0;
+            std::size_t DPeakQueuedEntities = 0;
+            // Time spent copying chunks into expat and parsing them
+            double DParseSeconds = 0.0;
+
+            double BytesPerSecond() const noexcept{
+                return 0.0 < DParseSeconds ? DBytesParsed / DParseSeconds : 0.0;
+            }
+        };
+
+        // chunksize is clamped to [MinChunkSize, MaxChunkSize], and maxqueued is at least one
+        CXMLReader(std::shared_ptr< CDataSource > src, std::size_t chunksize = DefaultChunkSize, std::size_t maxqueued = DefaultMaxQueuedEntities);
         ~CXMLReader();
         
+        using TNameID = SXMLEntityView::TNameID;
+
         bool End() const;
+        SParseStatistics ParseStatistics() const;
         bool ReadEntity(SXMLEntity &entity, bool skipcdata = false);
+        // ID the entity views use for name, the same name always has the same ID
+        TNameID Intern(const std::string &name);
+        // Reads the next entity without copying it, its views are valid until the next read
+        bool ReadEntity(SXMLEntityView &entity, bool skipcdata = false);
 };
 
 #endif
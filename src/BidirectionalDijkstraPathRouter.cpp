@@ -0,0 +1,348 @@
+#include "BidirectionalDijkstraPathRouter.h"
+#include "IndexedPriorityQueue.h"
+#include "SearchState.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+struct CBidirectionalDijkstraPathRouter::SImplementation{
+    // Defines an edge in the graph as a pair of a double (the weight of the edge) and a TVertexID (the destination vertex).
+    using TEdge = std::pair<double, TVertexID>;
+    using TCompactIndex = uint32_t;
+    using TQueue = CIndexedPriorityQueue<4>;
+
+    // Compressed sparse row adjacency, the edges of vertex v are the entries [DOffsets[v], DOffsets[v+1])
+    struct SAdjacency{
+        std::vector< TCompactIndex > DOffsets;
+        std::vector< TCompactIndex > DTargets;
+        std::vector< double > DWeights;
+    };
+
+    using TSearch = CSearchState<TQueue>;
+
+    // Scratch state of a query, one search state per direction
+    struct SWorkspace : public SQueryWorkspace{
+        TSearch DForward;
+        TSearch DBackward;
+    };
+
+    // The workspace as created by this router, another router's workspace is a caller error
+    static SWorkspace &OwnWorkspace(SQueryWorkspace &workspace){
+        auto Workspace = dynamic_cast< SWorkspace * >(&workspace);
+        if(!Workspace){
+            throw std::invalid_argument("CBidirectionalDijkstraPathRouter: workspace was created by another router");
+        }
+        return *Workspace;
+    }
+
+    std::vector< std::any > DVertexTags;
+    std::vector< std::vector< TEdge > > DVertexEdges;
+
+    // Forward adjacency and the reverse adjacency (edges into each vertex) built by Precompute
+    bool DFrozen = false;
+    SAdjacency DForward;
+    SAdjacency DBackward;
+
+    // Workspace used by the non-const FindShortestPath
+    std::unique_ptr< SQueryWorkspace > DWorkspace;
+
+    std::size_t VertexCount() const noexcept{
+        return DVertexTags.size();
+    }
+
+    TVertexID AddVertex(std::any tag) noexcept{
+        Thaw();
+        TVertexID NewVertexID = DVertexTags.size();
+        DVertexTags.push_back(tag);
+        DVertexEdges.emplace_back();
+        return NewVertexID;
+    }
+
+    std::any GetVertexTag(TVertexID id) const noexcept{
+        if(id < DVertexTags.size()){
+            return DVertexTags[id];
+        }
+        return std::any();
+    }
+
+    bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept{
+        if((src < VertexCount())&&(dest < VertexCount())&&(0.0 <= weight)){
+            Thaw();
+            DVertexEdges[src].push_back(std::make_pair(weight,dest));
+            if(bidir){
+                DVertexEdges[dest].push_back(std::make_pair(weight, src));
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Builds the forward and reverse compressed sparse row arrays and releases the edge lists. The
+    // arrays are built in one linear pass, so there is no deadline to check.
+    bool Precompute(std::chrono::steady_clock::time_point) noexcept{
+        if(DFrozen){
+            return true;
+        }
+        std::size_t EdgeCount = 0;
+        for(auto &Edges : DVertexEdges){
+            EdgeCount += Edges.size();
+        }
+        if((std::numeric_limits<TCompactIndex>::max() <= VertexCount())||(std::numeric_limits<TCompactIndex>::max() <= EdgeCount)){
+            return false;
+        }
+        DForward.DOffsets.assign(1, 0);
+        DForward.DTargets.reserve(EdgeCount);
+        DForward.DWeights.reserve(EdgeCount);
+        DBackward.DOffsets.assign(VertexCount() + 1, 0);
+        for(auto &Edges : DVertexEdges){
+            for(auto &Edge : Edges){
+                DForward.DTargets.push_back(Edge.second);
+                DForward.DWeights.push_back(Edge.first);
+                DBackward.DOffsets[Edge.second + 1]++;
+            }
+            DForward.DOffsets.push_back(DForward.DTargets.size());
+        }
+        for(std::size_t Index = 1; Index < DBackward.DOffsets.size(); Index++){
+            DBackward.DOffsets[Index] += DBackward.DOffsets[Index - 1];
+        }
+        DBackward.DTargets.resize(EdgeCount);
+        DBackward.DWeights.resize(EdgeCount);
+        std::vector< TCompactIndex > NextSlot(DBackward.DOffsets.begin(), DBackward.DOffsets.end() - 1);
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            for(auto &Edge : DVertexEdges[VertexID]){
+                auto Slot = NextSlot[Edge.second]++;
+                DBackward.DTargets[Slot] = VertexID;
+                DBackward.DWeights[Slot] = Edge.first;
+            }
+        }
+        std::vector< std::vector< TEdge > >().swap(DVertexEdges);
+        DFrozen = true;
+        return true;
+    }
+
+    // Expands the forward arrays back into edge lists and drops the reverse arrays so the graph can be modified.
+    void Thaw(){
+        if(!DFrozen){
+            return;
+        }
+        DVertexEdges.resize(VertexCount());
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            for(auto Index = DForward.DOffsets[VertexID]; Index < DForward.DOffsets[VertexID+1]; Index++){
+                DVertexEdges[VertexID].push_back(std::make_pair(DForward.DWeights[Index], TVertexID(DForward.DTargets[Index])));
+            }
+        }
+        DForward = SAdjacency();
+        DBackward = SAdjacency();
+        DFrozen = false;
+    }
+
+    std::unique_ptr< SQueryWorkspace > CreateWorkspace() const{
+        return std::make_unique< SWorkspace >();
+    }
+
+    // Settles the closest vertex of search, relaxing its edges in adjacency and recording the best
+    // meeting point with the opposite search.
+    void Step(TSearch &search, const SAdjacency &adjacency, const TSearch &opposite, double &best, TVertexID &meeting) const{
+        auto CurrentID = search.Queue().Pop();
+        auto CurrentDistance = search.Distance(CurrentID);
+        auto End = adjacency.DOffsets[CurrentID+1];
+        for(auto Index = adjacency.DOffsets[CurrentID]; Index < End; Index++){
+            TVertexID DestID = adjacency.DTargets[Index];
+            auto TotalDistance = CurrentDistance + adjacency.DWeights[Index];
+            if(TotalDistance < search.Distance(DestID)){
+                search.Update(DestID, TotalDistance, CurrentID);
+                search.Queue().Push(DestID, TotalDistance);
+            }
+            auto OppositeDistance = opposite.Distance(DestID);
+            if((NoPathExists != OppositeDistance)&&(TotalDistance + OppositeDistance < best)){
+                best = TotalDistance + OppositeDistance;
+                meeting = DestID;
+            }
+        }
+    }
+
+    // Freezes the graph if needed so the query can use the reverse adjacency.
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
+        if(!DFrozen){
+            Precompute(std::chrono::steady_clock::time_point::max());
+        }
+        if(!DWorkspace){
+            DWorkspace = CreateWorkspace();
+        }
+        return FindShortestPath(src, dest, path, *DWorkspace);
+    }
+
+    // Runs forward searches from src and backward searches from dest alternately until the sum of
+    // their smallest tentative distances can no longer improve on the best meeting point found.
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+        if((src >= VertexCount())||(dest >= VertexCount())){
+            return NoPathExists;
+        }
+        auto &Workspace = OwnWorkspace(workspace);
+        auto &Forward = Workspace.DForward;
+        auto &Backward = Workspace.DBackward;
+        Forward.Reset(VertexCount());
+        Backward.Reset(VertexCount());
+        if(!DFrozen){
+            return FindUnidirectional(src, dest, path, Forward);
+        }
+        double Best = src == dest ? 0.0 : NoPathExists;
+        TVertexID Meeting = src == dest ? src : InvalidVertexID;
+
+        Forward.Update(src, 0.0, InvalidVertexID);
+        Forward.Queue().Push(src, 0.0);
+        Backward.Update(dest, 0.0, InvalidVertexID);
+        Backward.Queue().Push(dest, 0.0);
+        bool ForwardTurn = true;
+        while(!Forward.Queue().Empty() && !Backward.Queue().Empty()){
+            if(Forward.Queue().TopPriority() + Backward.Queue().TopPriority() >= Best){
+                break;
+            }
+            if(ForwardTurn){
+                Step(Forward, DForward, Backward, Best, Meeting);
+            }
+            else{
+                Step(Backward, DBackward, Forward, Best, Meeting);
+            }
+            ForwardTurn = !ForwardTurn;
+        }
+        if(NoPathExists == Best){
+            return NoPathExists;
+        }
+        path.clear();
+        for(auto VertexID = Meeting; VertexID != InvalidVertexID; VertexID = Forward.Previous(VertexID)){
+            path.push_back(VertexID);
+        }
+        std::reverse(path.begin(), path.end());
+        for(auto VertexID = Backward.Previous(Meeting); VertexID != InvalidVertexID; VertexID = Backward.Previous(VertexID)){
+            path.push_back(VertexID);
+        }
+        return Best;
+    }
+
+    // Plain Dijkstra over the edge lists, used while the graph is not frozen and has no reverse adjacency.
+    double FindUnidirectional(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, TSearch &search) const{
+        search.Update(src, 0.0, InvalidVertexID);
+        search.Queue().Push(src, 0.0);
+        while(!search.Queue().Empty()){
+            auto CurrentID = search.Queue().Pop();
+            if(CurrentID == dest){
+                break;
+            }
+            for(auto &Edge : DVertexEdges[CurrentID]){
+                auto TotalDistance = search.Distance(CurrentID) + Edge.first;
+                if(TotalDistance < search.Distance(Edge.second)){
+                    search.Update(Edge.second, TotalDistance, CurrentID);
+                    search.Queue().Push(Edge.second, TotalDistance);
+                }
+            }
+        }
+        if(NoPathExists == search.Distance(dest)){
+            return NoPathExists;
+        }
+        path.clear();
+        for(auto VertexID = dest; VertexID != InvalidVertexID; VertexID = search.Previous(VertexID)){
+            path.push_back(VertexID);
+        }
+        std::reverse(path.begin(), path.end());
+        return search.Distance(dest);
+    }
+
+    // Calls function(target, weight) for each outgoing edge of the vertex, frozen or not.
+    template <typename TFunction>
+    void ForEachEdge(TVertexID id, TFunction function) const{
+        if(DFrozen){
+            auto End = DForward.DOffsets[id+1];
+            for(auto Index = DForward.DOffsets[id]; Index < End; Index++){
+                function(TVertexID(DForward.DTargets[Index]), DForward.DWeights[Index]);
+            }
+        }
+        else{
+            for(auto &Edge : DVertexEdges[id]){
+                function(Edge.second, Edge.first);
+            }
+        }
+    }
+
+    // A single destination gains nothing from a backward search, so one-to-many queries run a
+    // forward search that stops once every destination is settled.
+    std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        auto &Workspace = OwnWorkspace(workspace);
+        return FindTargetDistances(Workspace.DForward, VertexCount(), src, dests, [this](TVertexID id, auto function){
+            ForEachEdge(id, function);
+        });
+    }
+
+    std::vector< std::vector<double> > FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        std::vector< std::vector<double> > Matrix;
+        for(auto Source : sources){
+            Matrix.push_back(FindDistances(Source, dests, workspace));
+        }
+        return Matrix;
+    }
+
+    std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+        auto &Workspace = OwnWorkspace(workspace);
+        return ::FindVerticesWithin(Workspace.DForward, VertexCount(), src, budget, [this](TVertexID id, auto function){
+            ForEachEdge(id, function);
+        });
+    }
+};
+
+CBidirectionalDijkstraPathRouter::CBidirectionalDijkstraPathRouter(){
+    DImplementation = std::make_unique<SImplementation>();
+}
+
+CBidirectionalDijkstraPathRouter::~CBidirectionalDijkstraPathRouter(){
+
+}
+
+std::size_t CBidirectionalDijkstraPathRouter::VertexCount() const noexcept{
+    return DImplementation->VertexCount();
+}
+
+CPathRouter::TVertexID CBidirectionalDijkstraPathRouter::AddVertex(std::any tag) noexcept{
+    return DImplementation->AddVertex(tag);
+}
+
+std::any CBidirectionalDijkstraPathRouter::GetVertexTag(TVertexID id) const noexcept{
+    return DImplementation->GetVertexTag(id);
+}
+
+bool CBidirectionalDijkstraPathRouter::AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir) noexcept{
+    return DImplementation->AddEdge(src,dest,weight,bidir);
+}
+
+bool CBidirectionalDijkstraPathRouter::Precompute(std::chrono::steady_clock::time_point deadline) noexcept{
+    return DImplementation->Precompute(deadline);
+}
+
+double CBidirectionalDijkstraPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
+    return DImplementation->FindShortestPath(src,dest,path);
+}
+
+std::unique_ptr<CPathRouter::SQueryWorkspace> CBidirectionalDijkstraPathRouter::CreateWorkspace() const{
+    return DImplementation->CreateWorkspace();
+}
+
+bool CBidirectionalDijkstraPathRouter::ConcurrentQueries() const noexcept{
+    return true;
+}
+
+double CBidirectionalDijkstraPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindShortestPath(src,dest,path,workspace);
+}
+
+
+std::vector<double> CBidirectionalDijkstraPathRouter::FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindDistances(src,dests,workspace);
+}
+
+std::vector< std::vector<double> > CBidirectionalDijkstraPathRouter::FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindDistanceMatrix(sources,dests,workspace);
+}
+
+std::vector< std::pair<CPathRouter::TVertexID, double> > CBidirectionalDijkstraPathRouter::FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindVerticesWithin(src,budget,workspace);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "BufferedDataSink.h"
+#include <cstring>
+
+CBufferedDataSink::CBufferedDataSink(std::shared_ptr<CDataSink> sink, std::size_t buffersize) : DSink(sink), DBuffer(buffersize), DBufferSize(buffersize){
+
+}
+
+CBufferedDataSink::~CBufferedDataSink(){
+    Flush();
+}
+
+bool CBufferedDataSink::Drain() noexcept{
+    if(!DLength){
+        return true;
+    }
+    bool Success;
+    if(DLength == DBufferSize){
+        // A full buffer is passed on as it is
+        Success = DSink->Write(DBuffer);
+    }
+    else{
+        // Only Flush and large writes drain a partial buffer, its bytes are copied to a vector of their length
+        DPartial.assign(DBuffer.begin(), DBuffer.begin() + DLength);
+        Success = DSink->Write(DPartial);
+    }
+    DLength = 0;
+    return Success;
+}
+
+std::size_t CBufferedDataSink::BufferSize() const noexcept{
+    return DBufferSize;
+}
+
+bool CBufferedDataSink::Put(const char &ch) noexcept{
+    if(!DBufferSize){
+        return DSink->Put(ch);
+    }
+    DBuffer[DLength++] = ch;
+    if(DLength == DBufferSize){
+        return Drain();
+    }
+    return true;
+}
+
+bool CBufferedDataSink::Write(const std::vector<char> &buf) noexcept{
+    if(buf.size() >= DBufferSize){
+        bool Success = Drain();
+        return DSink->Write(buf) && Success;
+    }
+    if(DLength + buf.size() > DBufferSize){
+        // Passes on the full buffer so the write fits in the emptied one
+        std::size_t Count = DBufferSize - DLength;
+        std::memcpy(DBuffer.data() + DLength, buf.data(), Count);
+        DLength = DBufferSize;
+        bool Success = Drain();
+        std::memcpy(DBuffer.data(), buf.data() + Count, buf.size() - Count);
+        DLength = buf.size() - Count;
+        return Success;
+    }
+    if(!buf.empty()){
+        std::memcpy(DBuffer.data() + DLength, buf.data(), buf.size());
+        DLength += buf.size();
+    }
+    if(DLength == DBufferSize){
+        return Drain();
+    }
+    return true;
+}
+
+bool CBufferedDataSink::Flush() noexcept{
+    bool Success = Drain();
+    return DSink->Flush() && Success;
+}
@@ -1,6 +1,8 @@
 #include "CSVBusSystem.h"
 #include <vector>
 #include <unordered_map>
+#include <sstream>
+#include <algorithm>
 
 // Implementation structure defined within CCSVBusSystem to encapsulate details
 struct CCSVBusSystem::SImplementation {
@@ -56,13 +58,62 @@ struct CCSVBusSystem::SImplementation {
         }
     };
 
+    struct SPath : public CCSVBusSystem::SPath{
+        std::vector<CStreetMap::TNodeID> NodeIDs;
+
+        CStreetMap::TNodeID StartNodeID() const noexcept override{
+            return NodeIDs.front();
+        }
+
+        CStreetMap::TNodeID EndNodeID() const noexcept override{
+            return NodeIDs.back();
+        }
+
+        std::size_t NodeCount() const noexcept override{
+            return NodeIDs.size();
+        }
+
+        CStreetMap::TNodeID GetNodeID(std::size_t index) const noexcept override{
+            if (index < NodeIDs.size()) {
+                return NodeIDs[index];
+            }
+            return CStreetMap::InvalidNodeID;
+        }
+    };
+
     // Maps and vectors to store stops and routes
     std::unordered_map<TStopID, std::shared_ptr<SStop>> StopsByID;
     std::vector<std::shared_ptr<SStop>> StopsByIndex;
     std::unordered_map<std::string, std::shared_ptr<SRoute>> RoutesByName; // Assuming route names are unique
     std::vector<std::shared_ptr<SRoute>> RoutesByIndex;
+    std::vector<std::shared_ptr<SPath>> PathsByIndex;
+
+    // Parses the bus paths, a header naming the path column followed by rows whose path is a comma
+    // separated list of at least two node IDs
+    void ParsePaths(std::shared_ptr<CDSVReader> pathsrc) {
+        const std::string PathHeading = "path";
+        std::vector<std::string> PathRow;
+        if (!pathsrc->ReadRow(PathRow)) {
+            return;
+        }
+        std::size_t PathIndex = std::find(PathRow.begin(), PathRow.end(), PathHeading) - PathRow.begin();
+        while (pathsrc->ReadRow(PathRow)) {
+            if (PathIndex >= PathRow.size()) {
+                continue;
+            }
+            auto Path = std::make_shared<SPath>();
+            std::stringstream PathStream(PathRow[PathIndex]);
+            std::string NodeIDString;
+            while (std::getline(PathStream, NodeIDString, ',')) {
+                Path->NodeIDs.push_back(std::stoull(NodeIDString));
+            }
+            if (Path->NodeIDs.size() >= 2) {
+                PathsByIndex.push_back(Path);
+            }
+        }
+    }
 
-    SImplementation(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc) {
+    SImplementation(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc, std::shared_ptr<CDSVReader> pathsrc) {
     std::vector<std::string> stopRow;
     bool isFirstRowStops = true; // To skip the header for stops
     
@@ -125,6 +176,10 @@ for (const auto& routePair : routeStopsTemp) {
     RoutesByIndex.push_back(route);
 }
 
+if (pathsrc) {
+    ParsePaths(pathsrc);
+}
+
 }
 
 
@@ -168,11 +223,22 @@ for (const auto& routePair : routeStopsTemp) {
         }
         return nullptr;
     }
+
+    std::size_t PathCount() const noexcept{
+        return PathsByIndex.size();
+    }
+
+    std::shared_ptr<SPath> PathByIndex(std::size_t index) const noexcept{
+        if(index < PathsByIndex.size()){
+            return PathsByIndex[index];
+        }
+        return nullptr;
+    }
 };
 
 // Constructor for the CCSVBusSystem
-CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc)
-: DImplementation(std::make_unique<SImplementation>(stopsrc, routesrc)) {}
+CCSVBusSystem::CCSVBusSystem(std::shared_ptr<CDSVReader> stopsrc, std::shared_ptr<CDSVReader> routesrc, std::shared_ptr<CDSVReader> pathsrc)
+: DImplementation(std::make_unique<SImplementation>(stopsrc, routesrc, pathsrc)) {}
 
 // Destructor
 CCSVBusSystem::~CCSVBusSystem(){};
@@ -206,3 +272,13 @@ std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByIndex(std::size_t inde
 std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByName(const std::string &name) const noexcept {
     return DImplementation->RouteByName(name);
 }
+
+// Returns the number of bus paths
+std::size_t CCSVBusSystem::PathCount() const noexcept {
+    return DImplementation->PathCount();
+}
+
+// Returns the bus path specified by the index
+std::shared_ptr<CBusSystem::SPath> CCSVBusSystem::PathByIndex(std::size_t index) const noexcept {
+    return DImplementation->PathByIndex(index);
+}
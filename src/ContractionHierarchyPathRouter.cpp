@@ -0,0 +1,651 @@
+#include "ContractionHierarchyPathRouter.h"
+#include "IndexedPriorityQueue.h"
+#include "SearchState.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+struct CContractionHierarchyPathRouter::SImplementation{
+    // Defines an edge in the graph as a pair of a double (the weight of the edge) and a TVertexID (the destination vertex).
+    using TEdge = std::pair<double, TVertexID>;
+    using TCompactIndex = uint32_t;
+    using TQueue = CIndexedPriorityQueue<4>;
+
+    static constexpr TCompactIndex NoMiddle = std::numeric_limits<TCompactIndex>::max();
+    static constexpr TCompactIndex CoreRank = std::numeric_limits<TCompactIndex>::max();
+    // Vertices a witness search may settle before giving up and assuming a shortcut is needed
+    static constexpr std::size_t WitnessSettleLimit = 500;
+
+    // Edge of the graph being contracted, DMiddle is the contracted vertex a shortcut bypasses
+    struct SArc{
+        TVertexID DOther;
+        double DWeight;
+        TCompactIndex DMiddle;
+    };
+
+    // Compressed sparse row adjacency of the search graph, the arcs of vertex v are the entries [DOffsets[v], DOffsets[v+1])
+    struct SAdjacency{
+        std::vector< TCompactIndex > DOffsets;
+        std::vector< TCompactIndex > DOthers;
+        std::vector< double > DWeights;
+        std::vector< TCompactIndex > DMiddles;
+    };
+
+    // State of one direction of the query, DMiddles holds the middle vertex of the arc each reached
+    // vertex was reached by and is valid where the search state has reached the vertex
+    struct SDirection{
+        CSearchState<TQueue> DSearch;
+        std::vector< TCompactIndex > DMiddles;
+
+        void Reset(std::size_t vertexcount){
+            DSearch.Reset(vertexcount);
+            if(DMiddles.size() < vertexcount){
+                DMiddles.resize(vertexcount);
+            }
+        }
+    };
+
+    // Entry of a many-to-many bucket, the backward search from destination DTarget reached DVertex at DDistance
+    struct SBucketEntry{
+        TCompactIndex DVertex;
+        std::size_t DTarget;
+        double DDistance;
+    };
+
+    // Scratch state of a query, one search state per direction and the buckets of many-to-many queries
+    struct SWorkspace : public SQueryWorkspace{
+        SDirection DForward;
+        SDirection DBackward;
+        std::vector< SBucketEntry > DBuckets;
+    };
+
+    // The workspace as created by this router, another router's workspace is a caller error
+    static SWorkspace &OwnWorkspace(SQueryWorkspace &workspace){
+        auto Workspace = dynamic_cast< SWorkspace * >(&workspace);
+        if(!Workspace){
+            throw std::invalid_argument("CContractionHierarchyPathRouter: workspace was created by another router");
+        }
+        return *Workspace;
+    }
+
+    // Graph with shortcuts that is built up while vertices are contracted
+    struct SContraction{
+        std::vector< std::vector< SArc > > DOut;
+        std::vector< std::vector< SArc > > DIn;
+        std::vector< bool > DContracted;
+        std::vector< std::size_t > DDeletedNeighbors;
+        std::vector< double > DWitnessDistances;
+        std::vector< TVertexID > DWitnessTouched;
+        TQueue DWitnessQueue;
+        std::size_t DShortcutCount = 0;
+
+        SContraction(std::size_t vertexcount) : DOut(vertexcount), DIn(vertexcount), DContracted(vertexcount, false), DDeletedNeighbors(vertexcount, 0), DWitnessDistances(vertexcount, NoPathExists), DWitnessQueue(vertexcount){
+
+        }
+
+        // Adds the arc src -> dest, or lowers the weight of an existing one.
+        void AddArc(TVertexID src, TVertexID dest, double weight, TCompactIndex middle){
+            if(src == dest){
+                return;
+            }
+            for(auto &Arc : DOut[src]){
+                if(Arc.DOther == dest){
+                    if(weight < Arc.DWeight){
+                        Arc.DWeight = weight;
+                        Arc.DMiddle = middle;
+                        for(auto &InArc : DIn[dest]){
+                            if(InArc.DOther == src){
+                                InArc.DWeight = weight;
+                                InArc.DMiddle = middle;
+                                break;
+                            }
+                        }
+                    }
+                    return;
+                }
+            }
+            DOut[src].push_back({dest, weight, middle});
+            DIn[dest].push_back({src, weight, middle});
+        }
+
+        // Dijkstra from source over uncontracted vertices, skipping excluded and stopping past limit.
+        void WitnessSearch(TVertexID source, TVertexID excluded, double limit){
+            for(auto VertexID : DWitnessTouched){
+                DWitnessDistances[VertexID] = NoPathExists;
+            }
+            DWitnessTouched.clear();
+            DWitnessQueue.Clear();
+            DWitnessDistances[source] = 0.0;
+            DWitnessTouched.push_back(source);
+            DWitnessQueue.Push(source, 0.0);
+            std::size_t Settled = 0;
+            while(!DWitnessQueue.Empty() && (DWitnessQueue.TopPriority() <= limit) && (Settled < WitnessSettleLimit)){
+                auto CurrentID = DWitnessQueue.Pop();
+                Settled++;
+                for(auto &Arc : DOut[CurrentID]){
+                    if(DContracted[Arc.DOther] || (Arc.DOther == excluded)){
+                        continue;
+                    }
+                    auto TotalDistance = DWitnessDistances[CurrentID] + Arc.DWeight;
+                    if(TotalDistance < DWitnessDistances[Arc.DOther]){
+                        if(NoPathExists == DWitnessDistances[Arc.DOther]){
+                            DWitnessTouched.push_back(Arc.DOther);
+                        }
+                        DWitnessDistances[Arc.DOther] = TotalDistance;
+                        DWitnessQueue.Push(Arc.DOther, TotalDistance);
+                    }
+                }
+            }
+        }
+
+        // Counts the shortcuts contracting vertex would need, adding them if apply is set.
+        std::size_t Shortcuts(TVertexID vertex, bool apply){
+            std::size_t Count = 0;
+            for(std::size_t InIndex = 0; InIndex < DIn[vertex].size(); InIndex++){
+                auto InArc = DIn[vertex][InIndex];
+                if(DContracted[InArc.DOther]){
+                    continue;
+                }
+                double Limit = -1.0;
+                for(auto &OutArc : DOut[vertex]){
+                    if(!DContracted[OutArc.DOther] && (OutArc.DOther != InArc.DOther)){
+                        Limit = std::max(Limit, InArc.DWeight + OutArc.DWeight);
+                    }
+                }
+                if(Limit < 0.0){
+                    continue;
+                }
+                WitnessSearch(InArc.DOther, vertex, Limit);
+                for(std::size_t OutIndex = 0; OutIndex < DOut[vertex].size(); OutIndex++){
+                    auto OutArc = DOut[vertex][OutIndex];
+                    if(DContracted[OutArc.DOther] || (OutArc.DOther == InArc.DOther)){
+                        continue;
+                    }
+                    auto Candidate = InArc.DWeight + OutArc.DWeight;
+                    if(Candidate < DWitnessDistances[OutArc.DOther]){
+                        Count++;
+                        if(apply){
+                            AddArc(InArc.DOther, OutArc.DOther, Candidate, vertex);
+                        }
+                    }
+                }
+            }
+            return Count;
+        }
+
+        // Edge difference plus the number of already contracted neighbors, lower is contracted first.
+        double Priority(TVertexID vertex){
+            std::size_t Removed = 0;
+            for(auto &Arc : DIn[vertex]){
+                Removed += DContracted[Arc.DOther] ? 0 : 1;
+            }
+            for(auto &Arc : DOut[vertex]){
+                Removed += DContracted[Arc.DOther] ? 0 : 1;
+            }
+            return double(Shortcuts(vertex, false)) - double(Removed) + double(DDeletedNeighbors[vertex]);
+        }
+
+        void Contract(TVertexID vertex){
+            DShortcutCount += Shortcuts(vertex, true);
+            DContracted[vertex] = true;
+            for(auto &Arc : DIn[vertex]){
+                DDeletedNeighbors[Arc.DOther]++;
+            }
+            for(auto &Arc : DOut[vertex]){
+                DDeletedNeighbors[Arc.DOther]++;
+            }
+        }
+    };
+
+    std::vector< std::any > DVertexTags;
+    std::vector< std::vector< TEdge > > DVertexEdges;
+
+    // Hierarchy built by Precompute, vertices left in the core all have CoreRank
+    bool DBuilt = false;
+    std::vector< TCompactIndex > DRanks;
+    SAdjacency DUpward;
+    SAdjacency DDownward;
+    std::size_t DContractedCount = 0;
+    std::size_t DShortcutCount = 0;
+
+    // Workspace used by the non-const FindShortestPath
+    std::unique_ptr< SQueryWorkspace > DWorkspace;
+
+    std::size_t VertexCount() const noexcept{
+        return DVertexTags.size();
+    }
+
+    TVertexID AddVertex(std::any tag) noexcept{
+        Discard();
+        TVertexID NewVertexID = DVertexTags.size();
+        DVertexTags.push_back(tag);
+        DVertexEdges.emplace_back();
+        return NewVertexID;
+    }
+
+    std::any GetVertexTag(TVertexID id) const noexcept{
+        if(id < DVertexTags.size()){
+            return DVertexTags[id];
+        }
+        return std::any();
+    }
+
+    bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept{
+        if((src < VertexCount())&&(dest < VertexCount())&&(0.0 <= weight)){
+            Discard();
+            DVertexEdges[src].push_back(std::make_pair(weight,dest));
+            if(bidir){
+                DVertexEdges[dest].push_back(std::make_pair(weight, src));
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Drops the hierarchy so the next query or Precompute rebuilds it for the modified graph.
+    void Discard(){
+        if(DBuilt){
+            DRanks.clear();
+            DUpward = SAdjacency();
+            DDownward = SAdjacency();
+            DContractedCount = 0;
+            DShortcutCount = 0;
+            DBuilt = false;
+        }
+    }
+
+    // Returns true if the search from a may follow the arc a -> b, either upward or within the core.
+    bool Upward(TVertexID a, TVertexID b) const{
+        return (DRanks[a] < DRanks[b]) || ((CoreRank == DRanks[a]) && (CoreRank == DRanks[b]));
+    }
+
+    // Contracts vertices in edge difference order until all are contracted or the deadline passes,
+    // then builds the upward and downward search graphs. Returns false if contraction was cut short,
+    // in which case the remaining vertices are searched as an uncontracted core.
+    bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept{
+        if(DBuilt && (DContractedCount == VertexCount())){
+            return true;
+        }
+        // A partial hierarchy is rebuilt from scratch with the new budget
+        Discard();
+        if(std::numeric_limits<TCompactIndex>::max() <= VertexCount()){
+            return false;
+        }
+        SContraction Contraction(VertexCount());
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            for(auto &Edge : DVertexEdges[VertexID]){
+                Contraction.AddArc(VertexID, Edge.second, Edge.first, NoMiddle);
+            }
+        }
+        DRanks.assign(VertexCount(), CoreRank);
+        TCompactIndex NextRank = 0;
+        bool Completed = true;
+        TQueue Order(VertexCount());
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            if(std::chrono::steady_clock::now() >= deadline){
+                Completed = false;
+                break;
+            }
+            Order.Push(VertexID, Contraction.Priority(VertexID));
+        }
+        while(Completed && !Order.Empty()){
+            if(std::chrono::steady_clock::now() >= deadline){
+                Completed = false;
+                break;
+            }
+            auto VertexID = Order.Pop();
+            // Lazy update, the priority may have grown since it was queued
+            auto Priority = Contraction.Priority(VertexID);
+            if(!Order.Empty() && (Priority > Order.TopPriority())){
+                Order.Push(VertexID, Priority);
+                continue;
+            }
+            Contraction.Contract(VertexID);
+            DRanks[VertexID] = NextRank++;
+        }
+        DContractedCount = NextRank;
+        DShortcutCount = Contraction.DShortcutCount;
+
+        DUpward.DOffsets.assign(VertexCount() + 1, 0);
+        DDownward.DOffsets.assign(VertexCount() + 1, 0);
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            for(auto &Arc : Contraction.DOut[VertexID]){
+                if(Upward(VertexID, Arc.DOther)){
+                    DUpward.DOffsets[VertexID + 1]++;
+                }
+                if(Upward(Arc.DOther, VertexID)){
+                    DDownward.DOffsets[Arc.DOther + 1]++;
+                }
+            }
+        }
+        for(std::size_t Index = 1; Index <= VertexCount(); Index++){
+            DUpward.DOffsets[Index] += DUpward.DOffsets[Index - 1];
+            DDownward.DOffsets[Index] += DDownward.DOffsets[Index - 1];
+        }
+        for(auto Adjacency : {&DUpward, &DDownward}){
+            Adjacency->DOthers.resize(Adjacency->DOffsets.back());
+            Adjacency->DWeights.resize(Adjacency->DOffsets.back());
+            Adjacency->DMiddles.resize(Adjacency->DOffsets.back());
+        }
+        std::vector< TCompactIndex > UpwardSlot(DUpward.DOffsets.begin(), DUpward.DOffsets.end() - 1);
+        std::vector< TCompactIndex > DownwardSlot(DDownward.DOffsets.begin(), DDownward.DOffsets.end() - 1);
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            for(auto &Arc : Contraction.DOut[VertexID]){
+                if(Upward(VertexID, Arc.DOther)){
+                    auto Slot = UpwardSlot[VertexID]++;
+                    DUpward.DOthers[Slot] = Arc.DOther;
+                    DUpward.DWeights[Slot] = Arc.DWeight;
+                    DUpward.DMiddles[Slot] = Arc.DMiddle;
+                }
+                if(Upward(Arc.DOther, VertexID)){
+                    auto Slot = DownwardSlot[Arc.DOther]++;
+                    DDownward.DOthers[Slot] = VertexID;
+                    DDownward.DWeights[Slot] = Arc.DWeight;
+                    DDownward.DMiddles[Slot] = Arc.DMiddle;
+                }
+            }
+        }
+        DBuilt = true;
+        return Completed;
+    }
+
+    // Returns the middle vertex of the search graph arc src -> dest.
+    TCompactIndex FindMiddle(TVertexID src, TVertexID dest) const{
+        const SAdjacency &Adjacency = Upward(src, dest) ? DUpward : DDownward;
+        TVertexID Owner = Upward(src, dest) ? src : dest;
+        TVertexID Other = Upward(src, dest) ? dest : src;
+        for(auto Index = Adjacency.DOffsets[Owner]; Index < Adjacency.DOffsets[Owner+1]; Index++){
+            if(Adjacency.DOthers[Index] == Other){
+                return Adjacency.DMiddles[Index];
+            }
+        }
+        return NoMiddle;
+    }
+
+    // Appends the vertices of the arc src -> dest after src, recursively replacing shortcuts by the arcs they bypass.
+    void Unpack(TVertexID src, TVertexID dest, TCompactIndex middle, std::vector<TVertexID> &path) const{
+        std::vector< std::pair< std::pair< TVertexID, TVertexID >, TCompactIndex > > Pending;
+        Pending.push_back(std::make_pair(std::make_pair(src, dest), middle));
+        while(!Pending.empty()){
+            auto Arc = Pending.back();
+            Pending.pop_back();
+            if(NoMiddle == Arc.second){
+                path.push_back(Arc.first.second);
+                continue;
+            }
+            TVertexID Middle = Arc.second;
+            Pending.push_back(std::make_pair(std::make_pair(Middle, Arc.first.second), FindMiddle(Middle, Arc.first.second)));
+            Pending.push_back(std::make_pair(std::make_pair(Arc.first.first, Middle), FindMiddle(Arc.first.first, Middle)));
+        }
+    }
+
+    std::unique_ptr< SQueryWorkspace > CreateWorkspace() const{
+        return std::make_unique< SWorkspace >();
+    }
+
+    // Settles the closest vertex of direction, relaxing its arcs in adjacency and recording the best
+    // meeting point with the opposite direction.
+    void Step(SDirection &direction, const SAdjacency &adjacency, const SDirection &opposite, double &best, TVertexID &meeting) const{
+        auto &Search = direction.DSearch;
+        auto CurrentID = Search.Queue().Pop();
+        auto CurrentDistance = Search.Distance(CurrentID);
+        auto End = adjacency.DOffsets[CurrentID+1];
+        for(auto Index = adjacency.DOffsets[CurrentID]; Index < End; Index++){
+            TVertexID DestID = adjacency.DOthers[Index];
+            auto TotalDistance = CurrentDistance + adjacency.DWeights[Index];
+            if(TotalDistance < Search.Distance(DestID)){
+                Search.Update(DestID, TotalDistance, CurrentID);
+                direction.DMiddles[DestID] = adjacency.DMiddles[Index];
+                Search.Queue().Push(DestID, TotalDistance);
+            }
+            auto OppositeDistance = opposite.DSearch.Distance(DestID);
+            if((NoPathExists != OppositeDistance)&&(TotalDistance + OppositeDistance < best)){
+                best = TotalDistance + OppositeDistance;
+                meeting = DestID;
+            }
+        }
+    }
+
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
+        if(!DBuilt){
+            // Without a hierarchy every vertex is in the core, which is a plain bidirectional search
+            Precompute(std::chrono::steady_clock::time_point::min());
+        }
+        if(!DWorkspace){
+            DWorkspace = CreateWorkspace();
+        }
+        return FindShortestPath(src, dest, path, *DWorkspace);
+    }
+
+    // Searches upward from src and, over reversed arcs, upward from dest. Each direction runs until its
+    // smallest tentative distance reaches the best meeting distance found so far.
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+        if((src >= VertexCount())||(dest >= VertexCount())){
+            return NoPathExists;
+        }
+        auto &Workspace = OwnWorkspace(workspace);
+        auto &Forward = Workspace.DForward;
+        auto &Backward = Workspace.DBackward;
+        Forward.Reset(VertexCount());
+        Backward.Reset(VertexCount());
+        if(!DBuilt){
+            return FindUnidirectional(src, dest, path, Forward.DSearch);
+        }
+        double Best = src == dest ? 0.0 : NoPathExists;
+        TVertexID Meeting = src == dest ? src : InvalidVertexID;
+
+        Forward.DSearch.Update(src, 0.0, InvalidVertexID);
+        Forward.DSearch.Queue().Push(src, 0.0);
+        Backward.DSearch.Update(dest, 0.0, InvalidVertexID);
+        Backward.DSearch.Queue().Push(dest, 0.0);
+        bool ForwardTurn = true;
+        while(true){
+            bool ForwardActive = !Forward.DSearch.Queue().Empty() && (Forward.DSearch.Queue().TopPriority() < Best);
+            bool BackwardActive = !Backward.DSearch.Queue().Empty() && (Backward.DSearch.Queue().TopPriority() < Best);
+            if(!ForwardActive && !BackwardActive){
+                break;
+            }
+            if(ForwardActive && (ForwardTurn || !BackwardActive)){
+                Step(Forward, DUpward, Backward, Best, Meeting);
+            }
+            else{
+                Step(Backward, DDownward, Forward, Best, Meeting);
+            }
+            ForwardTurn = !ForwardTurn;
+        }
+        if(NoPathExists == Best){
+            return NoPathExists;
+        }
+        std::vector< TVertexID > Chain;
+        for(auto VertexID = Meeting; VertexID != InvalidVertexID; VertexID = Forward.DSearch.Previous(VertexID)){
+            Chain.push_back(VertexID);
+        }
+        std::reverse(Chain.begin(), Chain.end());
+        path.clear();
+        path.push_back(Chain.front());
+        for(std::size_t Index = 1; Index < Chain.size(); Index++){
+            Unpack(Chain[Index-1], Chain[Index], Forward.DMiddles[Chain[Index]], path);
+        }
+        for(auto VertexID = Meeting; Backward.DSearch.Previous(VertexID) != InvalidVertexID; VertexID = Backward.DSearch.Previous(VertexID)){
+            Unpack(VertexID, Backward.DSearch.Previous(VertexID), Backward.DMiddles[VertexID], path);
+        }
+        return Best;
+    }
+
+    // Plain Dijkstra over the edge lists, used by const queries before a hierarchy has been built.
+    double FindUnidirectional(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, CSearchState<TQueue> &search) const{
+        search.Update(src, 0.0, InvalidVertexID);
+        search.Queue().Push(src, 0.0);
+        while(!search.Queue().Empty()){
+            auto CurrentID = search.Queue().Pop();
+            if(CurrentID == dest){
+                break;
+            }
+            for(auto &Edge : DVertexEdges[CurrentID]){
+                auto TotalDistance = search.Distance(CurrentID) + Edge.first;
+                if(TotalDistance < search.Distance(Edge.second)){
+                    search.Update(Edge.second, TotalDistance, CurrentID);
+                    search.Queue().Push(Edge.second, TotalDistance);
+                }
+            }
+        }
+        if(NoPathExists == search.Distance(dest)){
+            return NoPathExists;
+        }
+        path.clear();
+        for(auto VertexID = dest; VertexID != InvalidVertexID; VertexID = search.Previous(VertexID)){
+            path.push_back(VertexID);
+        }
+        std::reverse(path.begin(), path.end());
+        return search.Distance(dest);
+    }
+
+    // Settles every vertex reachable from source over the arcs of adjacency, calling visit(vertex, distance) for each.
+    template <typename TVisit>
+    void SearchAll(CSearchState<TQueue> &search, const SAdjacency &adjacency, TVertexID source, TVisit visit) const{
+        search.Reset(VertexCount());
+        search.Update(source, 0.0, InvalidVertexID);
+        search.Queue().Push(source, 0.0);
+        while(!search.Queue().Empty()){
+            auto CurrentID = search.Queue().Pop();
+            auto CurrentDistance = search.Distance(CurrentID);
+            visit(CurrentID, CurrentDistance);
+            auto End = adjacency.DOffsets[CurrentID+1];
+            for(auto Index = adjacency.DOffsets[CurrentID]; Index < End; Index++){
+                TVertexID DestID = adjacency.DOthers[Index];
+                auto TotalDistance = CurrentDistance + adjacency.DWeights[Index];
+                if(TotalDistance < search.Distance(DestID)){
+                    search.Update(DestID, TotalDistance, CurrentID);
+                    search.Queue().Push(DestID, TotalDistance);
+                }
+            }
+        }
+    }
+
+    // The hierarchy only answers point to point and bucket queries, so a bounded search runs over the
+    // original edges, which are kept alongside it.
+    std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+        auto &Workspace = OwnWorkspace(workspace);
+        return ::FindVerticesWithin(Workspace.DForward.DSearch, VertexCount(), src, budget, [this](TVertexID id, auto function){
+            for(auto &Edge : DVertexEdges[id]){
+                function(Edge.second, Edge.first);
+            }
+        });
+    }
+
+    std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        return FindDistanceMatrix(std::vector<TVertexID>{src}, dests, workspace).front();
+    }
+
+    // Bucket based many-to-many search. The backward search from each destination leaves an entry in
+    // the bucket of every vertex it settles, then the forward search from each source combines the
+    // distances to the vertices it settles with their bucket entries. Both searches only go upward,
+    // so each is far smaller than a search of the whole graph.
+    std::vector< std::vector<double> > FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        auto &Workspace = OwnWorkspace(workspace);
+        std::vector< std::vector<double> > Matrix;
+        if(!DBuilt){
+            for(auto Source : sources){
+                Matrix.push_back(FindTargetDistances(Workspace.DForward.DSearch, VertexCount(), Source, dests, [this](TVertexID id, auto function){
+                    for(auto &Edge : DVertexEdges[id]){
+                        function(Edge.second, Edge.first);
+                    }
+                }));
+            }
+            return Matrix;
+        }
+        Matrix.assign(sources.size(), std::vector<double>(dests.size(), NoPathExists));
+        auto &Buckets = Workspace.DBuckets;
+        Buckets.clear();
+        for(std::size_t Target = 0; Target < dests.size(); Target++){
+            if(dests[Target] < VertexCount()){
+                SearchAll(Workspace.DBackward.DSearch, DDownward, dests[Target], [&](TVertexID VertexID, double Distance){
+                    Buckets.push_back(SBucketEntry{TCompactIndex(VertexID), Target, Distance});
+                });
+            }
+        }
+        auto VertexLess = [](const SBucketEntry &left, const SBucketEntry &right){
+            return left.DVertex < right.DVertex;
+        };
+        std::sort(Buckets.begin(), Buckets.end(), VertexLess);
+        for(std::size_t Index = 0; Index < sources.size(); Index++){
+            if(sources[Index] >= VertexCount()){
+                continue;
+            }
+            auto &Row = Matrix[Index];
+            SearchAll(Workspace.DForward.DSearch, DUpward, sources[Index], [&](TVertexID VertexID, double Distance){
+                auto Range = std::equal_range(Buckets.begin(), Buckets.end(), SBucketEntry{TCompactIndex(VertexID), 0, 0.0}, VertexLess);
+                for(auto Entry = Range.first; Entry != Range.second; Entry++){
+                    Row[Entry->DTarget] = std::min(Row[Entry->DTarget], Distance + Entry->DDistance);
+                }
+            });
+        }
+        return Matrix;
+    }
+};
+
+CContractionHierarchyPathRouter::CContractionHierarchyPathRouter(){
+    DImplementation = std::make_unique<SImplementation>();
+}
+
+CContractionHierarchyPathRouter::~CContractionHierarchyPathRouter(){
+
+}
+
+std::size_t CContractionHierarchyPathRouter::ContractedCount() const noexcept{
+    return DImplementation->DContractedCount;
+}
+
+std::size_t CContractionHierarchyPathRouter::ShortcutCount() const noexcept{
+    return DImplementation->DShortcutCount;
+}
+
+std::size_t CContractionHierarchyPathRouter::VertexCount() const noexcept{
+    return DImplementation->VertexCount();
+}
+
+CPathRouter::TVertexID CContractionHierarchyPathRouter::AddVertex(std::any tag) noexcept{
+    return DImplementation->AddVertex(tag);
+}
+
+std::any CContractionHierarchyPathRouter::GetVertexTag(TVertexID id) const noexcept{
+    return DImplementation->GetVertexTag(id);
+}
+
+bool CContractionHierarchyPathRouter::AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir) noexcept{
+    return DImplementation->AddEdge(src,dest,weight,bidir);
+}
+
+bool CContractionHierarchyPathRouter::Precompute(std::chrono::steady_clock::time_point deadline) noexcept{
+    return DImplementation->Precompute(deadline);
+}
+
+double CContractionHierarchyPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
+    return DImplementation->FindShortestPath(src,dest,path);
+}
+
+std::unique_ptr<CPathRouter::SQueryWorkspace> CContractionHierarchyPathRouter::CreateWorkspace() const{
+    return DImplementation->CreateWorkspace();
+}
+
+bool CContractionHierarchyPathRouter::ConcurrentQueries() const noexcept{
+    return true;
+}
+
+double CContractionHierarchyPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindShortestPath(src,dest,path,workspace);
+}
+
+
+std::vector<double> CContractionHierarchyPathRouter::FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindDistances(src,dests,workspace);
+}
+
+std::vector< std::vector<double> > CContractionHierarchyPathRouter::FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindDistanceMatrix(sources,dests,workspace);
+}
+
+std::vector< std::pair<CPathRouter::TVertexID, double> > CContractionHierarchyPathRouter::FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindVerticesWithin(src,budget,workspace);
+}
\ No newline at end of file
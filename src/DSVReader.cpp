@@ -1,5 +1,6 @@
 #include "DSVReader.h"
 #include "DataSource.h"
+#include <algorithm>
 struct CDSVReader::SImplementation{
     std::shared_ptr< CDataSource > source;
     char delimiter;
@@ -16,21 +17,29 @@ struct CDSVReader::SImplementation{
     bool dataRead = false;
     row.clear(); // Clear the passed vector to hold the new row.
 
-    // Loop to read characters until a newline is encountered or the end of the source.
-    while (!source->End() && source->Get(ch)) {
+    // Loop over the source's chunks until a newline is encountered or the end of the source.
+    while (true) {
+        auto chunk = source->Chunk();
+        if (!chunk.second) {
+            break;
+        }
         dataRead = true; // Mark that we've started reading data.
 
-        if (ch == '\n' || ch == '\r') {
-            // Handle possible Windows-style newline sequence "\r\n".
-            if (ch == '\r' && source->Peek(ch) && ch == '\n') {
-                source->Get(ch); // Consume the '\n' character.
-            }
-            break; // Exit the loop as the end of a row is reached.
+        auto chunkEnd = chunk.first + chunk.second;
+        auto newline = std::find_if(chunk.first, chunkEnd, [](char c) { return c == '\n' || c == '\r'; });
+        line.append(chunk.first, newline); // Append the characters before any newline to the current line.
+        if (newline == chunkEnd) {
+            source->Advance(chunk.second); // The row continues in the next chunk.
+            continue;
         }
 
-        else {
-            line += ch; // Append the character to the current line.
+        char terminator = *newline;
+        source->Advance(newline - chunk.first + 1);
+        // Handle possible Windows-style newline sequence "\r\n".
+        if (terminator == '\r' && source->Peek(ch) && ch == '\n') {
+            source->Get(ch); // Consume the '\n' character.
         }
+        break; // Exit the loop as the end of a row is reached.
     }
 
     // If no data was read (and possibly the end of the source was reached), return false.
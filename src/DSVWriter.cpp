@@ -28,12 +28,8 @@ struct CDSVWriter::SImplementation{
         }
     }
 
-    // Write the constructed line to the sink
-    for (char c : line) {
-        sink->Put(c);
-    }
-
-    return true; // Indicate successful writing
+    // Write the constructed line to the sink in one call
+    return sink->Write(std::vector<char>(line.begin(), line.end()));
 }
 };
 CDSVWriter::CDSVWriter(std::shared_ptr< CDataSink > sink, char delimiter, bool quoteall){
@@ -1,111 +1,540 @@
 #include "DijkstraPathRouter.h"
+#include "IndexedPriorityQueue.h"
+#include "SearchState.h"
+#include "MultiMetricGraph.h"
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 
 struct CDijkstraPathRouter::SImplementation{
     // Defines an edge in the graph as a pair of a double (the weight of the edge) and a TVertexID (the destination vertex).
     using TEdge = std::pair<double, TVertexID>;
-    
-    // Represents a vertex in the graph, holding any type of tag and a list of outgoing edges.
-    struct SVertex{
-        std::any DTag; // Can hold any type of data associated with the vertex
-        std::vector< TEdge > DEdges; // List of edges originating from this vertex.
-    };
+    // Index type of the compressed sparse row arrays built by Precompute.
+    using TCompactIndex = uint32_t;
+
+    // Tags associated with each vertex, indexed by vertex ID
+    std::vector< std::any > DVertexTags;
+
+    // Per-vertex lists of outgoing edges, used while the graph is being built
+    std::vector< std::vector< TEdge > > DVertexEdges;
+
+    // Compressed sparse row adjacency built by Precompute, the outgoing edges of vertex v are
+    // the entries [DEdgeOffsets[v], DEdgeOffsets[v+1]) of the target and weight arrays.
+    bool DFrozen = false;
+    std::vector< TCompactIndex > DEdgeOffsets;
+    std::vector< TCompactIndex > DEdgeTargets;
+    std::vector< double > DEdgeWeights;
+
+    // Frozen graph searched under DSharedMetric instead of the router's own vertices and edges
+    std::shared_ptr< const CMultiMetricGraph > DSharedGraph;
+    std::size_t DSharedMetric = 0;
+
+    // Frontier used by FindShortestPath
+    EQueueType DQueueType;
+
+    // Optional A* lower bound, plain Dijkstra when empty
+    THeuristic DHeuristic;
+
+    // ALT landmarks selected by Precompute. The tables are interleaved by vertex, entry
+    // [v * DLandmarks.size() + l] holds the distance from landmark l to v (DLandmarkFrom)
+    // and from v to landmark l (DLandmarkTo).
+    std::size_t DLandmarkCount = 0;
+    std::vector< TVertexID > DLandmarks;
+    std::vector< double > DLandmarkFrom;
+    std::vector< double > DLandmarkTo;
+    std::chrono::steady_clock::duration DLandmarkSelectionTime = std::chrono::steady_clock::duration::zero();
+
+    SImplementation(EQueueType queuetype) : DQueueType(queuetype){
 
-    // A vector holding all the vertices in the graph
-    std::vector< SVertex > DVertices;
+    }
 
     // Returns the total number of vertices in the graph.
     std::size_t VertexCount() const noexcept{
-        return DVertices.size();
+        return DSharedGraph ? DSharedGraph->VertexCount() : DVertexTags.size();
     }
 
     // Adds a new vertex to the graph with an associated tag and returns its ID
     TVertexID AddVertex(std::any tag) noexcept{
-        TVertexID NewVertexID = DVertices.size();
-        DVertices.push_back({tag,});
+        if(DSharedGraph){
+            return InvalidVertexID;
+        }
+        Thaw();
+        DiscardLandmarks();
+        TVertexID NewVertexID = DVertexTags.size();
+        DVertexTags.push_back(tag);
+        DVertexEdges.emplace_back();
         return NewVertexID;
     }
 
     // Retrieves the tag associated with a given vertex ID.
     std::any GetVertexTag(TVertexID id) const noexcept{
-        if(id < DVertices.size()){
-            return DVertices[id].DTag;
+        if(DSharedGraph){
+            return DSharedGraph->GetVertexTag(id);
+        }
+        if(id < DVertexTags.size()){
+            return DVertexTags[id];
         }
         return std::any();
     }
 
     bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept{
-        if((src < DVertices.size())&&(dest < DVertices.size())&&(0.0 <= weight)){
-            DVertices[src].DEdges.push_back(std::make_pair(weight,dest));
+        if(!DSharedGraph && (src < VertexCount())&&(dest < VertexCount())&&(0.0 <= weight)){
+            Thaw();
+            DiscardLandmarks();
+            DVertexEdges[src].push_back(std::make_pair(weight,dest));
             if(bidir){
-            DVertices[dest].DEdges.push_back(std::make_pair(weight, src));
+                DVertexEdges[dest].push_back(std::make_pair(weight, src));
             }
             return true;
         }
         return false;
     }
 
-    // Placeholder for a future optimization method that precomputes data to speed up path finding.
+    // Freezes the graph and selects the landmarks if any have been requested.
     bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept{
+        Freeze();
+        if(DLandmarkCount && DLandmarks.empty()){
+            SelectLandmarks(deadline);
+        }
         return true;
     }
 
-    // Implements Dijkstra's algorithm to find the shortest path from a source vertex to a destination vertex.
-    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
-    if (src >= VertexCount() || dest >= VertexCount()) {
-        return NoPathExists; // Invalid vertex ID
-    }
-        std::vector<TVertexID> PendingVertices;
-        std::vector<TVertexID> Previous(DVertices.size(), CPathRouter::InvalidVertexID);
-        std::vector< double > Distances(DVertices.size(), CPathRouter::NoPathExists);
-        auto VertexCompare = [&Distances](TVertexID left, TVertexID right){return Distances[left] < Distances[right];};
-
-        Distances[src] = 0.0;
-        PendingVertices.push_back(src);
-        while(!PendingVertices.empty()){
-            auto CurrenID = PendingVertices.front();
-            std::pop_heap(PendingVertices.begin(), PendingVertices.end(), VertexCompare);
-            PendingVertices.pop_back();
-
-            for(auto Edge : DVertices[CurrenID].DEdges){
-                auto EdgeWeight = Edge.first;
-                auto DestID = Edge.second;
-                auto TotalDistance = Distances[CurrenID] + EdgeWeight;
-                if(TotalDistance < Distances[DestID]){
-                    if(CPathRouter::NoPathExists == Distances[DestID]){
-                        PendingVertices.push_back(DestID);
+    // Freezes the per-vertex edge lists into the compressed sparse row arrays and releases the lists.
+    void Freeze(){
+        if(DFrozen || DSharedGraph){
+            return;
+        }
+        std::size_t EdgeCount = 0;
+        for(auto &Edges : DVertexEdges){
+            EdgeCount += Edges.size();
+        }
+        if((std::numeric_limits<TCompactIndex>::max() <= VertexCount())||(std::numeric_limits<TCompactIndex>::max() <= EdgeCount)){
+            // Too large for the compact index type, queries keep using the edge lists
+            return;
+        }
+        DEdgeOffsets.reserve(VertexCount() + 1);
+        DEdgeTargets.reserve(EdgeCount);
+        DEdgeWeights.reserve(EdgeCount);
+        DEdgeOffsets.push_back(0);
+        for(auto &Edges : DVertexEdges){
+            for(auto &Edge : Edges){
+                DEdgeTargets.push_back(Edge.second);
+                DEdgeWeights.push_back(Edge.first);
+            }
+            DEdgeOffsets.push_back(DEdgeTargets.size());
+        }
+        std::vector< std::vector< TEdge > >().swap(DVertexEdges);
+        DFrozen = true;
+    }
+
+    // Expands the compressed sparse row arrays back into per-vertex edge lists so the graph can be modified.
+    void Thaw(){
+        if(!DFrozen){
+            return;
+        }
+        DVertexEdges.resize(VertexCount());
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            DVertexEdges[VertexID].reserve(DEdgeOffsets[VertexID+1] - DEdgeOffsets[VertexID]);
+            for(auto Index = DEdgeOffsets[VertexID]; Index < DEdgeOffsets[VertexID+1]; Index++){
+                DVertexEdges[VertexID].push_back(std::make_pair(DEdgeWeights[Index], TVertexID(DEdgeTargets[Index])));
+            }
+        }
+        std::vector< TCompactIndex >().swap(DEdgeOffsets);
+        std::vector< TCompactIndex >().swap(DEdgeTargets);
+        std::vector< double >().swap(DEdgeWeights);
+        DFrozen = false;
+    }
+
+    // Calls function(target, weight) for each outgoing edge of the vertex.
+    template <typename TFunction>
+    void ForEachEdge(TVertexID id, TFunction function) const{
+        if(DFrozen){
+            auto End = DEdgeOffsets[id+1];
+            for(auto Index = DEdgeOffsets[id]; Index < End; Index++){
+                function(TVertexID(DEdgeTargets[Index]), DEdgeWeights[Index]);
+            }
+        }
+        else if(DSharedGraph){
+            DSharedGraph->ForEachEdge(id, DSharedMetric, function);
+        }
+        else{
+            for(auto &Edge : DVertexEdges[id]){
+                function(Edge.second, Edge.first);
+            }
+        }
+    }
+
+    // Drops the router's own graph and searches metric of graph, which must be frozen
+    bool ShareGraph(std::shared_ptr< const CMultiMetricGraph > graph, std::size_t metric) noexcept{
+        if(!graph || !graph->Frozen() || (graph->MetricCount() <= metric)){
+            return false;
+        }
+        DiscardLandmarks();
+        std::vector< std::any >().swap(DVertexTags);
+        std::vector< std::vector< TEdge > >().swap(DVertexEdges);
+        std::vector< TCompactIndex >().swap(DEdgeOffsets);
+        std::vector< TCompactIndex >().swap(DEdgeTargets);
+        std::vector< double >().swap(DEdgeWeights);
+        DFrozen = false;
+        DSharedGraph = graph;
+        DSharedMetric = metric;
+        return true;
+    }
+
+    void DiscardLandmarks(){
+        if(!DLandmarks.empty()){
+            DLandmarks.clear();
+            std::vector< double >().swap(DLandmarkFrom);
+            std::vector< double >().swap(DLandmarkTo);
+        }
+    }
+
+    // Fills distances with the shortest distance from source to every vertex, following the edges
+    // given by adjacency(id, function).
+    template <typename TAdjacency>
+    void FindAllDistances(TVertexID source, TAdjacency adjacency, std::vector< double > &distances) const{
+        CIndexedPriorityQueue<4> PendingVertices(VertexCount());
+        distances.assign(VertexCount(), CPathRouter::NoPathExists);
+        distances[source] = 0.0;
+        PendingVertices.Push(source, 0.0);
+        while(!PendingVertices.Empty()){
+            auto CurrentID = PendingVertices.Pop();
+            auto CurrentDistance = distances[CurrentID];
+            adjacency(CurrentID, [&](TVertexID DestID, double EdgeWeight){
+                auto TotalDistance = CurrentDistance + EdgeWeight;
+                if(TotalDistance < distances[DestID]){
+                    distances[DestID] = TotalDistance;
+                    PendingVertices.Push(DestID, TotalDistance);
+                }
+            });
+        }
+    }
+
+    // Selects up to DLandmarkCount landmarks by farthest point selection, each new landmark is the
+    // reachable vertex farthest from the landmarks chosen so far. Stops early if the deadline passes.
+    void SelectLandmarks(std::chrono::steady_clock::time_point deadline){
+        auto SelectionStart = std::chrono::steady_clock::now();
+        // Reverse adjacency for the distances to each landmark
+        std::vector< std::size_t > ReverseOffsets(VertexCount() + 1, 0);
+        std::vector< TVertexID > ReverseTargets;
+        std::vector< double > ReverseWeights;
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            ForEachEdge(VertexID, [&](TVertexID DestID, double){
+                ReverseOffsets[DestID + 1]++;
+            });
+        }
+        for(std::size_t Index = 1; Index <= VertexCount(); Index++){
+            ReverseOffsets[Index] += ReverseOffsets[Index - 1];
+        }
+        ReverseTargets.resize(ReverseOffsets.back());
+        ReverseWeights.resize(ReverseOffsets.back());
+        std::vector< std::size_t > NextSlot(ReverseOffsets.begin(), ReverseOffsets.end() - 1);
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            ForEachEdge(VertexID, [&](TVertexID DestID, double EdgeWeight){
+                auto Slot = NextSlot[DestID]++;
+                ReverseTargets[Slot] = VertexID;
+                ReverseWeights[Slot] = EdgeWeight;
+            });
+        }
+        auto Forward = [this](TVertexID id, auto function){
+            ForEachEdge(id, function);
+        };
+        auto Backward = [&](TVertexID id, auto function){
+            for(auto Index = ReverseOffsets[id]; Index < ReverseOffsets[id+1]; Index++){
+                function(ReverseTargets[Index], ReverseWeights[Index]);
+            }
+        };
+
+        std::vector< std::vector< double > > FromTables, ToTables;
+        std::vector< double > Separation;
+        // The search starts from the vertex with the most edges, which is unlikely to be on a small
+        // island of the graph, and the first landmark is the vertex farthest from it
+        std::vector< std::size_t > Degrees(VertexCount(), 0);
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            ForEachEdge(VertexID, [&](TVertexID, double){
+                Degrees[VertexID]++;
+            });
+        }
+        if(VertexCount()){
+            FindAllDistances(std::max_element(Degrees.begin(), Degrees.end()) - Degrees.begin(), Forward, Separation);
+        }
+        while(VertexCount() && (FromTables.size() < DLandmarkCount) && (std::chrono::steady_clock::now() < deadline)){
+            TVertexID Landmark = InvalidVertexID;
+            for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+                if((CPathRouter::NoPathExists != Separation[VertexID])&&(0.0 < Separation[VertexID])&&((InvalidVertexID == Landmark)||(Separation[Landmark] < Separation[VertexID]))){
+                    Landmark = VertexID;
+                }
+            }
+            if(InvalidVertexID == Landmark){
+                // Every reachable vertex is covered, continue in an unreached part of the graph
+                for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+                    if((CPathRouter::NoPathExists == Separation[VertexID])&&Degrees[VertexID]&&((InvalidVertexID == Landmark)||(Degrees[Landmark] < Degrees[VertexID]))){
+                        Landmark = VertexID;
                     }
-                    Distances[DestID] = TotalDistance;
-                    Previous[DestID] = CurrenID;
                 }
+                if(InvalidVertexID == Landmark){
+                    break;
+                }
+            }
+            FromTables.emplace_back();
+            ToTables.emplace_back();
+            FindAllDistances(Landmark, Forward, FromTables.back());
+            FindAllDistances(Landmark, Backward, ToTables.back());
+            if(1 == FromTables.size()){
+                Separation.assign(VertexCount(), CPathRouter::NoPathExists);
+            }
+            for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+                Separation[VertexID] = std::min(Separation[VertexID], std::min(FromTables.back()[VertexID], ToTables.back()[VertexID]));
+            }
+            DLandmarks.push_back(Landmark);
+        }
+
+        DLandmarkFrom.resize(VertexCount() * DLandmarks.size());
+        DLandmarkTo.resize(VertexCount() * DLandmarks.size());
+        for(TVertexID VertexID = 0; VertexID < VertexCount(); VertexID++){
+            for(std::size_t Index = 0; Index < DLandmarks.size(); Index++){
+                DLandmarkFrom[VertexID * DLandmarks.size() + Index] = FromTables[Index][VertexID];
+                DLandmarkTo[VertexID * DLandmarks.size() + Index] = ToTables[Index][VertexID];
+            }
+        }
+        DLandmarkSelectionTime = std::chrono::steady_clock::now() - SelectionStart;
+    }
+
+    // Triangle inequality lower bound on the distance from vertex to dest over all landmarks,
+    // d(L,dest) - d(L,vertex) and d(vertex,L) - d(dest,L), using only finite table entries.
+    double LandmarkBound(TVertexID vertex, TVertexID dest) const{
+        double Bound = 0.0;
+        std::size_t Count = DLandmarks.size();
+        const double *VertexFrom = DLandmarkFrom.data() + vertex * Count;
+        const double *VertexTo = DLandmarkTo.data() + vertex * Count;
+        const double *DestFrom = DLandmarkFrom.data() + dest * Count;
+        const double *DestTo = DLandmarkTo.data() + dest * Count;
+        for(std::size_t Index = 0; Index < Count; Index++){
+            if((CPathRouter::NoPathExists != DestFrom[Index])&&(CPathRouter::NoPathExists != VertexFrom[Index])){
+                Bound = std::max(Bound, DestFrom[Index] - VertexFrom[Index]);
+            }
+            if((CPathRouter::NoPathExists != VertexTo[Index])&&(CPathRouter::NoPathExists != DestTo[Index])){
+                Bound = std::max(Bound, VertexTo[Index] - DestTo[Index]);
+            }
+        }
+        return Bound;
+    }
+
+    // Lower bound used to direct the search, the larger of the heuristic and the landmark bound.
+    double Estimate(TVertexID vertex, TVertexID dest) const{
+        double Bound = DLandmarks.empty() ? 0.0 : LandmarkBound(vertex, dest);
+        if(DHeuristic){
+            Bound = std::max(Bound, DHeuristic(vertex, dest));
+        }
+        return Bound;
+    }
+
+    // Scratch state of a query with the frontier type TQueue
+    template <typename TQueue>
+    struct SWorkspace : public SQueryWorkspace{
+        CSearchState< TQueue > DSearch;
+    };
+
+    // The workspace as created by this router, another router's workspace is a caller error
+    template <typename TQueue>
+    static SWorkspace<TQueue> &OwnWorkspace(SQueryWorkspace &workspace){
+        auto Workspace = dynamic_cast< SWorkspace<TQueue> * >(&workspace);
+        if(!Workspace){
+            throw std::invalid_argument("CDijkstraPathRouter: workspace was created by another router");
+        }
+        return *Workspace;
+    }
+
+    // Workspace used by the non-const FindShortestPath
+    std::unique_ptr< SQueryWorkspace > DWorkspace;
+
+    std::unique_ptr< SQueryWorkspace > CreateWorkspace() const{
+        switch(DQueueType){
+            case EQueueType::Rebuild:           return std::make_unique< SWorkspace<CRebuildPriorityQueue> >();
+            case EQueueType::BinaryHeap:        return std::make_unique< SWorkspace< CIndexedPriorityQueue<2> > >();
+            case EQueueType::QuaternaryHeap:
+            default:                            return std::make_unique< SWorkspace< CIndexedPriorityQueue<4> > >();
+        }
+    }
+
+    // Implements Dijkstra's algorithm to find the shortest path from a source vertex to a destination vertex.
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
+        if(!DWorkspace){
+            DWorkspace = CreateWorkspace();
+        }
+        return FindShortestPath(src, dest, path, *DWorkspace);
+    }
+
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+        switch(DQueueType){
+            case EQueueType::Rebuild:           return FindShortestPath<CRebuildPriorityQueue>(src, dest, path, workspace);
+            case EQueueType::BinaryHeap:        return FindShortestPath< CIndexedPriorityQueue<2> >(src, dest, path, workspace);
+            case EQueueType::QuaternaryHeap:
+            default:                            return FindShortestPath< CIndexedPriorityQueue<4> >(src, dest, path, workspace);
+        }
+    }
+
+    // Dijkstra's search over the frontier type TQueue, each vertex is queued at most once and its
+    // priority is lowered in place when a shorter tentative distance is found. The search stops as
+    // soon as dest is settled, and is target directed (A*) when a heuristic or landmarks have been set.
+    template <typename TQueue>
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+        if (src >= VertexCount() || dest >= VertexCount()) {
+            return NoPathExists; // Invalid vertex ID
+        }
+        auto &Workspace = OwnWorkspace<TQueue>(workspace);
+        auto &Search = Workspace.DSearch;
+        Search.Reset(VertexCount());
+        auto &PendingVertices = Search.Queue();
+
+        bool Directed = DHeuristic || !DLandmarks.empty();
+        Search.Update(src, 0.0, CPathRouter::InvalidVertexID);
+        PendingVertices.Push(src, Directed ? Estimate(src, dest) : 0.0);
+        while(!PendingVertices.Empty()){
+            auto CurrentID = PendingVertices.Pop();
+            if(CurrentID == dest){
+                break;
             }
-            std::make_heap(PendingVertices.begin(), PendingVertices.end(), VertexCompare);
+
+            auto CurrentDistance = Search.Distance(CurrentID);
+            ForEachEdge(CurrentID, [&](TVertexID DestID, double EdgeWeight){
+                auto TotalDistance = CurrentDistance + EdgeWeight;
+                if(TotalDistance < Search.Distance(DestID)){
+                    Search.Update(DestID, TotalDistance, CurrentID);
+                    PendingVertices.Push(DestID, Directed ? TotalDistance + Estimate(DestID, dest) : TotalDistance);
+                }
+            });
         }
-        if(CPathRouter::NoPathExists == Distances[dest]){
+        if(CPathRouter::NoPathExists == Search.Distance(dest)){
             return CPathRouter::NoPathExists;
         }
-        double PathDistance = Distances[dest];
+        double PathDistance = Search.Distance(dest);
         path.clear();
         path.push_back(dest);
-        do{
-            dest = Previous[dest];
+        while(dest != src){
+            dest = Search.Previous(dest);
             path.push_back(dest);
-        }while(dest != src);
+        }
         std::reverse(path.begin(), path.end());
         return PathDistance;
     }
 
+    std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        switch(DQueueType){
+            case EQueueType::Rebuild:           return FindDistances<CRebuildPriorityQueue>(src, dests, workspace);
+            case EQueueType::BinaryHeap:        return FindDistances< CIndexedPriorityQueue<2> >(src, dests, workspace);
+            case EQueueType::QuaternaryHeap:
+            default:                            return FindDistances< CIndexedPriorityQueue<4> >(src, dests, workspace);
+        }
+    }
+
+    // One search from src that runs until every destination is settled. It is not target directed,
+    // since no single destination can steer it.
+    template <typename TQueue>
+    std::vector<double> FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        auto &Workspace = OwnWorkspace<TQueue>(workspace);
+        return FindTargetDistances(Workspace.DSearch, VertexCount(), src, dests, [this](TVertexID id, auto function){
+            ForEachEdge(id, function);
+        });
+    }
+
+    std::vector< std::vector<double> > FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+        std::vector< std::vector<double> > Matrix;
+        for(auto Source : sources){
+            Matrix.push_back(FindDistances(Source, dests, workspace));
+        }
+        return Matrix;
+    }
+
+    std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+        switch(DQueueType){
+            case EQueueType::Rebuild:           return FindVerticesWithin<CRebuildPriorityQueue>(src, budget, workspace);
+            case EQueueType::BinaryHeap:        return FindVerticesWithin< CIndexedPriorityQueue<2> >(src, budget, workspace);
+            case EQueueType::QuaternaryHeap:
+            default:                            return FindVerticesWithin< CIndexedPriorityQueue<4> >(src, budget, workspace);
+        }
+    }
+
+    template <typename TQueue>
+    std::vector< std::pair<TVertexID, double> > FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+        auto &Workspace = OwnWorkspace<TQueue>(workspace);
+        return ::FindVerticesWithin(Workspace.DSearch, VertexCount(), src, budget, [this](TVertexID id, auto function){
+            ForEachEdge(id, function);
+        });
+    }
+
 };
 
 // Constructors, destructors, and member function definitions that delegate to the SImplementation.
-CDijkstraPathRouter::CDijkstraPathRouter(){
-    DImplementation = std::make_unique<SImplementation>();
+CDijkstraPathRouter::CDijkstraPathRouter(EQueueType queuetype){
+    DImplementation = std::make_unique<SImplementation>(queuetype);
 }
 
 CDijkstraPathRouter::~CDijkstraPathRouter(){
 
 }
 
+CDijkstraPathRouter::EQueueType CDijkstraPathRouter::QueueType() const noexcept{
+    return DImplementation->DQueueType;
+}
+
+void CDijkstraPathRouter::SetHeuristic(THeuristic heuristic) noexcept{
+    DImplementation->DHeuristic = heuristic;
+}
+
+void CDijkstraPathRouter::SetLandmarkCount(std::size_t count) noexcept{
+    if(count != DImplementation->DLandmarkCount){
+        DImplementation->DLandmarkCount = count;
+        DImplementation->DiscardLandmarks();
+    }
+}
+
+std::size_t CDijkstraPathRouter::LandmarkCount() const noexcept{
+    return DImplementation->DLandmarkCount;
+}
+
+std::size_t CDijkstraPathRouter::SelectedLandmarkCount() const noexcept{
+    return DImplementation->DLandmarks.size();
+}
+
+std::size_t CDijkstraPathRouter::LandmarkBytes() const noexcept{
+    // One distance from and one distance to the landmark per vertex
+    return 2 * DImplementation->VertexCount() * sizeof(double);
+}
+
+std::chrono::steady_clock::duration CDijkstraPathRouter::LandmarkSelectionTime() const noexcept{
+    return DImplementation->DLandmarkSelectionTime;
+}
+
+void CDijkstraPathRouter::GetLandmarkTables(std::vector< TVertexID > &landmarks, std::vector< double > &from, std::vector< double > &to) const{
+    landmarks = DImplementation->DLandmarks;
+    from = DImplementation->DLandmarkFrom;
+    to = DImplementation->DLandmarkTo;
+}
+
+bool CDijkstraPathRouter::SetLandmarkTables(std::vector< TVertexID > landmarks, std::vector< double > from, std::vector< double > to) noexcept{
+    auto TableSize = DImplementation->VertexCount() * landmarks.size();
+    if(landmarks.empty() || (from.size() != TableSize) || (to.size() != TableSize)){
+        return false;
+    }
+    for(auto Landmark : landmarks){
+        if(DImplementation->VertexCount() <= Landmark){
+            return false;
+        }
+    }
+    DImplementation->Freeze();
+    DImplementation->DLandmarks = std::move(landmarks);
+    DImplementation->DLandmarkFrom = std::move(from);
+    DImplementation->DLandmarkTo = std::move(to);
+    DImplementation->DLandmarkSelectionTime = std::chrono::steady_clock::duration::zero();
+    return true;
+}
+
+bool CDijkstraPathRouter::ShareGraph(std::shared_ptr< const CMultiMetricGraph > graph, std::size_t metric) noexcept{
+    return DImplementation->ShareGraph(graph, metric);
+}
+
 std::size_t CDijkstraPathRouter::VertexCount() const noexcept{
     return DImplementation->VertexCount();
 }
@@ -128,4 +557,28 @@ bool CDijkstraPathRouter::Precompute(std::chrono::steady_clock::time_point deadl
 
 double CDijkstraPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept{
     return DImplementation->FindShortestPath(src,dest,path);
+}
+
+std::unique_ptr<CPathRouter::SQueryWorkspace> CDijkstraPathRouter::CreateWorkspace() const{
+    return DImplementation->CreateWorkspace();
+}
+
+bool CDijkstraPathRouter::ConcurrentQueries() const noexcept{
+    return true;
+}
+
+double CDijkstraPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindShortestPath(src,dest,path,workspace);
+}
+
+std::vector<double> CDijkstraPathRouter::FindDistances(TVertexID src, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindDistances(src,dests,workspace);
+}
+
+std::vector< std::vector<double> > CDijkstraPathRouter::FindDistanceMatrix(const std::vector<TVertexID> &sources, const std::vector<TVertexID> &dests, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindDistanceMatrix(sources,dests,workspace);
+}
+
+std::vector< std::pair<CPathRouter::TVertexID, double> > CDijkstraPathRouter::FindVerticesWithin(TVertexID src, double budget, SQueryWorkspace &workspace) const noexcept{
+    return DImplementation->FindVerticesWithin(src,budget,workspace);
 }
\ No newline at end of file
@@ -1,34 +1,418 @@
 #include "DijkstraTransportationPlanner.h"
 #include "DijkstraPathRouter.h"
+#include "MultiMetricGraph.h"
 #include "GeographicUtils.h"
 #include "CSVBusSystem.h"
+#include "ThreadPool.h"
+#include "RaptorRouter.h"
+#include "PathCache.h"
+#include "GraphSnapshot.h"
 #include "unordered_map"
 #include <sstream>
 #include <iomanip>
+#include <stdexcept>
 #include <algorithm>
 struct CDijkstraTransportationPlanner::SImplementation{
     std::shared_ptr< CStreetMap > DStreetMap;
     std::shared_ptr< CBusSystem > DBusSystem;
     std::unordered_map< CStreetMap::TNodeID, CPathRouter::TVertexID > DNodeToVertexID;
-    CDijkstraPathRouter DShortestPathRouter;
-    CDijkstraPathRouter DFastestPathRouterBike;
-    CDijkstraPathRouter DFastestPathRouterWalkBus;
+    std::shared_ptr< CPathRouter > DShortestPathRouter;
+    std::shared_ptr< CPathRouter > DFastestPathRouterBike;
+    std::shared_ptr< CPathRouter > DFastestPathRouterWalkBus;
     std::vector<TNodeID> SortedNodeIDs;
+    std::vector< CStreetMap::TLocation > DVertexLocations;
+    // Node of every vertex, street and ride, the same in all routers. Paths are converted to nodes
+    // by indexing it rather than copying each vertex's std::any tag out of a router.
+    std::vector< TNodeID > DVertexNodeIDs;
 
-    SImplementation(std::shared_ptr<SConfiguration> config) {
+    // Hash for a pair of node IDs so stop pairs can key an unordered_map
+    struct SNodePairHash{
+        std::size_t operator()(const std::pair< TNodeID, TNodeID > &pair) const noexcept{
+            return std::hash< TNodeID >()(pair.first) ^ (std::hash< TNodeID >()(pair.second) << 1);
+        }
+    };
+    using TNodePairTimes = std::unordered_map< std::pair< TNodeID, TNodeID >, double, SNodePairHash >;
+
+    // Position of a stop on a route, DIndex is the stop's index within the route
+    struct SRouteStop{
+        std::size_t DRoute;
+        std::size_t DIndex;
+    };
+
+    // Bus network indexed in one pass over the routes: every pair of consecutive stops, keyed by the
+    // stops' node IDs, maps to where the routes serving it leave the first stop.
+    std::unordered_map< std::pair< TNodeID, TNodeID >, std::vector< SRouteStop >, SNodePairHash > DStopPairRoutes;
+
+    // The walk/bus router is layered: the street vertices come first and are followed by the ride
+    // vertices, one per stop of each route, tagged with the stop's node ID.
+    std::size_t DStreetVertexCount = 0;
+    std::vector< std::vector< CPathRouter::TVertexID > > DRideVertexIDs;
+
+    // RAPTOR engine and the walking only routers, forward and reversed, that reach its stops. Only
+    // built for ETransitEngine::Raptor.
+    ETransitEngine DTransitEngine;
+    std::shared_ptr< CPathRouter > DWalkRouter;
+    std::shared_ptr< CPathRouter > DReverseWalkRouter;
+    std::unique_ptr< CRaptorRouter > DRaptorRouter;
+    std::vector< TNodeID > DTransitStopNodeIDs;
+    std::vector< CPathRouter::TVertexID > DTransitStopVertexIDs;
+    // Stop index of each street vertex, InvalidIndex for the vertices that are not stops
+    std::vector< CRaptorRouter::TStopIndex > DVertexStopIndices;
+    // Routes and transfers the RAPTOR engine was built from, kept to save them in a snapshot
+    std::vector< CRaptorRouter::SRoute > DTransitRoutes;
+    std::vector< CRaptorRouter::STransfer > DTransfers;
+
+    // Longest walk in seconds between two stops when changing buses, and most rides in a RAPTOR trip
+    static constexpr double MaxTransferWalkTime = 900.0;
+    static constexpr std::size_t TransitRoundCount = 5;
+
+    // Scratch state of the const queries, one workspace per router
+    struct SContext : public SQueryContext{
+        std::unique_ptr< CPathRouter::SQueryWorkspace > DShortestWorkspace;
+        std::unique_ptr< CPathRouter::SQueryWorkspace > DBikeWorkspace;
+        std::unique_ptr< CPathRouter::SQueryWorkspace > DWalkBusWorkspace;
+        std::vector< CPathRouter::TVertexID > DRouterPath;
+        std::vector< TTripStep > DWalkBusSteps;
+        std::unique_ptr< CPathRouter::SQueryWorkspace > DWalkWorkspace;
+        std::unique_ptr< CPathRouter::SQueryWorkspace > DReverseWalkWorkspace;
+        std::unique_ptr< CRaptorRouter::SQueryWorkspace > DRaptorWorkspace;
+        std::vector< std::pair< CRaptorRouter::TStopIndex, double > > DAccess;
+        std::vector< std::pair< CRaptorRouter::TStopIndex, double > > DEgress;
+        std::vector< CRaptorRouter::SLeg > DLegs;
+    };
+
+    // Context used by the non-const queries
+    std::unique_ptr< SQueryContext > DQueryContext;
+
+    // Results of earlier path queries, the routers never change once built so entries stay valid
+    std::unique_ptr< CPathCache > DPathCache;
+
+    // Metrics of the street graph shared by the routers, the walking only metrics are only built for
+    // ETransitEngine::Raptor
+    enum EMetric : std::size_t {DistanceMetric, BikeTimeMetric, WalkBusTimeMetric, WalkTimeMetric, ReverseWalkTimeMetric, MetricCount};
+
+    // Graph the routers search, and the speeds its weights and the heuristics were found from
+    std::shared_ptr< CMultiMetricGraph > DGraph;
+    double DWalkSpeed = 0.0;
+    double DBikeSpeed = 0.0;
+    double DDefaultSpeedLimit = 0.0;
+    double DBusStopTime = 0.0;
+    double DMaxBusSpeed = 0.0;
+
+    // Sections of a planner snapshot. The weights of metric m are in EdgeWeightsSection + m, and the
+    // landmarks of router r, in the order of RouterList, in the landmark sections + r.
+    enum ESnapshotSection : uint32_t {ParametersSection, CountsSection, VertexNodeIDsSection, VertexLocationsSection, SortedNodeIDsSection,
+                                      EdgeOffsetsSection, EdgeTargetsSection, RideVertexOffsetsSection, RideVertexIDsSection,
+                                      TransitStopNodeIDsSection, TransitStopVertexIDsSection, TransitRouteOffsetsSection, TransitRouteStopsSection,
+                                      TransitRideTimesSection, TransferSourcesSection, TransferDestinationsSection, TransferTimesSection,
+                                      LandmarkCountsSection, EdgeWeightsSection = 32, LandmarksSection = 64, LandmarkFromSection = 80, LandmarkToSection = 96};
+
+    // Node of a planner loaded from a snapshot, which keeps the node locations but not their attributes
+    struct SSnapshotNode : public CStreetMap::SNode{
+        TNodeID DID;
+        CStreetMap::TLocation DLocation;
+
+        SSnapshotNode(TNodeID id, CStreetMap::TLocation location) : DID(id), DLocation(location){
+
+        }
+
+        TNodeID ID() const noexcept override{
+            return DID;
+        }
+
+        CStreetMap::TLocation Location() const noexcept override{
+            return DLocation;
+        }
+
+        std::size_t AttributeCount() const noexcept override{
+            return 0;
+        }
+
+        std::string GetAttributeKey(std::size_t) const noexcept override{
+            return std::string();
+        }
+
+        bool HasAttribute(const std::string &) const noexcept override{
+            return false;
+        }
+
+        std::string GetAttribute(const std::string &) const noexcept override{
+            return std::string();
+        }
+    };
+
+    // Landmarks used by the fastest path routers, whose time metrics make the straight line bound weak
+    static constexpr std::size_t FastestPathLandmarkCount = 8;
+
+    // Directs a Dijkstra router towards the destination using the straight line distance scaled
+    // by the lowest cost per mile the router's metric can reach, which never overestimates.
+    void SetDistanceHeuristic(std::shared_ptr< CPathRouter > router, double costpermile){
+        auto DijkstraRouter = std::dynamic_pointer_cast< CDijkstraPathRouter >(router);
+        if(DijkstraRouter){
+            DijkstraRouter->SetHeuristic([this, costpermile](CPathRouter::TVertexID vertex, CPathRouter::TVertexID dest){
+                return SGeographicUtils::HaversineDistanceInMiles(DVertexLocations[vertex], DVertexLocations[dest]) * costpermile;
+            });
+        }
+    }
+
+    // Requests ALT landmarks from a Dijkstra router unless its factory already chose a count.
+    void SetLandmarks(std::shared_ptr< CPathRouter > router, std::size_t count){
+        auto DijkstraRouter = std::dynamic_pointer_cast< CDijkstraPathRouter >(router);
+        if(DijkstraRouter && !DijkstraRouter->LandmarkCount()){
+            DijkstraRouter->SetLandmarkCount(count);
+        }
+    }
+
+    // Makes router search metric of graph. A Dijkstra router shares the graph if share is set, any
+    // other router, or any router of a graph that failed to freeze, is given the graph's vertices and
+    // the edges that metric has.
+    static void AttachRouter(std::shared_ptr< CPathRouter > router, std::shared_ptr< CMultiMetricGraph > graph, std::size_t metric, bool share){
+        auto DijkstraRouter = std::dynamic_pointer_cast< CDijkstraPathRouter >(router);
+        if(share && DijkstraRouter && DijkstraRouter->ShareGraph(graph, metric)){
+            return;
+        }
+        for(CPathRouter::TVertexID VertexID = 0; VertexID < graph->VertexCount(); VertexID++){
+            router->AddVertex(graph->GetVertexTag(VertexID));
+        }
+        graph->ForEachEdge(metric, [&](CPathRouter::TVertexID source, CPathRouter::TVertexID target, double weight){
+            router->AddEdge(source, target, weight);
+        });
+    }
+
+    // Speed in mph of an OSM maxspeed value. As in OSM, a bare number such as "40" is in km/h and
+    // only a value with an mph unit such as "25 mph" is in mph.
+    static double ParseSpeedLimit(const std::string &maxspeed, double defaultspeed){
+        try{
+            double Speed = std::stod(maxspeed);
+            if(maxspeed.find("mph") == std::string::npos){
+                Speed /= 1.609344;
+            }
+            return Speed > 0.0 ? Speed : defaultspeed;
+        }
+        catch(std::exception &){
+            return defaultspeed;
+        }
+    }
+
+    // Builds the stop pair index, stops that are unknown or whose node is not in the street map break
+    // the route's chain of stop pairs.
+    void IndexBusSystem(){
+        DStopPairRoutes.clear();
+        if(!DBusSystem){
+            return;
+        }
+        for(std::size_t RouteIndex = 0; RouteIndex < DBusSystem->RouteCount(); RouteIndex++){
+            auto Route = DBusSystem->RouteByIndex(RouteIndex);
+            std::shared_ptr< CStreetMap::SNode > PreviousNode;
+            for(std::size_t StopIndex = 0; StopIndex < Route->StopCount(); StopIndex++){
+                auto Stop = DBusSystem->StopByID(Route->GetStopID(StopIndex));
+                auto Node = Stop ? DStreetMap->NodeByID(Stop->NodeID()) : nullptr;
+                if(PreviousNode && Node){
+                    DStopPairRoutes[std::make_pair(PreviousNode->ID(), Node->ID())].push_back({RouteIndex, StopIndex - 1});
+                }
+                PreviousNode = Node;
+            }
+        }
+    }
+
+    // Seconds for a bus to drive along nodes, each street segment at the time in segmenttimes and any
+    // other hop at the default speed. NoPathExists if a node is not in the map.
+    double BusDrivingTime(const std::vector< TNodeID > &nodes, const TNodePairTimes &segmenttimes, double defaultspeed) const{
+        double Time = 0.0;
+        for(std::size_t Index = 1; Index < nodes.size(); Index++){
+            auto Search = segmenttimes.find(std::make_pair(nodes[Index - 1], nodes[Index]));
+            if(Search == segmenttimes.end()){
+                Search = segmenttimes.find(std::make_pair(nodes[Index], nodes[Index - 1]));
+            }
+            if(Search != segmenttimes.end()){
+                Time += Search->second;
+                continue;
+            }
+            auto PreviousNode = DStreetMap->NodeByID(nodes[Index - 1]);
+            auto Node = DStreetMap->NodeByID(nodes[Index]);
+            if(!PreviousNode || !Node){
+                return CPathRouter::NoPathExists;
+            }
+            Time += SGeographicUtils::HaversineDistanceInMiles(PreviousNode->Location(), Node->Location()) / defaultspeed * 3600;
+        }
+        return Time;
+    }
+
+    // Seconds to drive between every pair of consecutive stops. The drive follows the bus system's
+    // path between the stops, or the shortest street path when it has none, and is found once
+    // however many routes serve the stops.
+    TNodePairTimes FindRideTimes(const TNodePairTimes &segmenttimes, double defaultspeed) const{
+        TNodePairTimes RideTimes;
+        if(!DBusSystem){
+            return RideTimes;
+        }
+        std::unordered_map< std::pair< TNodeID, TNodeID >, std::shared_ptr< CBusSystem::SPath >, SNodePairHash > Paths;
+        for(std::size_t Index = 0; Index < DBusSystem->PathCount(); Index++){
+            auto Path = DBusSystem->PathByIndex(Index);
+            Paths[std::make_pair(Path->StartNodeID(), Path->EndNodeID())] = Path;
+        }
+        auto Workspace = DShortestPathRouter->CreateWorkspace();
+        std::vector< CPathRouter::TVertexID > StreetPath;
+        std::vector< TNodeID > Nodes;
+        for(auto &StopPair : DStopPairRoutes){
+            Nodes.clear();
+            auto PathSearch = Paths.find(StopPair.first);
+            if(PathSearch != Paths.end()){
+                for(std::size_t Index = 0; Index < PathSearch->second->NodeCount(); Index++){
+                    Nodes.push_back(PathSearch->second->GetNodeID(Index));
+                }
+            }
+            double RideTime = BusDrivingTime(Nodes, segmenttimes, defaultspeed);
+            if(Nodes.empty() || (RideTime == CPathRouter::NoPathExists)){
+                Nodes = {StopPair.first.first, StopPair.first.second};
+                auto Source = DNodeToVertexID.find(StopPair.first.first)->second;
+                auto Destination = DNodeToVertexID.find(StopPair.first.second)->second;
+                if(DShortestPathRouter->FindShortestPath(Source, Destination, StreetPath, *Workspace) != CPathRouter::NoPathExists){
+                    Nodes.clear();
+                    for(auto VertexID : StreetPath){
+                        Nodes.push_back(DVertexNodeIDs[VertexID]);
+                    }
+                }
+                RideTime = BusDrivingTime(Nodes, segmenttimes, defaultspeed);
+            }
+            RideTimes[StopPair.first] = RideTime;
+        }
+        return RideTimes;
+    }
+
+    // Adds the ride layer to the walk/bus metric of graph. Every stop of a route gets a ride vertex that is
+    // boarded from and alighted to the stop's street vertex in stoptime seconds, and consecutive ride
+    // vertices of a route are joined by the time to drive between the stops.
+    void AddRideLayer(CMultiMetricGraph &graph, const TNodePairTimes &ridetimes, double stoptime){
+        // Ride edges only have a walk/bus time
+        std::vector< double > Weights(graph.MetricCount(), CPathRouter::NoPathExists);
+        auto RideWeights = [&](double time) -> const std::vector< double > &{
+            Weights[WalkBusTimeMetric] = time;
+            return Weights;
+        };
+        DStreetVertexCount = DVertexLocations.size();
+        DRideVertexIDs.clear();
+        if(!DBusSystem){
+            return;
+        }
+        DRideVertexIDs.resize(DBusSystem->RouteCount());
+        for(std::size_t RouteIndex = 0; RouteIndex < DBusSystem->RouteCount(); RouteIndex++){
+            auto Route = DBusSystem->RouteByIndex(RouteIndex);
+            auto &RideVertexIDs = DRideVertexIDs[RouteIndex];
+            for(std::size_t StopIndex = 0; StopIndex < Route->StopCount(); StopIndex++){
+                auto Stop = DBusSystem->StopByID(Route->GetStopID(StopIndex));
+                auto Search = Stop ? DNodeToVertexID.find(Stop->NodeID()) : DNodeToVertexID.end();
+                if(Search == DNodeToVertexID.end()){
+                    RideVertexIDs.push_back(CPathRouter::InvalidVertexID);
+                    continue;
+                }
+                auto RideVertexID = graph.AddVertex(Stop->NodeID());
+                DVertexLocations.push_back(DVertexLocations[Search->second]);
+                DVertexNodeIDs.push_back(Stop->NodeID());
+                graph.AddEdge(Search->second, RideVertexID, RideWeights(stoptime));
+                graph.AddEdge(RideVertexID, Search->second, RideWeights(stoptime));
+                RideVertexIDs.push_back(RideVertexID);
+            }
+        }
+        for(auto &StopPair : DStopPairRoutes){
+            double RideTime = ridetimes.find(StopPair.first)->second;
+            for(auto &RouteStop : StopPair.second){
+                auto &RideVertexIDs = DRideVertexIDs[RouteStop.DRoute];
+                graph.AddEdge(RideVertexIDs[RouteStop.DIndex], RideVertexIDs[RouteStop.DIndex + 1], RideWeights(RideTime));
+            }
+        }
+    }
+
+    // Builds the RAPTOR engine over the stop nodes. Each bus route becomes one RAPTOR route per run
+    // of consecutive stops in the map, and a stop can transfer to the stops within
+    // MaxTransferWalkTime seconds of walking.
+    void BuildRaptorRouter(const TNodePairTimes &ridetimes, double stoptime){
+        std::unordered_map< TNodeID, CRaptorRouter::TStopIndex > StopIndices;
+        auto StopIndex = [&](TNodeID nodeid){
+            auto Search = StopIndices.find(nodeid);
+            if(Search != StopIndices.end()){
+                return Search->second;
+            }
+            StopIndices[nodeid] = DTransitStopNodeIDs.size();
+            DTransitStopNodeIDs.push_back(nodeid);
+            DTransitStopVertexIDs.push_back(DNodeToVertexID.find(nodeid)->second);
+            return DTransitStopNodeIDs.size() - 1;
+        };
+        auto &Routes = DTransitRoutes;
+        for(std::size_t RouteIndex = 0; DBusSystem && (RouteIndex < DBusSystem->RouteCount()); RouteIndex++){
+            auto Route = DBusSystem->RouteByIndex(RouteIndex);
+            CRaptorRouter::SRoute Run;
+            TNodeID PreviousNodeID = CStreetMap::InvalidNodeID;
+            for(std::size_t Index = 0; Index <= Route->StopCount(); Index++){
+                auto Stop = Index < Route->StopCount() ? DBusSystem->StopByID(Route->GetStopID(Index)) : nullptr;
+                auto NodeID = Stop ? Stop->NodeID() : CStreetMap::InvalidNodeID;
+                auto Search = ridetimes.find(std::make_pair(PreviousNodeID, NodeID));
+                if(Search != ridetimes.end()){
+                    if(Run.DStops.empty()){
+                        Run.DStops.push_back(StopIndex(PreviousNodeID));
+                    }
+                    Run.DStops.push_back(StopIndex(NodeID));
+                    Run.DRideTimes.push_back(Search->second);
+                }
+                else if(!Run.DStops.empty()){
+                    Routes.push_back(Run);
+                    Run = CRaptorRouter::SRoute();
+                }
+                PreviousNodeID = NodeID;
+            }
+        }
+        auto &Transfers = DTransfers;
+        auto Workspace = DWalkRouter->CreateWorkspace();
+        for(std::size_t Source = 0; Source < DTransitStopVertexIDs.size(); Source++){
+            for(auto &Reached : DWalkRouter->FindVerticesWithin(DTransitStopVertexIDs[Source], MaxTransferWalkTime, *Workspace)){
+                auto Search = StopIndices.find(DVertexNodeIDs[Reached.first]);
+                if((Search != StopIndices.end()) && (Search->second != Source)){
+                    Transfers.push_back({Source, Search->second, Reached.second});
+                }
+            }
+        }
+        DRaptorRouter = std::make_unique< CRaptorRouter >(DTransitStopNodeIDs.size(), Routes, Transfers, stoptime, stoptime);
+        IndexTransitStops();
+    }
+
+    void IndexTransitStops() {
+        DVertexStopIndices.assign(DStreetVertexCount, CRaptorRouter::InvalidIndex);
+        for (std::size_t Stop = 0; Stop < DTransitStopVertexIDs.size(); Stop++) {
+            DVertexStopIndices[DTransitStopVertexIDs[Stop]] = Stop;
+        }
+    }
+
+    // Creates the routers, the graph is then built from the configuration or loaded from a snapshot
+    SImplementation(TRouterFactory routerfactory, ETransitEngine transitengine) {
+        if(!routerfactory){
+            routerfactory = [](){ return std::make_shared<CDijkstraPathRouter>(); };
+        }
+        DTransitEngine = transitengine;
+        DShortestPathRouter = routerfactory();
+        DFastestPathRouterBike = routerfactory();
+        DFastestPathRouterWalkBus = routerfactory();
+        if(DTransitEngine == ETransitEngine::Raptor){
+            DWalkRouter = routerfactory();
+            DReverseWalkRouter = routerfactory();
+        }
+    }
+
+    SImplementation(std::shared_ptr<SConfiguration> config, TRouterFactory routerfactory, ETransitEngine transitengine) : SImplementation(routerfactory, transitengine) {
+        auto PrecomputeDeadline = std::chrono::steady_clock::now();
         if (config) {
             DStreetMap = config->StreetMap();
             DBusSystem = config->BusSystem();
-            double WalkSpeed = config->WalkSpeed();
-            double BikeSpeed = config->BikeSpeed();
-            double DefaultSpeedLimit = config->DefaultSpeedLimit();
-            double BusStopTime = config->BusStopTime();
-            int PrecomputeTime = config->PrecomputeTime();
+            PrecomputeDeadline += std::chrono::seconds(config->PrecomputeTime());
         }
 
-        double BusSpeed = config ? config->DefaultSpeedLimit() : 0;
-        double WalkSpeed = config ? config->WalkSpeed() : 0;
-        double BikeSpeed = config ? config->BikeSpeed() : 0;
+        DDefaultSpeedLimit = config ? config->DefaultSpeedLimit() : 0;
+        DWalkSpeed = config ? config->WalkSpeed() : 0;
+        DBikeSpeed = config ? config->BikeSpeed() : 0;
+        DBusStopTime = config ? config->BusStopTime() : 0;
+        double BusSpeed = DDefaultSpeedLimit;
+        // Bus driving time of every street segment a bus may drive along, and the fastest speed limit
+        TNodePairTimes BusSegmentTimes;
+        DMaxBusSpeed = BusSpeed;
 
         for (size_t Index = 0; Index < DStreetMap->NodeCount(); ++Index) {
             auto Node = DStreetMap->NodeByIndex(Index);
@@ -38,19 +422,24 @@ struct CDijkstraTransportationPlanner::SImplementation{
         // Sort the node IDs
         std::sort(SortedNodeIDs.begin(), SortedNodeIDs.end());
 
+        // The street topology is stored once, each edge carries its distance and travel times
+        DGraph = std::make_shared< CMultiMetricGraph >(GraphMetricCount());
+        std::vector< double > Weights(DGraph->MetricCount());
         for (size_t Index = 0; Index < DStreetMap->NodeCount(); Index++) {
             auto Node = DStreetMap->NodeByIndex(Index);
-            auto VertexID = DShortestPathRouter.AddVertex(Node->ID());
-            DFastestPathRouterBike.AddVertex(Node->ID());
-            DFastestPathRouterWalkBus.AddVertex(Node->ID());
+            auto VertexID = DGraph->AddVertex(Node->ID());
             DNodeToVertexID[Node->ID()] = VertexID;
+            DVertexLocations.push_back(Node->Location());
+            DVertexNodeIDs.push_back(Node->ID());
         }
+        IndexBusSystem();
 
         for (size_t Index = 0; Index < DStreetMap->WayCount(); Index++) {
             auto Way = DStreetMap->WayByIndex(Index);
             bool Bikable = Way->GetAttribute("bicycle") != "no";
             bool Bidirectional = Way->GetAttribute("oneway") != "yes";
-            auto PreviousNodeID = Way->GetNodeID(0);
+            double WaySpeed = Way->HasAttribute("maxspeed") ? ParseSpeedLimit(Way->GetAttribute("maxspeed"), BusSpeed) : BusSpeed;
+            DMaxBusSpeed = std::max(DMaxBusSpeed, WaySpeed);
 
             for (size_t NodeIndex = 1; NodeIndex < Way->NodeCount(); NodeIndex++) {
                 auto PreviousNodeID = Way->GetNodeID(NodeIndex - 1);
@@ -63,161 +452,680 @@ struct CDijkstraTransportationPlanner::SImplementation{
                 auto PreviousVertexID = DNodeToVertexID[PreviousNodeID];
                 auto NextVertexID = DNodeToVertexID[NextNodeID];
 
-                double TimeBike = Bikable ? (Distance / BikeSpeed * 3600) : CPathRouter::NoPathExists; // Time in seconds
-                double TimeWalk = Distance * 1609.34 / WalkSpeed; // Time in seconds assuming WalkSpeed is in m/s
-                double TimeBus = Distance / BusSpeed * 3600; // Time in seconds assuming BusSpeed is in mph
-
-                // Add edges for shortest path calculation
-                DShortestPathRouter.AddEdge(PreviousVertexID, NextVertexID, Distance, Bidirectional);
+                double TimeBike = Bikable ? (Distance / DBikeSpeed * 3600) : CPathRouter::NoPathExists; // Time in seconds
+                double TimeWalk = Distance * 1609.34 / DWalkSpeed; // Time in seconds assuming WalkSpeed is in m/s
 
-                // Add edges for fastest bike path calculation, if bikable
-                if (Bikable && TimeBike != CPathRouter::NoPathExists) {
-                    DFastestPathRouterBike.AddEdge(PreviousVertexID, NextVertexID, TimeBike, Bidirectional);
+                // The walk/bus metric holds the street layer of the walk/bus router, buses drive it in
+                // the way's direction. A oneway segment gets a second edge walked only on the reversed streets.
+                Weights[DistanceMetric] = Distance;
+                Weights[BikeTimeMetric] = TimeBike;
+                Weights[WalkBusTimeMetric] = TimeWalk;
+                if (DWalkRouter) {
+                    Weights[WalkTimeMetric] = TimeWalk;
+                    Weights[ReverseWalkTimeMetric] = Bidirectional ? TimeWalk : CPathRouter::NoPathExists;
                 }
+                DGraph->AddEdge(PreviousVertexID, NextVertexID, Weights, Bidirectional);
+                if (DWalkRouter && !Bidirectional) {
+                    std::vector< double > ReverseWeights(DGraph->MetricCount(), CPathRouter::NoPathExists);
+                    ReverseWeights[ReverseWalkTimeMetric] = TimeWalk;
+                    DGraph->AddEdge(NextVertexID, PreviousVertexID, ReverseWeights);
+                }
+                BusSegmentTimes[std::make_pair(PreviousNodeID, NextNodeID)] = Distance / WaySpeed * 3600;
+                if (Bidirectional) {
+                    BusSegmentTimes[std::make_pair(NextNodeID, PreviousNodeID)] = Distance / WaySpeed * 3600;
+                }
+            }
+        }
 
-                // Add edges for fastest walk/bus path calculation
-                double TimeWalkBus = TimeWalk; // Initial walking time
-if (DBusSystem->StopByID(PreviousNodeID) != nullptr && DBusSystem->StopByID(NextNodeID) != nullptr) {
-    // Check if there is a direct bus route between the two stops
-    for (size_t RouteIndex = 0; RouteIndex < DBusSystem->RouteCount(); ++RouteIndex) {
-        auto Route = DBusSystem->RouteByIndex(RouteIndex);
-        bool PrevStopFound = false;
-        bool NextStopFound = false;
-        for (size_t StopIndex = 0; StopIndex < Route->StopCount(); ++StopIndex) {
-            auto StopID = Route->GetStopID(StopIndex);
-            if (StopID == PreviousNodeID) {
-                PrevStopFound = true;
-            } else if (StopID == NextNodeID) {
-                NextStopFound = true;
-            }
-            if (PrevStopFound && NextStopFound) {
-                // Calculate the bus travel time between the two stops
-                double BusDistance = 0.0;
-                for (size_t i = 0; i < Route->StopCount() - 1; ++i) {
-                    auto Stop1 = DBusSystem->StopByID(Route->GetStopID(i));
-                    auto Stop2 = DBusSystem->StopByID(Route->GetStopID(i + 1));
-
-                    // Assuming we can get corresponding street map nodes for these bus stops
-                    auto Node1 = DStreetMap->NodeByID(Stop1->NodeID()); // Assuming Stop objects have a NodeID() method
-                    auto Node2 = DStreetMap->NodeByID(Stop2->NodeID());
-
-                    if (Node1 && Node2) {
-                        double SegmentDistance = SGeographicUtils::HaversineDistanceInMiles(Node1->Location(), Node2->Location());
-                        BusDistance += SegmentDistance;
-                    }
+        // The ride times follow shortest street paths, so the shortest path router is attached before
+        // the ride layer is added and the other routers after. A graph too large to freeze cannot be
+        // shared, so its edges are copied into each router instead.
+        auto Frozen = DGraph->Freeze();
+        AttachRouter(DShortestPathRouter, DGraph, DistanceMetric, Frozen);
+        SetDistanceHeuristic(DShortestPathRouter, 1.0);
+        auto RideTimes = FindRideTimes(BusSegmentTimes, BusSpeed);
+        AddRideLayer(*DGraph, RideTimes, DBusStopTime);
+        if (!DGraph->Freeze()) {
+            // The ride layer left the graph too large to freeze, so the shortest path router can no
+            // longer share it and is rebuilt from a copy
+            Frozen = false;
+            DShortestPathRouter = routerfactory ? routerfactory() : std::make_shared<CDijkstraPathRouter>();
+            AttachRouter(DShortestPathRouter, DGraph, DistanceMetric, Frozen);
+            SetDistanceHeuristic(DShortestPathRouter, 1.0);
+        }
+        AttachRouter(DFastestPathRouterBike, DGraph, BikeTimeMetric, Frozen);
+        AttachRouter(DFastestPathRouterWalkBus, DGraph, WalkBusTimeMetric, Frozen);
+        if (DWalkRouter) {
+            AttachRouter(DWalkRouter, DGraph, WalkTimeMetric, Frozen);
+            AttachRouter(DReverseWalkRouter, DGraph, ReverseWalkTimeMetric, Frozen);
+            BuildRaptorRouter(RideTimes, DBusStopTime);
+        }
+        FinishRouters(PrecomputeDeadline);
+    }
+
+    // Metrics the graph has for the transit engine
+    std::size_t GraphMetricCount() const {
+        return DWalkRouter ? std::size_t(MetricCount) : std::size_t(WalkTimeMetric);
+    }
+
+    // The routers in the order their landmarks are saved, the walking routers are null without RAPTOR
+    std::vector< std::shared_ptr< CPathRouter > > RouterList() const {
+        return {DShortestPathRouter, DFastestPathRouterBike, DFastestPathRouterWalkBus, DWalkRouter, DReverseWalkRouter};
+    }
+
+    // Gives the routers their heuristics and landmarks and lets them build their query structures
+    // within the precompute budget. Landmarks saved in snapshot are restored into Dijkstra routers
+    // that request as many, so they are not selected again.
+    void FinishRouters(std::chrono::steady_clock::time_point deadline, const CGraphSnapshot *snapshot = nullptr) {
+        SetDistanceHeuristic(DShortestPathRouter, 1.0);
+        SetDistanceHeuristic(DFastestPathRouterBike, 3600.0 / DBikeSpeed);
+        SetDistanceHeuristic(DFastestPathRouterWalkBus, std::min(1609.34 / DWalkSpeed, 3600.0 / DMaxBusSpeed));
+        SetLandmarks(DFastestPathRouterBike, FastestPathLandmarkCount);
+        SetLandmarks(DFastestPathRouterWalkBus, FastestPathLandmarkCount);
+        if (DWalkRouter) {
+            SetDistanceHeuristic(DWalkRouter, 1609.34 / DWalkSpeed);
+        }
+
+        std::vector< uint64_t > LandmarkCounts;
+        if (snapshot && snapshot->Read(LandmarkCountsSection, LandmarkCounts)) {
+            auto Routers = RouterList();
+            for (std::size_t Index = 0; (Index < Routers.size()) && (Index < LandmarkCounts.size()); Index++) {
+                auto DijkstraRouter = std::dynamic_pointer_cast< CDijkstraPathRouter >(Routers[Index]);
+                std::vector< CPathRouter::TVertexID > Landmarks;
+                std::vector< double > From, To;
+                if (DijkstraRouter && (DijkstraRouter->LandmarkCount() == LandmarkCounts[Index]) && snapshot->Read(LandmarksSection + Index, Landmarks) && snapshot->Read(LandmarkFromSection + Index, From) && snapshot->Read(LandmarkToSection + Index, To)) {
+                    DijkstraRouter->SetLandmarkTables(std::move(Landmarks), std::move(From), std::move(To));
                 }
+            }
+        }
 
-                double BusSpeed = config->DefaultSpeedLimit();
-                double TimeBus = (BusDistance / BusSpeed * 3600) + (Route->StopCount() - 1) * config->BusStopTime(); // Time in seconds
-                TimeWalkBus = std::min(TimeWalkBus, TimeBus + 2 * config->BusStopTime()); // Account for walking time to/from bus stops
-                break;
+        for (auto &Router : RouterList()) {
+            if (Router) {
+                Router->Precompute(deadline);
             }
         }
     }
-}
-DFastestPathRouterWalkBus.AddEdge(PreviousVertexID, NextVertexID, TimeWalkBus, Bidirectional);
+
+    // Writes the built graph, its vertex tables, the transit routes and the selected landmarks
+    bool SaveSnapshot(const std::string &path, uint64_t sourcekey) const {
+        if (!DGraph->Frozen()) {
+            return false; // Only the frozen arrays can be saved
+        }
+        CGraphSnapshot::CWriter Writer;
+        Writer.Add(ParametersSection, std::vector< double >{DWalkSpeed, DBikeSpeed, DDefaultSpeedLimit, DBusStopTime, DMaxBusSpeed});
+        Writer.Add(CountsSection, std::vector< uint64_t >{uint64_t(DTransitEngine), DGraph->MetricCount(), DStreetVertexCount});
+        Writer.Add(VertexNodeIDsSection, DVertexNodeIDs);
+        std::vector< double > Locations;
+        for (auto &Location : DVertexLocations) {
+            Locations.push_back(Location.first);
+            Locations.push_back(Location.second);
+        }
+        Writer.Add(VertexLocationsSection, Locations);
+        Writer.Add(SortedNodeIDsSection, SortedNodeIDs);
+        Writer.Add(EdgeOffsetsSection, DGraph->EdgeOffsets());
+        Writer.Add(EdgeTargetsSection, DGraph->EdgeTargets());
+        for (std::size_t Metric = 0; Metric < DGraph->MetricCount(); Metric++) {
+            Writer.Add(EdgeWeightsSection + Metric, DGraph->EdgeWeights(Metric));
+        }
+        std::vector< std::size_t > RideVertexOffsets{0};
+        std::vector< CPathRouter::TVertexID > RideVertexIDs;
+        for (auto &RouteVertexIDs : DRideVertexIDs) {
+            RideVertexIDs.insert(RideVertexIDs.end(), RouteVertexIDs.begin(), RouteVertexIDs.end());
+            RideVertexOffsets.push_back(RideVertexIDs.size());
+        }
+        Writer.Add(RideVertexOffsetsSection, RideVertexOffsets);
+        Writer.Add(RideVertexIDsSection, RideVertexIDs);
+        if (DRaptorRouter) {
+            std::vector< std::size_t > RouteOffsets{0};
+            std::vector< CRaptorRouter::TStopIndex > RouteStops;
+            std::vector< double > RideTimes;
+            for (auto &Route : DTransitRoutes) {
+                RouteStops.insert(RouteStops.end(), Route.DStops.begin(), Route.DStops.end());
+                RideTimes.insert(RideTimes.end(), Route.DRideTimes.begin(), Route.DRideTimes.end());
+                RouteOffsets.push_back(RouteStops.size());
+            }
+            std::vector< CRaptorRouter::TStopIndex > TransferSources, TransferDestinations;
+            std::vector< double > TransferTimes;
+            for (auto &Transfer : DTransfers) {
+                TransferSources.push_back(Transfer.DSource);
+                TransferDestinations.push_back(Transfer.DDestination);
+                TransferTimes.push_back(Transfer.DTime);
+            }
+            Writer.Add(TransitStopNodeIDsSection, DTransitStopNodeIDs);
+            Writer.Add(TransitStopVertexIDsSection, DTransitStopVertexIDs);
+            Writer.Add(TransitRouteOffsetsSection, RouteOffsets);
+            Writer.Add(TransitRouteStopsSection, RouteStops);
+            Writer.Add(TransitRideTimesSection, RideTimes);
+            Writer.Add(TransferSourcesSection, TransferSources);
+            Writer.Add(TransferDestinationsSection, TransferDestinations);
+            Writer.Add(TransferTimesSection, TransferTimes);
+        }
+        auto Routers = RouterList();
+        std::vector< uint64_t > LandmarkCounts;
+        for (std::size_t Index = 0; Index < Routers.size(); Index++) {
+            auto DijkstraRouter = std::dynamic_pointer_cast< CDijkstraPathRouter >(Routers[Index]);
+            LandmarkCounts.push_back(DijkstraRouter ? DijkstraRouter->LandmarkCount() : 0);
+            if (DijkstraRouter && DijkstraRouter->SelectedLandmarkCount()) {
+                std::vector< CPathRouter::TVertexID > Landmarks;
+                std::vector< double > From, To;
+                DijkstraRouter->GetLandmarkTables(Landmarks, From, To);
+                Writer.Add(LandmarksSection + Index, Landmarks);
+                Writer.Add(LandmarkFromSection + Index, From);
+                Writer.Add(LandmarkToSection + Index, To);
+            }
+        }
+        Writer.Add(LandmarkCountsSection, LandmarkCounts);
+        return Writer.Write(path, sourcekey);
+    }
+
+    // Restores the planner from a snapshot saved with the same transit engine and speeds. Fails if it
+    // was saved otherwise or its sections do not fit together.
+    bool LoadSnapshot(const CGraphSnapshot &snapshot, std::shared_ptr<SConfiguration> config) {
+        auto PrecomputeDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(config->PrecomputeTime());
+        std::vector< double > Parameters;
+        std::vector< uint64_t > Counts;
+        if (!snapshot.Read(ParametersSection, Parameters) || (Parameters.size() != 5) || !snapshot.Read(CountsSection, Counts) || (Counts.size() != 3)) {
+            return false;
+        }
+        if ((Parameters[0] != config->WalkSpeed()) || (Parameters[1] != config->BikeSpeed()) || (Parameters[2] != config->DefaultSpeedLimit()) || (Parameters[3] != config->BusStopTime())) {
+            return false;
+        }
+        if ((Counts[0] != uint64_t(DTransitEngine)) || (Counts[1] != GraphMetricCount())) {
+            return false;
+        }
+        DWalkSpeed = Parameters[0];
+        DBikeSpeed = Parameters[1];
+        DDefaultSpeedLimit = Parameters[2];
+        DBusStopTime = Parameters[3];
+        DMaxBusSpeed = Parameters[4];
+        DStreetVertexCount = Counts[2];
+
+        std::vector< double > Locations;
+        if (!snapshot.Read(VertexNodeIDsSection, DVertexNodeIDs) || !snapshot.Read(VertexLocationsSection, Locations) || !snapshot.Read(SortedNodeIDsSection, SortedNodeIDs)) {
+            return false;
+        }
+        if ((Locations.size() != 2 * DVertexNodeIDs.size()) || (DVertexNodeIDs.size() < DStreetVertexCount) || (SortedNodeIDs.size() != DStreetVertexCount)) {
+            return false;
+        }
+        for (std::size_t Index = 0; Index < DVertexNodeIDs.size(); Index++) {
+            DVertexLocations.push_back(std::make_pair(Locations[2 * Index], Locations[2 * Index + 1]));
+        }
+        for (CPathRouter::TVertexID VertexID = 0; VertexID < DStreetVertexCount; VertexID++) {
+            DNodeToVertexID[DVertexNodeIDs[VertexID]] = VertexID;
+        }
+
+        std::vector< CMultiMetricGraph::TCompactIndex > Offsets, Targets;
+        std::vector< std::vector< double > > Weights(GraphMetricCount());
+        if (!snapshot.Read(EdgeOffsetsSection, Offsets) || !snapshot.Read(EdgeTargetsSection, Targets)) {
+            return false;
+        }
+        for (std::size_t Metric = 0; Metric < Weights.size(); Metric++) {
+            if (!snapshot.Read(EdgeWeightsSection + Metric, Weights[Metric])) {
+                return false;
+            }
+        }
+        DGraph = std::make_shared< CMultiMetricGraph >(GraphMetricCount());
+        if (!DGraph->Assign(std::vector< std::any >(DVertexNodeIDs.begin(), DVertexNodeIDs.end()), std::move(Offsets), std::move(Targets), std::move(Weights))) {
+            return false;
+        }
+
+        std::vector< std::size_t > RideVertexOffsets;
+        std::vector< CPathRouter::TVertexID > RideVertexIDs;
+        if (!snapshot.Read(RideVertexOffsetsSection, RideVertexOffsets) || !snapshot.Read(RideVertexIDsSection, RideVertexIDs) || RideVertexOffsets.empty() || (RideVertexOffsets.back() != RideVertexIDs.size())) {
+            return false;
+        }
+        for (std::size_t Index = 1; Index < RideVertexOffsets.size(); Index++) {
+            if (RideVertexOffsets[Index] < RideVertexOffsets[Index - 1]) {
+                return false;
+            }
+            DRideVertexIDs.emplace_back(RideVertexIDs.begin() + RideVertexOffsets[Index - 1], RideVertexIDs.begin() + RideVertexOffsets[Index]);
+        }
+
+        // Assign leaves the graph frozen
+        AttachRouter(DShortestPathRouter, DGraph, DistanceMetric, true);
+        AttachRouter(DFastestPathRouterBike, DGraph, BikeTimeMetric, true);
+        AttachRouter(DFastestPathRouterWalkBus, DGraph, WalkBusTimeMetric, true);
+        if (DWalkRouter) {
+            AttachRouter(DWalkRouter, DGraph, WalkTimeMetric, true);
+            AttachRouter(DReverseWalkRouter, DGraph, ReverseWalkTimeMetric, true);
+            if (!LoadRaptorRouter(snapshot)) {
+                return false;
             }
         }
+        FinishRouters(PrecomputeDeadline, &snapshot);
+        return true;
+    }
+
+    // Rebuilds the RAPTOR engine from the stops, routes and transfers saved in snapshot
+    bool LoadRaptorRouter(const CGraphSnapshot &snapshot) {
+        std::vector< std::size_t > RouteOffsets;
+        std::vector< CRaptorRouter::TStopIndex > RouteStops, TransferSources, TransferDestinations;
+        std::vector< double > RideTimes, TransferTimes;
+        if (!snapshot.Read(TransitStopNodeIDsSection, DTransitStopNodeIDs) || !snapshot.Read(TransitStopVertexIDsSection, DTransitStopVertexIDs) || !snapshot.Read(TransitRouteOffsetsSection, RouteOffsets) || !snapshot.Read(TransitRouteStopsSection, RouteStops) || !snapshot.Read(TransitRideTimesSection, RideTimes)) {
+            return false;
+        }
+        if (!snapshot.Read(TransferSourcesSection, TransferSources) || !snapshot.Read(TransferDestinationsSection, TransferDestinations) || !snapshot.Read(TransferTimesSection, TransferTimes)) {
+            return false;
+        }
+        auto StopCount = DTransitStopNodeIDs.size();
+        if ((DTransitStopVertexIDs.size() != StopCount) || RouteOffsets.empty() || (RouteOffsets.back() != RouteStops.size()) || (TransferDestinations.size() != TransferSources.size()) || (TransferTimes.size() != TransferSources.size())) {
+            return false;
+        }
+        for (auto VertexID : DTransitStopVertexIDs) {
+            if (DStreetVertexCount <= VertexID) {
+                return false;
+            }
+        }
+        // Each route has one ride time fewer than it has stops
+        std::size_t RideTimeIndex = 0;
+        for (std::size_t Index = 1; Index < RouteOffsets.size(); Index++) {
+            if ((RouteOffsets[Index] < RouteOffsets[Index - 1] + 2) || (RideTimes.size() < RideTimeIndex + RouteOffsets[Index] - RouteOffsets[Index - 1] - 1)) {
+                return false;
+            }
+            CRaptorRouter::SRoute Route;
+            Route.DStops.assign(RouteStops.begin() + RouteOffsets[Index - 1], RouteStops.begin() + RouteOffsets[Index]);
+            Route.DRideTimes.assign(RideTimes.begin() + RideTimeIndex, RideTimes.begin() + RideTimeIndex + Route.DStops.size() - 1);
+            RideTimeIndex += Route.DRideTimes.size();
+            for (auto Stop : Route.DStops) {
+                if (StopCount <= Stop) {
+                    return false;
+                }
+            }
+            DTransitRoutes.push_back(std::move(Route));
+        }
+        for (std::size_t Index = 0; Index < TransferSources.size(); Index++) {
+            if ((StopCount <= TransferSources[Index]) || (StopCount <= TransferDestinations[Index])) {
+                return false;
+            }
+            DTransfers.push_back({TransferSources[Index], TransferDestinations[Index], TransferTimes[Index]});
+        }
+        if (RideTimeIndex != RideTimes.size()) {
+            return false;
+        }
+        DRaptorRouter = std::make_unique< CRaptorRouter >(StopCount, DTransitRoutes, DTransfers, DBusStopTime, DBusStopTime);
+        IndexTransitStops();
+        return true;
     }
 
     std::size_t NodeCount() const noexcept {
-        return DStreetMap->NodeCount();
+        return SortedNodeIDs.size();
     }
     std::shared_ptr<CStreetMap::SNode> SortedNodeByIndex(std::size_t index) const noexcept {
         if (index >= NodeCount()) {
             return nullptr;
         }
         TNodeID nodeId = SortedNodeIDs[index];
-        return DStreetMap->NodeByID(nodeId);
+        if (DStreetMap) {
+            return DStreetMap->NodeByID(nodeId);
+        }
+        return std::make_shared< SSnapshotNode >(nodeId, DVertexLocations[DNodeToVertexID.find(nodeId)->second]);
+    }
+
+    // Location of a node in the map, false if it is not in the map
+    bool NodeLocation(TNodeID node, CStreetMap::TLocation &location) const {
+        auto Search = DNodeToVertexID.find(node);
+        if (Search == DNodeToVertexID.end()) {
+            return false;
+        }
+        location = DVertexLocations[Search->second];
+        return true;
+    }
+
+    std::unique_ptr< SQueryContext > CreateQueryContext() const {
+        auto Context = std::make_unique< SContext >();
+        Context->DShortestWorkspace = DShortestPathRouter->CreateWorkspace();
+        Context->DBikeWorkspace = DFastestPathRouterBike->CreateWorkspace();
+        Context->DWalkBusWorkspace = DFastestPathRouterWalkBus->CreateWorkspace();
+        if (DRaptorRouter) {
+            Context->DWalkWorkspace = DWalkRouter->CreateWorkspace();
+            Context->DReverseWalkWorkspace = DReverseWalkRouter->CreateWorkspace();
+            Context->DRaptorWorkspace = DRaptorRouter->CreateWorkspace();
+        }
+        return Context;
+    }
+
+    // The context as created by this planner, another planner's context is a caller error
+    static SContext &QueryContext(SQueryContext &context) {
+        auto Context = dynamic_cast< SContext * >(&context);
+        if (!Context) {
+            throw std::invalid_argument("CDijkstraTransportationPlanner: query context was created by another planner");
+        }
+        return *Context;
+    }
+
+    // Returns the context of the non-const queries, created on first use
+    SQueryContext &OwnQueryContext() {
+        if (!DQueryContext) {
+            DQueryContext = CreateQueryContext();
+        }
+        return *DQueryContext;
+    }
+
+    // Looks up the router vertices of two nodes without modifying the map
+    bool FindVertexIDs(TNodeID src, TNodeID dest, CPathRouter::TVertexID &srcvertex, CPathRouter::TVertexID &destvertex) const {
+        auto SourceSearch = DNodeToVertexID.find(src);
+        auto DestinationSearch = DNodeToVertexID.find(dest);
+        if (SourceSearch == DNodeToVertexID.end() || DestinationSearch == DNodeToVertexID.end()) {
+            return false;
+        }
+        srcvertex = SourceSearch->second;
+        destvertex = DestinationSearch->second;
+        return true;
+    }
+
+    double FindShortestPath(TNodeID src, TNodeID dest, std::vector<TNodeID>& path, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        CPathCache::SEntry Entry;
+        CPathCache::SKey Key{src, dest, CPathCache::EMetric::Distance};
+        if (DPathCache && DPathCache->Find(Key, Entry)) {
+            if (Entry.DCost != CPathRouter::NoPathExists) {
+                path = std::move(Entry.DNodes);
+            }
+            return Entry.DCost;
+        }
+        auto Distance = FindShortestPathUncached(src, dest, path, Context);
+        if (DPathCache) {
+            Entry.DCost = Distance;
+            if (Distance != CPathRouter::NoPathExists) {
+                Entry.DNodes = path;
+            }
+            DPathCache->Insert(Key, std::move(Entry));
+        }
+        return Distance;
     }
 
-    double FindShortestPath(TNodeID src, TNodeID dest, std::vector<TNodeID>& path) {
-        auto srcVertexIt = DNodeToVertexID.find(src);
-        auto destVertexIt = DNodeToVertexID.find(dest);
-        if (srcVertexIt == DNodeToVertexID.end() || destVertexIt == DNodeToVertexID.end()) {
+    // The queries themselves, FindShortestPath and FindFastestPath look them up in the path cache first
+    double FindShortestPathUncached(TNodeID src, TNodeID dest, std::vector<TNodeID>& path, SContext &context) const {
+        CPathRouter::TVertexID SourceVertexID, DestinationVertexID;
+        if (!FindVertexIDs(src, dest, SourceVertexID, DestinationVertexID)) {
             return CPathRouter::NoPathExists;
         }
-        std::vector<CPathRouter::TVertexID> ShortestPath;
-        auto SourceVertexID = srcVertexIt->second;
-        auto DestinationVertexID = destVertexIt->second;
-        auto Distance = DShortestPathRouter.FindShortestPath(SourceVertexID, DestinationVertexID, ShortestPath);
+        auto &ShortestPath = context.DRouterPath;
+        auto Distance = DShortestPathRouter->FindShortestPath(SourceVertexID, DestinationVertexID, ShortestPath, *context.DShortestWorkspace);
         if (Distance != CPathRouter::NoPathExists) {
             path.clear();
             for (auto vertexID : ShortestPath) {
-                path.push_back(std::any_cast<TNodeID>(DShortestPathRouter.GetVertexTag(vertexID)));
+                path.push_back(DVertexNodeIDs[vertexID]);
             }
         }
         return Distance;
     }
 
-    double FindFastestPath(TNodeID src, TNodeID dest, std::vector<TTripStep>& path) {
-        std::vector<CPathRouter::TVertexID> FastestPath;
-        auto SourceVertexID = DNodeToVertexID[src];
-        auto DestinationVertexID = DNodeToVertexID[dest];
+    double FindFastestPath(TNodeID src, TNodeID dest, std::vector<TTripStep>& path, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        CPathCache::SEntry Entry;
+        CPathCache::SKey Key{src, dest, CPathCache::EMetric::Time};
+        if (DPathCache && DPathCache->Find(Key, Entry)) {
+            if (Entry.DCost != CPathRouter::NoPathExists) {
+                path = std::move(Entry.DSteps);
+            }
+            return Entry.DCost;
+        }
+        auto Duration = FindFastestPathUncached(src, dest, path, Context);
+        if (DPathCache) {
+            Entry.DCost = Duration;
+            if (Duration != CPathRouter::NoPathExists) {
+                Entry.DSteps = path;
+            }
+            DPathCache->Insert(Key, std::move(Entry));
+        }
+        return Duration;
+    }
 
-        // Find the fastest path using bike
-        auto BikeDuration = DFastestPathRouterBike.FindShortestPath(SourceVertexID, DestinationVertexID, FastestPath);
+    double FindFastestPathUncached(TNodeID src, TNodeID dest, std::vector<TTripStep>& path, SContext &context) const {
+        CPathRouter::TVertexID SourceVertexID, DestinationVertexID;
+        if (!FindVertexIDs(src, dest, SourceVertexID, DestinationVertexID)) {
+            return CPathRouter::NoPathExists;
+        }
+        auto &FastestPath = context.DRouterPath;
+
+        // The trip is the faster of the bike trip and the walk/bus trip, biking on a tie
+        auto BikeDuration = DFastestPathRouterBike->FindShortestPath(SourceVertexID, DestinationVertexID, FastestPath, *context.DBikeWorkspace);
         if (BikeDuration != CPathRouter::NoPathExists) {
             path.clear();
             for (auto VertexID : FastestPath) {
-                auto NodeID = std::any_cast<TNodeID>(DFastestPathRouterBike.GetVertexTag(VertexID));
+                auto NodeID = DVertexNodeIDs[VertexID];
                 path.emplace_back(CTransportationPlanner::ETransportationMode::Bike, NodeID);
             }
-            return BikeDuration / 3600.0;
         }
+        auto &WalkBusSteps = context.DWalkBusSteps;
+        auto WalkBusDuration = DRaptorRouter ? FindRaptorPath(SourceVertexID, DestinationVertexID, WalkBusSteps, context) : FindWalkBusPath(SourceVertexID, DestinationVertexID, WalkBusSteps, context);
+        if (WalkBusDuration == CPathRouter::NoPathExists || (BikeDuration != CPathRouter::NoPathExists && BikeDuration <= WalkBusDuration)) {
+            return BikeDuration == CPathRouter::NoPathExists ? CPathRouter::NoPathExists : BikeDuration / 3600.0;
+        }
+        path.assign(WalkBusSteps.begin(), WalkBusSteps.end());
+        return WalkBusDuration / 3600.0; // Convert seconds to hours
+    }
+
+    // Fastest trip in seconds on the layered walk/bus router. Each step is the mode that reached its
+    // node: riding between ride vertices is by bus and moving between street vertices is walking,
+    // boarding and alighting stay at the stop.
+    double FindWalkBusPath(CPathRouter::TVertexID src, CPathRouter::TVertexID dest, std::vector<TTripStep>& steps, SContext &context) const {
+        auto &RouterPath = context.DRouterPath;
+        auto Duration = DFastestPathRouterWalkBus->FindShortestPath(src, dest, RouterPath, *context.DWalkBusWorkspace);
+        steps.clear();
+        if (Duration == CPathRouter::NoPathExists) {
+            return Duration;
+        }
+        steps.emplace_back(ETransportationMode::Walk, DVertexNodeIDs[src]);
+        for (std::size_t Index = 1; Index < RouterPath.size(); Index++) {
+            bool PreviousRide = RouterPath[Index - 1] >= DStreetVertexCount;
+            bool CurrentRide = RouterPath[Index] >= DStreetVertexCount;
+            if (PreviousRide == CurrentRide) {
+                auto NodeID = DVertexNodeIDs[RouterPath[Index]];
+                steps.emplace_back(CurrentRide ? ETransportationMode::Bus : ETransportationMode::Walk, NodeID);
+            }
+        }
+        return Duration;
+    }
+
+    // Appends the walk from src to dest, without src, to steps
+    void AppendWalk(CPathRouter::TVertexID src, CPathRouter::TVertexID dest, std::vector<TTripStep>& steps, SContext &context) const {
+        auto &RouterPath = context.DRouterPath;
+        if (src == dest || DWalkRouter->FindShortestPath(src, dest, RouterPath, *context.DWalkWorkspace) == CPathRouter::NoPathExists) {
+            return;
+        }
+        for (std::size_t Index = 1; Index < RouterPath.size(); Index++) {
+            steps.emplace_back(ETransportationMode::Walk, DVertexNodeIDs[RouterPath[Index]]);
+        }
+    }
 
-        // Find the fastest path using walk and bus
-        std::vector<CPathRouter::TVertexID> WalkBusPath;
-        auto WalkBusDuration = DFastestPathRouterWalkBus.FindShortestPath(SourceVertexID, DestinationVertexID, WalkBusPath);
-        if (WalkBusDuration != CPathRouter::NoPathExists) {
-            path.clear();
-            ETransportationMode PrevMode = ETransportationMode::Walk;
-            for (size_t i = 0; i < WalkBusPath.size(); ++i) {
-                auto VertexID = WalkBusPath[i];
-                auto NodeID = std::any_cast<TNodeID>(DFastestPathRouterWalkBus.GetVertexTag(VertexID));
-                auto Mode = ETransportationMode::Walk;
-
-                // Check if the current node is a bus stop
-                if (DBusSystem->StopByID(NodeID) != nullptr) {
-                    // Check if the next node is also a bus stop and there is a direct bus route between them
-                    if (i < WalkBusPath.size() - 1) {
-                        auto NextVertexID = WalkBusPath[i + 1];
-                        auto NextNodeID = std::any_cast<TNodeID>(DFastestPathRouterWalkBus.GetVertexTag(NextVertexID));
-                        if (DBusSystem->StopByID(NextNodeID) != nullptr) {
-                            for (size_t RouteIndex = 0; RouteIndex < DBusSystem->RouteCount(); ++RouteIndex) {
-                                auto Route = DBusSystem->RouteByIndex(RouteIndex);
-                                bool PrevStopFound = false;
-                                bool NextStopFound = false;
-                                for (size_t StopIndex = 0; StopIndex < Route->StopCount(); ++StopIndex) {
-                                    auto StopID = Route->GetStopID(StopIndex);
-                                    if (StopID == NodeID) {
-                                        PrevStopFound = true;
-                                    } else if (StopID == NextNodeID) {
-                                        NextStopFound = true;
-                                    }
-                                    if (PrevStopFound && NextStopFound) {
-                                        Mode = ETransportationMode::Bus;
-                                        break;
-                                    }
-                                }
-                                if (Mode == ETransportationMode::Bus) {
-                                    break;
-                                }
-                            }
+    // Stops among the vertices reached by a walk search with the time to walk to or from them
+    void CollectStops(const std::vector< std::pair<CPathRouter::TVertexID, double> > &reached, std::vector< std::pair< CRaptorRouter::TStopIndex, double > > &stops) const {
+        stops.clear();
+        for (auto &Reached : reached) {
+            if ((Reached.first < DVertexStopIndices.size()) && (DVertexStopIndices[Reached.first] != CRaptorRouter::InvalidIndex)) {
+                stops.emplace_back(DVertexStopIndices[Reached.first], Reached.second);
+            }
+        }
+    }
+
+    // Fastest trip in seconds on foot and by bus found by RAPTOR. A ride takes at least as long as
+    // its walks to and from the stops, so only the stops within the direct walk time of the source,
+    // and from which the destination is within it on the reversed streets, are searched. The trip
+    // walks all the way unless RAPTOR finds a faster ride.
+    double FindRaptorPath(CPathRouter::TVertexID src, CPathRouter::TVertexID dest, std::vector<TTripStep>& steps, SContext &context) const {
+        auto &WalkPath = context.DRouterPath;
+        double WalkDuration = DWalkRouter->FindShortestPath(src, dest, WalkPath, *context.DWalkWorkspace);
+        CollectStops(DWalkRouter->FindVerticesWithin(src, WalkDuration, *context.DWalkWorkspace), context.DAccess);
+        CollectStops(DReverseWalkRouter->FindVerticesWithin(dest, WalkDuration, *context.DReverseWalkWorkspace), context.DEgress);
+        double RideDuration = DRaptorRouter->FindFastestJourney(context.DAccess, context.DEgress, TransitRoundCount, context.DLegs, *context.DRaptorWorkspace);
+        steps.clear();
+        if (WalkDuration == CPathRouter::NoPathExists && RideDuration == CRaptorRouter::NoPathExists) {
+            return CPathRouter::NoPathExists;
+        }
+        steps.emplace_back(ETransportationMode::Walk, DVertexNodeIDs[src]);
+        if (WalkDuration <= RideDuration) {
+            for (std::size_t Index = 1; Index < WalkPath.size(); Index++) {
+                steps.emplace_back(ETransportationMode::Walk, DVertexNodeIDs[WalkPath[Index]]);
+            }
+            return WalkDuration;
+        }
+        for (auto &Leg : context.DLegs) {
+            switch (Leg.DType) {
+                case CRaptorRouter::ELegType::Access:
+                    AppendWalk(src, DTransitStopVertexIDs[Leg.DDestination], steps, context);
+                    break;
+                case CRaptorRouter::ELegType::Ride:
+                    // A route can list a stop twice in a row, it is only stepped to once
+                    for (auto Index = Leg.DBoardIndex + 1; Index <= Leg.DAlightIndex; Index++) {
+                        auto NodeID = DTransitStopNodeIDs[DRaptorRouter->RouteStop(Leg.DRoute, Index)];
+                        if (steps.back().second != NodeID) {
+                            steps.emplace_back(ETransportationMode::Bus, NodeID);
                         }
                     }
+                    break;
+                case CRaptorRouter::ELegType::Transfer:
+                    AppendWalk(DTransitStopVertexIDs[Leg.DSource], DTransitStopVertexIDs[Leg.DDestination], steps, context);
+                    break;
+                case CRaptorRouter::ELegType::Egress:
+                    AppendWalk(DTransitStopVertexIDs[Leg.DSource], dest, steps, context);
+                    break;
+            }
+        }
+        return RideDuration;
+    }
+
+    // Looks up the router vertices of nodes, InvalidVertexID for nodes not in the map
+    std::vector< CPathRouter::TVertexID > LookupVertexIDs(const std::vector<TNodeID>& nodes) const {
+        std::vector< CPathRouter::TVertexID > VertexIDs;
+        for (auto NodeID : nodes) {
+            auto Search = DNodeToVertexID.find(NodeID);
+            VertexIDs.push_back(Search == DNodeToVertexID.end() ? CPathRouter::InvalidVertexID : Search->second);
+        }
+        return VertexIDs;
+    }
+
+    std::vector<double> FindShortestDistances(TNodeID src, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        auto SourceVertexIDs = LookupVertexIDs({src});
+        return DShortestPathRouter->FindDistances(SourceVertexIDs.front(), LookupVertexIDs(dests), *Context.DShortestWorkspace);
+    }
+
+    std::vector<double> FindFastestTimes(TNodeID src, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+        return FindFastestTimeMatrix({src}, dests, context).front();
+    }
+
+    std::vector<std::vector<double>> FindShortestDistanceMatrix(const std::vector<TNodeID>& srcs, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        return DShortestPathRouter->FindDistanceMatrix(LookupVertexIDs(srcs), LookupVertexIDs(dests), *Context.DShortestWorkspace);
+    }
+
+    // Times in hours chosen the way FindFastestPath chooses them, the faster of biking and walking
+    // with buses. RAPTOR limits the rides and the transfer walks, so with it each walk/bus time is
+    // its own RAPTOR search rather than a column of the layered router's matrix.
+    std::vector<std::vector<double>> FindFastestTimeMatrix(const std::vector<TNodeID>& srcs, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        auto SourceVertexIDs = LookupVertexIDs(srcs);
+        auto DestinationVertexIDs = LookupVertexIDs(dests);
+        auto Times = DFastestPathRouterBike->FindDistanceMatrix(SourceVertexIDs, DestinationVertexIDs, *Context.DBikeWorkspace);
+        std::vector<std::vector<double>> WalkBusTimes;
+        if (DRaptorRouter) {
+            WalkBusTimes.assign(SourceVertexIDs.size(), std::vector<double>(DestinationVertexIDs.size(), CPathRouter::NoPathExists));
+            for (std::size_t Row = 0; Row < SourceVertexIDs.size(); Row++) {
+                for (std::size_t Column = 0; Column < DestinationVertexIDs.size(); Column++) {
+                    if ((SourceVertexIDs[Row] != CPathRouter::InvalidVertexID) && (DestinationVertexIDs[Column] != CPathRouter::InvalidVertexID)) {
+                        WalkBusTimes[Row][Column] = FindRaptorPath(SourceVertexIDs[Row], DestinationVertexIDs[Column], Context.DWalkBusSteps, Context);
+                    }
                 }
+            }
+        }
+        else {
+            WalkBusTimes = DFastestPathRouterWalkBus->FindDistanceMatrix(SourceVertexIDs, DestinationVertexIDs, *Context.DWalkBusWorkspace);
+        }
+        for (std::size_t Row = 0; Row < Times.size(); Row++) {
+            for (std::size_t Column = 0; Column < Times[Row].size(); Column++) {
+                Times[Row][Column] = std::min(Times[Row][Column], WalkBusTimes[Row][Column]);
+                if (Times[Row][Column] != CPathRouter::NoPathExists) {
+                    Times[Row][Column] /= 3600.0;
+                }
+            }
+        }
+        return Times;
+    }
+
+    // Bounded search of router from src, returning the node IDs of the street vertices within budget
+    std::vector<TNodeID> ReachableWithin(const CPathRouter &router, CPathRouter::SQueryWorkspace &workspace, TNodeID src, double budget) const {
+        std::vector<TNodeID> Nodes;
+        auto SourceSearch = DNodeToVertexID.find(src);
+        if (SourceSearch == DNodeToVertexID.end()) {
+            return Nodes;
+        }
+        for (auto &Reached : router.FindVerticesWithin(SourceSearch->second, budget, workspace)) {
+            if (Reached.first < DStreetVertexCount) {
+                Nodes.push_back(DVertexNodeIDs[Reached.first]);
+            }
+        }
+        return Nodes;
+    }
 
-                // Add the node and mode to the path only if the mode has changed
-                if (Mode != PrevMode) {
-                    path.emplace_back(Mode, NodeID);
-                    PrevMode = Mode;
+    std::vector<TNodeID> ReachableWithin(TNodeID src, double budget, ETransportationMode mode, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        if (mode == ETransportationMode::Bike) {
+            return ReachableWithin(*DFastestPathRouterBike, *Context.DBikeWorkspace, src, budget);
+        }
+        return ReachableWithin(*DFastestPathRouterWalkBus, *Context.DWalkBusWorkspace, src, budget);
+    }
+
+    std::vector<TNodeID> ReachableWithinDistance(TNodeID src, double budget, SQueryContext &context) const {
+        auto &Context = QueryContext(context);
+        return ReachableWithin(*DShortestPathRouter, *Context.DShortestWorkspace, src, budget);
+    }
+
+    std::vector<CStreetMap::TLocation> RegionOutline(const std::vector<TNodeID>& nodes) const {
+        std::vector<CStreetMap::TLocation> Locations;
+        for (auto NodeID : nodes) {
+            auto Search = DNodeToVertexID.find(NodeID);
+            if (Search != DNodeToVertexID.end()) {
+                Locations.push_back(DVertexLocations[Search->second]);
+            }
+        }
+        return SGeographicUtils::ConvexHull(Locations);
+    }
+
+    // Runs query(index, context) for each index over the pool, each worker creates its context on first
+    // use. A router from the factory whose queries are not safe to run at once has the batch run one
+    // query after another on the calling thread instead.
+    template <typename TQuery>
+    void RunBatch(std::size_t count, CThreadPool &pool, TQuery query) const {
+        for (auto &Router : RouterList()) {
+            if (Router && !Router->ConcurrentQueries()) {
+                auto Context = CreateQueryContext();
+                for (std::size_t Index = 0; Index < count; Index++) {
+                    query(Index, *Context);
                 }
+                return;
             }
-            return WalkBusDuration / 3600.0; // Convert seconds to hours
         }
+        std::vector< std::unique_ptr< SQueryContext > > Contexts(pool.ThreadCount());
+        pool.ParallelFor(count, [&](std::size_t Index, std::size_t Worker){
+            if (!Contexts[Worker]) {
+                Contexts[Worker] = CreateQueryContext();
+            }
+            query(Index, *Contexts[Worker]);
+        });
+    }
+
+    std::vector<double> FindShortestPaths(const std::vector<TNodePair>& pairs, std::vector<std::vector<TNodeID>>& paths, CThreadPool &pool) const {
+        std::vector<double> Distances(pairs.size(), CPathRouter::NoPathExists);
+        paths.assign(pairs.size(), {});
+        RunBatch(pairs.size(), pool, [&](std::size_t Index, SQueryContext &Context){
+            Distances[Index] = FindShortestPath(pairs[Index].first, pairs[Index].second, paths[Index], Context);
+        });
+        return Distances;
+    }
 
-        return CPathRouter::NoPathExists;
+    std::vector<double> FindFastestPaths(const std::vector<TNodePair>& pairs, std::vector<std::vector<TTripStep>>& paths, CThreadPool &pool) const {
+        std::vector<double> Times(pairs.size(), CPathRouter::NoPathExists);
+        paths.assign(pairs.size(), {});
+        RunBatch(pairs.size(), pool, [&](std::size_t Index, SQueryContext &Context){
+            Times[Index] = FindFastestPath(pairs[Index].first, pairs[Index].second, paths[Index], Context);
+        });
+        return Times;
+    }
+
+    void SetPathCacheCapacity(std::size_t entries) {
+        DPathCache = entries ? std::make_unique< CPathCache >(entries) : nullptr;
     }
 
     bool GetPathDescription(const std::vector<TTripStep>& path, std::vector<std::string>& desc) const {
@@ -226,10 +1134,9 @@ DFastestPathRouterWalkBus.AddEdge(PreviousVertexID, NextVertexID, TimeWalkBus, B
         }
 
         // Start location
-        auto StartNode = DStreetMap->NodeByID(path.front().second);
-        if (!StartNode) return false;
+        CStreetMap::TLocation StartLocation;
+        if (!NodeLocation(path.front().second, StartLocation)) return false;
 
-        auto StartLocation = StartNode->Location();
         std::stringstream StartSS;
         StartSS << "Start at " << SGeographicUtils::ConvertLLToDMS(StartLocation);
         desc.push_back(StartSS.str());
@@ -238,11 +1145,10 @@ DFastestPathRouterWalkBus.AddEdge(PreviousVertexID, NextVertexID, TimeWalkBus, B
             const auto& step = path[i];
             const auto& nextStep = path[i + 1];
 
-            auto currentNode = DStreetMap->NodeByID(step.second);
-            auto nextNode = DStreetMap->NodeByID(nextStep.second);
-            if (!currentNode || !nextNode) return false;
+            CStreetMap::TLocation currentLocation, nextLocation;
+            if (!NodeLocation(step.second, currentLocation) || !NodeLocation(nextStep.second, nextLocation)) return false;
 
-            auto distance = SGeographicUtils::HaversineDistanceInMiles(currentNode->Location(), nextNode->Location());
+            auto distance = SGeographicUtils::HaversineDistanceInMiles(currentLocation, nextLocation);
             std::string modeDescription = step.first == ETransportationMode::Walk ? "Walk" : (step.first == ETransportationMode::Bike ? "Bike" : "Take Bus");
 
             std::stringstream segmentDesc;
@@ -251,10 +1157,9 @@ DFastestPathRouterWalkBus.AddEdge(PreviousVertexID, NextVertexID, TimeWalkBus, B
         }
 
         // End location
-        auto EndNode = DStreetMap->NodeByID(path.back().second);
-        if (!EndNode) return false;
+        CStreetMap::TLocation EndLocation;
+        if (!NodeLocation(path.back().second, EndLocation)) return false;
 
-        auto EndLocation = EndNode->Location();
         std::stringstream EndSS;
         EndSS << "End at " << SGeographicUtils::ConvertLLToDMS(EndLocation);
         desc.push_back(EndSS.str());
@@ -264,12 +1169,31 @@ DFastestPathRouterWalkBus.AddEdge(PreviousVertexID, NextVertexID, TimeWalkBus, B
 
 };
 // Constructor
-CDijkstraTransportationPlanner::CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config)
-    : DImplementation(std::make_unique<SImplementation>(config)) {}
+CDijkstraTransportationPlanner::CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config, TRouterFactory routerfactory, ETransitEngine transitengine)
+    : DImplementation(std::make_unique<SImplementation>(config, routerfactory, transitengine)) {}
+
+CDijkstraTransportationPlanner::CDijkstraTransportationPlanner(std::unique_ptr<SImplementation> implementation)
+    : DImplementation(std::move(implementation)) {}
 
 // Destructor
 CDijkstraTransportationPlanner::~CDijkstraTransportationPlanner() = default;
 
+bool CDijkstraTransportationPlanner::SaveSnapshot(const std::string &path, uint64_t sourcekey) const {
+    return DImplementation->SaveSnapshot(path, sourcekey);
+}
+
+std::shared_ptr<CDijkstraTransportationPlanner> CDijkstraTransportationPlanner::LoadSnapshot(const std::string &path, uint64_t sourcekey, std::shared_ptr<SConfiguration> config, TRouterFactory routerfactory, ETransitEngine transitengine) {
+    auto Snapshot = CGraphSnapshot::Open(path, sourcekey);
+    if (!Snapshot || !config) {
+        return nullptr;
+    }
+    auto Implementation = std::make_unique<SImplementation>(routerfactory, transitengine);
+    if (!Implementation->LoadSnapshot(*Snapshot, config)) {
+        return nullptr;
+    }
+    return std::shared_ptr<CDijkstraTransportationPlanner>(new CDijkstraTransportationPlanner(std::move(Implementation)));
+}
+
 std::size_t CDijkstraTransportationPlanner::NodeCount() const noexcept {
     return DImplementation->NodeCount();
 }
@@ -279,11 +1203,67 @@ std::shared_ptr<CStreetMap::SNode> CDijkstraTransportationPlanner::SortedNodeByI
 }
 
 double CDijkstraTransportationPlanner::FindShortestPath(TNodeID src, TNodeID dest, std::vector<TNodeID>& path) {
-    return DImplementation->FindShortestPath(src, dest, path);
+    return DImplementation->FindShortestPath(src, dest, path, DImplementation->OwnQueryContext());
 }
 
 double CDijkstraTransportationPlanner::FindFastestPath(TNodeID src, TNodeID dest, std::vector<TTripStep>& path) {
-    return DImplementation->FindFastestPath(src, dest, path);
+    return DImplementation->FindFastestPath(src, dest, path, DImplementation->OwnQueryContext());
+}
+
+std::unique_ptr<CTransportationPlanner::SQueryContext> CDijkstraTransportationPlanner::CreateQueryContext() const {
+    return DImplementation->CreateQueryContext();
+}
+
+double CDijkstraTransportationPlanner::FindShortestPath(TNodeID src, TNodeID dest, std::vector<TNodeID>& path, SQueryContext &context) const {
+    return DImplementation->FindShortestPath(src, dest, path, context);
+}
+
+double CDijkstraTransportationPlanner::FindFastestPath(TNodeID src, TNodeID dest, std::vector<TTripStep>& path, SQueryContext &context) const {
+    return DImplementation->FindFastestPath(src, dest, path, context);
+}
+
+std::vector<double> CDijkstraTransportationPlanner::FindShortestPaths(const std::vector<TNodePair>& pairs, std::vector<std::vector<TNodeID>>& paths, CThreadPool &pool) const {
+    return DImplementation->FindShortestPaths(pairs, paths, pool);
+}
+
+std::vector<double> CDijkstraTransportationPlanner::FindFastestPaths(const std::vector<TNodePair>& pairs, std::vector<std::vector<TTripStep>>& paths, CThreadPool &pool) const {
+    return DImplementation->FindFastestPaths(pairs, paths, pool);
+}
+
+std::vector<double> CDijkstraTransportationPlanner::FindShortestDistances(TNodeID src, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+    return DImplementation->FindShortestDistances(src, dests, context);
+}
+
+std::vector<double> CDijkstraTransportationPlanner::FindFastestTimes(TNodeID src, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+    return DImplementation->FindFastestTimes(src, dests, context);
+}
+
+std::vector<std::vector<double>> CDijkstraTransportationPlanner::FindShortestDistanceMatrix(const std::vector<TNodeID>& srcs, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+    return DImplementation->FindShortestDistanceMatrix(srcs, dests, context);
+}
+
+std::vector<std::vector<double>> CDijkstraTransportationPlanner::FindFastestTimeMatrix(const std::vector<TNodeID>& srcs, const std::vector<TNodeID>& dests, SQueryContext &context) const {
+    return DImplementation->FindFastestTimeMatrix(srcs, dests, context);
+}
+
+std::vector<CTransportationPlanner::TNodeID> CDijkstraTransportationPlanner::ReachableWithin(TNodeID src, double budget, ETransportationMode mode, SQueryContext &context) const {
+    return DImplementation->ReachableWithin(src, budget, mode, context);
+}
+
+std::vector<CTransportationPlanner::TNodeID> CDijkstraTransportationPlanner::ReachableWithinDistance(TNodeID src, double budget, SQueryContext &context) const {
+    return DImplementation->ReachableWithinDistance(src, budget, context);
+}
+
+std::vector<CStreetMap::TLocation> CDijkstraTransportationPlanner::RegionOutline(const std::vector<TNodeID>& nodes) const {
+    return DImplementation->RegionOutline(nodes);
+}
+
+void CDijkstraTransportationPlanner::SetPathCacheCapacity(std::size_t entries) {
+    DImplementation->SetPathCacheCapacity(entries);
+}
+
+CPathCache *CDijkstraTransportationPlanner::PathCache() const noexcept {
+    return DImplementation->DPathCache.get();
 }
 
 bool CDijkstraTransportationPlanner::GetPathDescription(const std::vector<TTripStep>& path, std::vector<std::string>& desc) const {
@@ -1,9 +1,10 @@
 #include "FileDataFactory.h"
 #include "FileDataSource.h"
+#include "MMapDataSource.h"
 #include "FileDataSink.h"
 #include <filesystem>
 
-CFileDataFactory::CFileDataFactory(const std::string &path){
+CFileDataFactory::CFileDataFactory(const std::string &path, ESourceType sourcetype) : DSourceType(sourcetype){
     if(path.empty()){
         DBasePath = "./";
     }
@@ -13,6 +14,9 @@ CFileDataFactory::CFileDataFactory(const std::string &path){
 }
 
 std::shared_ptr< CDataSource > CFileDataFactory::CreateSource(const std::string &name) noexcept{
+    if(DSourceType == ESourceType::MemoryMapped){
+        return std::make_shared<CMMapDataSource>(DBasePath + name);
+    }
     return std::make_shared<CFileDataSource>(DBasePath + name);
 }
 
@@ -13,4 +13,9 @@ bool CFileDataSink::Put(const char &ch) noexcept{
 bool CFileDataSink::Write(const std::vector<char> &buf) noexcept{
     DFile.write(buf.data(),buf.size());
     return DFile.good();
-}
\ No newline at end of file
+}
+
+bool CFileDataSink::Flush() noexcept{
+    DFile.flush();
+    return DFile.good();
+}
@@ -1,44 +1,67 @@
 #include "FileDataSource.h"
+#include <algorithm>
+
+namespace{
+    const std::size_t BlockSize = 65536;
+}
 
 CFileDataSource::CFileDataSource(const std::string &filename){
-    DFile.open(filename);
+    DFile.open(filename, std::ios::binary);
+    Fill();
+}
+
+void CFileDataSource::Fill(){
+    if(DIndex < DBuffer.size()){
+        return;
+    }
+    DIndex = 0;
+    DBuffer.resize(BlockSize);
     if(DFile.good()){
-        DFile.peek();
+        DFile.read(DBuffer.data(), BlockSize);
+        DBuffer.resize(DFile.gcount());
+    }
+    else{
+        DBuffer.clear();
     }
 }
 
 bool CFileDataSource::End() const noexcept{
-    return DFile.eof();
+    return DIndex >= DBuffer.size();
 }
 
 bool CFileDataSource::Get(char &ch) noexcept{
-    if(!DFile.good()){
+    if(End()){
         return false;
     }
-    ch = DFile.get();
-    if(ch != EOF){
-        DFile.peek();
-    }
-    return ch != EOF;
+    ch = DBuffer[DIndex++];
+    Fill();
+    return true;
 }
 
 bool CFileDataSource::Peek(char &ch) noexcept{
-    if(!DFile.good()){
+    if(End()){
         return false;
     }
-    ch = DFile.peek();
-    return ch != EOF;
+    ch = DBuffer[DIndex];
+    return true;
 }
 
 bool CFileDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
-    if(!DFile.good()){
-        return false;
-    }
-    char TempCh;
     buf.clear();
-    buf.reserve(count);
-    while(buf.size() < count && Get(TempCh)){
-        buf.push_back(TempCh);
+    while(buf.size() < count && !End()){
+        auto Count = std::min(count - buf.size(), DBuffer.size() - DIndex);
+        buf.insert(buf.end(), DBuffer.begin() + DIndex, DBuffer.begin() + DIndex + Count);
+        DIndex += Count;
+        Fill();
     }
     return !buf.empty();
 }
+
+std::pair< const char *, std::size_t > CFileDataSource::Chunk() noexcept{
+    return std::make_pair(DBuffer.data() + DIndex, DBuffer.size() - DIndex);
+}
+
+void CFileDataSource::Advance(std::size_t count) noexcept{
+    DIndex += std::min(count, DBuffer.size() - DIndex);
+    Fill();
+}
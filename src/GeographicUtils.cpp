@@ -2,6 +2,7 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 
 double SGeographicUtils::DegreesToRadians(double deg){
     return M_PI * (deg) / 180.0;
@@ -97,3 +98,37 @@ std::string SGeographicUtils::ConvertLLToDMS(CStreetMap::TLocation loc){
     
     return OutStream.str();
 }
+
+
+std::vector< CStreetMap::TLocation > SGeographicUtils::ConvexHull(std::vector< CStreetMap::TLocation > locs){
+    // Andrew's monotone chain over (longitude, latitude) so the hull winds counterclockwise on a map
+    auto LonLatLess = [](const CStreetMap::TLocation &left, const CStreetMap::TLocation &right){
+        return std::make_pair(std::get<1>(left), std::get<0>(left)) < std::make_pair(std::get<1>(right), std::get<0>(right));
+    };
+    auto Cross = [](const CStreetMap::TLocation &origin, const CStreetMap::TLocation &first, const CStreetMap::TLocation &second){
+        return (std::get<1>(first) - std::get<1>(origin)) * (std::get<0>(second) - std::get<0>(origin)) - (std::get<0>(first) - std::get<0>(origin)) * (std::get<1>(second) - std::get<1>(origin));
+    };
+    std::sort(locs.begin(), locs.end(), LonLatLess);
+    locs.erase(std::unique(locs.begin(), locs.end()), locs.end());
+    if(locs.size() < 3){
+        return locs;
+    }
+    std::vector< CStreetMap::TLocation > Hull(2 * locs.size());
+    std::size_t Count = 0;
+    // Lower chain left to right, then upper chain right to left, dropping points that do not turn left
+    for(std::size_t Index = 0; Index < locs.size(); Index++){
+        while((Count >= 2)&&(Cross(Hull[Count-2], Hull[Count-1], locs[Index]) <= 0.0)){
+            Count--;
+        }
+        Hull[Count++] = locs[Index];
+    }
+    for(std::size_t Index = locs.size() - 1, LowerCount = Count + 1; Index > 0; Index--){
+        while((Count >= LowerCount)&&(Cross(Hull[Count-2], Hull[Count-1], locs[Index-1]) <= 0.0)){
+            Count--;
+        }
+        Hull[Count++] = locs[Index-1];
+    }
+    // The last point repeats the first
+    Hull.resize(Count - 1);
+    return Hull;
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "GraphSnapshot.h"
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace{
+    const char SnapshotMagic[8] = {'T','P','S','N','A','P','\0','\0'};
+    // Written in the machine's byte order, so a snapshot from a machine of the other order is rejected
+    const uint32_t ByteOrderMark = 0x01020304;
+    // Sections start on multiples of the alignment so their values can be read in place
+    const std::size_t SectionAlignment = 8;
+
+    struct SHeader{
+        char DMagic[8];
+        uint32_t DVersion;
+        uint32_t DSectionCount;
+        uint64_t DSourceKey;
+        uint64_t DPayloadBytes;
+        uint64_t DChecksum;
+        uint32_t DByteOrder;
+        uint32_t DReserved;
+    };
+
+    struct SSectionEntry{
+        uint32_t DID;
+        uint32_t DElementSize;
+        uint64_t DOffset;
+        uint64_t DCount;
+    };
+
+    // 64 bit FNV-1a over 8 byte words, with the trailing bytes taken one at a time
+    uint64_t Checksum(const char *data, std::size_t size){
+        const uint64_t Prime = 0x100000001b3ULL;
+        uint64_t Hash = 0xcbf29ce484222325ULL;
+        std::size_t Index = 0;
+        for(; Index + sizeof(uint64_t) <= size; Index += sizeof(uint64_t)){
+            uint64_t Word;
+            std::memcpy(&Word, data + Index, sizeof(Word));
+            Hash = (Hash ^ Word) * Prime;
+        }
+        for(; Index < size; Index++){
+            Hash = (Hash ^ uint8_t(data[Index])) * Prime;
+        }
+        return Hash;
+    }
+
+    std::size_t AlignUp(std::size_t offset){
+        return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    }
+}
+
+struct CGraphSnapshot::SImplementation{
+    int DFileDescriptor = -1;
+    const char *DData = nullptr;
+    std::size_t DBytes = 0;
+    uint64_t DSourceKey = 0;
+    std::vector< SSectionEntry > DSections;
+
+    ~SImplementation(){
+        if(DData){
+            munmap(const_cast< char * >(DData), DBytes);
+        }
+        if(0 <= DFileDescriptor){
+            close(DFileDescriptor);
+        }
+    }
+
+    bool Open(const std::string &path, uint64_t sourcekey){
+        DFileDescriptor = open(path.c_str(), O_RDONLY);
+        if(DFileDescriptor < 0){
+            return false;
+        }
+        struct stat Status;
+        if((fstat(DFileDescriptor, &Status) != 0) || (std::size_t(Status.st_size) < sizeof(SHeader))){
+            return false;
+        }
+        DBytes = Status.st_size;
+        void *Mapping = mmap(nullptr, DBytes, PROT_READ, MAP_PRIVATE, DFileDescriptor, 0);
+        if(Mapping == MAP_FAILED){
+            return false;
+        }
+        DData = static_cast< const char * >(Mapping);
+        SHeader Header;
+        std::memcpy(&Header, DData, sizeof(Header));
+        if(std::memcmp(Header.DMagic, SnapshotMagic, sizeof(SnapshotMagic)) || (Header.DByteOrder != ByteOrderMark) || (Header.DVersion != Version) || (Header.DSourceKey != sourcekey)){
+            return false;
+        }
+        if((Header.DPayloadBytes != DBytes - sizeof(Header)) || (Header.DSectionCount > Header.DPayloadBytes / sizeof(SSectionEntry))){
+            return false;
+        }
+        if(Checksum(DData + sizeof(Header), Header.DPayloadBytes) != Header.DChecksum){
+            return false;
+        }
+        DSourceKey = Header.DSourceKey;
+        DSections.resize(Header.DSectionCount);
+        if(!DSections.empty()){
+            std::memcpy(DSections.data(), DData + sizeof(Header), DSections.size() * sizeof(SSectionEntry));
+        }
+        for(auto &Section : DSections){
+            if(!Section.DElementSize || (Section.DOffset % SectionAlignment) || (Section.DOffset > DBytes) || (Section.DCount > (DBytes - Section.DOffset) / Section.DElementSize)){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const SSectionEntry *Find(uint32_t id) const{
+        for(auto &Section : DSections){
+            if(Section.DID == id){
+                return &Section;
+            }
+        }
+        return nullptr;
+    }
+};
+
+CGraphSnapshot::CGraphSnapshot(){
+    DImplementation = std::make_unique<SImplementation>();
+}
+
+CGraphSnapshot::~CGraphSnapshot(){
+
+}
+
+std::unique_ptr< CGraphSnapshot > CGraphSnapshot::Open(const std::string &path, uint64_t sourcekey){
+    std::unique_ptr< CGraphSnapshot > Snapshot(new CGraphSnapshot());
+    if(!Snapshot->DImplementation->Open(path, sourcekey)){
+        return nullptr;
+    }
+    return Snapshot;
+}
+
+uint64_t CGraphSnapshot::FileKey(const std::vector< std::string > &paths){
+    uint64_t Key = 0xcbf29ce484222325ULL;
+    for(auto &Path : paths){
+        std::error_code Error;
+        uint64_t Values[2] = {0, 0};
+        auto Size = std::filesystem::file_size(Path, Error);
+        if(!Error){
+            Values[0] = Size;
+            auto Modified = std::filesystem::last_write_time(Path, Error);
+            Values[1] = Error ? 0 : uint64_t(Modified.time_since_epoch().count());
+        }
+        Key = (Key ^ Checksum(reinterpret_cast< const char * >(Values), sizeof(Values))) * 0x100000001b3ULL;
+    }
+    return Key;
+}
+
+uint64_t CGraphSnapshot::SourceKey() const noexcept{
+    return DImplementation->DSourceKey;
+}
+
+std::size_t CGraphSnapshot::Bytes() const noexcept{
+    return DImplementation->DBytes;
+}
+
+std::size_t CGraphSnapshot::SectionCount() const noexcept{
+    return DImplementation->DSections.size();
+}
+
+bool CGraphSnapshot::HasSection(uint32_t id) const noexcept{
+    return DImplementation->Find(id) != nullptr;
+}
+
+std::pair< const void *, std::size_t > CGraphSnapshot::RawSection(uint32_t id, std::size_t elementsize) const noexcept{
+    auto Section = DImplementation->Find(id);
+    if(!Section || (Section->DElementSize != elementsize)){
+        return std::make_pair(nullptr, 0);
+    }
+    return std::make_pair(DImplementation->DData + Section->DOffset, Section->DCount);
+}
+
+bool CGraphSnapshot::CWriter::Write(const std::string &path, uint64_t sourcekey) const{
+    // The payload is the section table followed by the sections, each aligned
+    std::vector< SSectionEntry > Entries;
+    std::size_t Offset = sizeof(SHeader) + DSections.size() * sizeof(SSectionEntry);
+    for(auto &Section : DSections){
+        Offset = AlignUp(Offset);
+        Entries.push_back({Section.DID, Section.DElementSize, Offset, Section.DData.size() / Section.DElementSize});
+        Offset += Section.DData.size();
+    }
+    std::vector< char > Payload(AlignUp(Offset) - sizeof(SHeader), 0);
+    if(!Entries.empty()){
+        std::memcpy(Payload.data(), Entries.data(), Entries.size() * sizeof(SSectionEntry));
+    }
+    for(std::size_t Index = 0; Index < DSections.size(); Index++){
+        if(!DSections[Index].DData.empty()){
+            std::memcpy(Payload.data() + Entries[Index].DOffset - sizeof(SHeader), DSections[Index].DData.data(), DSections[Index].DData.size());
+        }
+    }
+    SHeader Header;
+    std::memcpy(Header.DMagic, SnapshotMagic, sizeof(SnapshotMagic));
+    Header.DVersion = Version;
+    Header.DSectionCount = Entries.size();
+    Header.DSourceKey = sourcekey;
+    Header.DPayloadBytes = Payload.size();
+    Header.DChecksum = Checksum(Payload.data(), Payload.size());
+    Header.DByteOrder = ByteOrderMark;
+    Header.DReserved = 0;
+
+    std::string TemporaryPath = path + ".tmp";
+    {
+        std::ofstream File(TemporaryPath, std::ios::binary | std::ios::trunc);
+        File.write(reinterpret_cast< const char * >(&Header), sizeof(Header));
+        File.write(Payload.data(), Payload.size());
+        if(!File.good()){
+            File.close();
+            std::remove(TemporaryPath.c_str());
+            return false;
+        }
+    }
+    if(std::rename(TemporaryPath.c_str(), path.c_str()) != 0){
+        std::remove(TemporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
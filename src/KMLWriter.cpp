@@ -9,6 +9,7 @@ struct CKMLWriter::SImplementation{
     std::shared_ptr<CXMLWriter> DXMLWriter;
     std::unordered_set<std::string> DPointStyles;
     std::unordered_set<std::string> DLineStyles;
+    std::unordered_set<std::string> DPolygonStyles;
     std::size_t DIndentionLevel;
 
     static const std::string DKMLTag;
@@ -23,6 +24,10 @@ struct CKMLWriter::SImplementation{
     static const std::string DStyleURLTag;
     static const std::string DPlacemarkTag;
     static const std::string DLineStringTag;
+    static const std::string DPolyStyleTag;
+    static const std::string DPolygonTag;
+    static const std::string DOuterBoundaryIsTag;
+    static const std::string DLinearRingTag;
     static const std::string DCoordinatesTag;
     static const std::string DTessellateTag;
     static const std::string DAltitudeModeTag;
@@ -142,6 +147,27 @@ struct CKMLWriter::SImplementation{
         return false;
     }
 
+    bool CreatePolygonStyle(const std::string &stylename, unsigned int linecolor, unsigned int fillcolor, int width){
+        std::stringstream LineStream, FillStream;
+        LineStream<<std::setw(8)<<std::setfill('0')<<std::hex<<linecolor;
+        FillStream<<std::setw(8)<<std::setfill('0')<<std::hex<<fillcolor;
+        if(!DPolygonStyles.count(stylename) && 
+            StartTag(DStyleTag,{{DIDKey,stylename}}) && 
+            StartTag(DLineStyleTag,{}) && 
+            StartTagDataEndTag(DColorTag,LineStream.str()) && 
+            StartTagDataEndTag(DWidthTag,std::to_string(width)) && 
+            EndTag(DLineStyleTag) && 
+            StartTag(DPolyStyleTag,{}) && 
+            StartTagDataEndTag(DColorTag,FillStream.str()) && 
+            EndTag(DPolyStyleTag) && 
+            EndTag(DStyleTag)){
+
+            DPolygonStyles.insert(stylename);
+            return true;
+        }
+        return false;
+    }
+
     bool CreatePoint(const std::string &name, const std::string &desc, const std::string &stylename, CStreetMap::TLocation point){
         if(DPointStyles.count(stylename) && 
             StartTag(DPlacemarkTag,{}) && 
@@ -185,6 +211,40 @@ struct CKMLWriter::SImplementation{
         }
         return false;
     }
+
+    bool CreatePolygon(const std::string &name, const std::string &stylename, const std::vector< CStreetMap::TLocation > &points){
+        if(points.empty()){
+            return false;
+        }
+        std::vector<std::string> PointStrings;
+        PointStrings.reserve(points.size() + 1);
+        for(auto &Point : points){
+            PointStrings.push_back(std::to_string(std::get<1>(Point)) + "," + std::to_string(std::get<0>(Point)));
+        }
+        if(points.front() != points.back()){
+            PointStrings.push_back(PointStrings.front());
+        }
+        if(DPolygonStyles.count(stylename) && 
+            StartTag(DPlacemarkTag,{}) && 
+            StartTagDataEndTag(DNameTag,name) && 
+            StartTagDataEndTag(DStyleURLTag,std::string("#") + stylename) && 
+            StartTag(DPolygonTag,{}) && 
+            StartTagDataEndTag(DTessellateTag,"1") && 
+            StartTagDataEndTag(DAltitudeModeTag,DAltitudeModeRelativeToGround) && 
+            StartTag(DOuterBoundaryIsTag,{}) && 
+            StartTag(DLinearRingTag,{}) && 
+            StartTag(DCoordinatesTag,{}) && 
+            IndentedData(PointStrings) && 
+            EndTag(DCoordinatesTag) && 
+            EndTag(DLinearRingTag) && 
+            EndTag(DOuterBoundaryIsTag) && 
+            EndTag(DPolygonTag) && 
+            EndTag(DPlacemarkTag)){
+
+            return true;
+        }
+        return false;
+    }
 };
 
 const std::string CKMLWriter::SImplementation::DKMLTag = "kml";
@@ -199,6 +259,10 @@ const std::string CKMLWriter::SImplementation::DWidthTag = "width";
 const std::string CKMLWriter::SImplementation::DStyleURLTag = "styleUrl";
 const std::string CKMLWriter::SImplementation::DPlacemarkTag = "Placemark";
 const std::string CKMLWriter::SImplementation::DLineStringTag = "LineString";
+const std::string CKMLWriter::SImplementation::DPolyStyleTag = "PolyStyle";
+const std::string CKMLWriter::SImplementation::DPolygonTag = "Polygon";
+const std::string CKMLWriter::SImplementation::DOuterBoundaryIsTag = "outerBoundaryIs";
+const std::string CKMLWriter::SImplementation::DLinearRingTag = "LinearRing";
 const std::string CKMLWriter::SImplementation::DCoordinatesTag = "coordinates";
 const std::string CKMLWriter::SImplementation::DTessellateTag = "tessellate";
 const std::string CKMLWriter::SImplementation::DAltitudeModeTag = "altitudeMode";
@@ -223,6 +287,10 @@ bool CKMLWriter::CreateLineStyle(const std::string &stylename, unsigned int colo
     return DImplementation->CreateLineStyle(stylename,color,width);
 }
 
+bool CKMLWriter::CreatePolygonStyle(const std::string &stylename, unsigned int linecolor, unsigned int fillcolor, int width){
+    return DImplementation->CreatePolygonStyle(stylename,linecolor,fillcolor,width);
+}
+
 bool CKMLWriter::CreatePoint(const std::string &name, const std::string &desc, const std::string &stylename, CStreetMap::TLocation point){
     return DImplementation->CreatePoint(name,desc,stylename,point);
 }
@@ -230,3 +298,8 @@ bool CKMLWriter::CreatePoint(const std::string &name, const std::string &desc, c
 bool CKMLWriter::CreatePath(const std::string &name, const std::string &stylename, const std::vector< CStreetMap::TLocation > &points){
     return DImplementation->CreatePath(name,stylename,points);
 }
+
+
+bool CKMLWriter::CreatePolygon(const std::string &name, const std::string &stylename, const std::vector< CStreetMap::TLocation > &points){
+    return DImplementation->CreatePolygon(name,stylename,points);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "MMapDataSource.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CMMapDataSource::CMMapDataSource(const std::string &filename){
+    int FileDescriptor = open(filename.c_str(), O_RDONLY);
+    if(FileDescriptor < 0){
+        return;
+    }
+    struct stat Status;
+    if((fstat(FileDescriptor, &Status) == 0) && (0 < Status.st_size)){
+        void *Mapping = mmap(nullptr, Status.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+        if(Mapping != MAP_FAILED){
+            // Read front to back, so the kernel can read ahead aggressively
+            madvise(Mapping, Status.st_size, MADV_SEQUENTIAL);
+            DData = static_cast< const char * >(Mapping);
+            DSize = Status.st_size;
+        }
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(FileDescriptor);
+}
+
+CMMapDataSource::~CMMapDataSource(){
+    if(DData){
+        munmap(const_cast< char * >(DData), DSize);
+    }
+}
+
+bool CMMapDataSource::End() const noexcept{
+    return DPosition >= DSize;
+}
+
+bool CMMapDataSource::Get(char &ch) noexcept{
+    if(DPosition >= DSize){
+        return false;
+    }
+    ch = DData[DPosition++];
+    return true;
+}
+
+bool CMMapDataSource::Peek(char &ch) noexcept{
+    if(DPosition >= DSize){
+        return false;
+    }
+    ch = DData[DPosition];
+    return true;
+}
+
+bool CMMapDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    auto Count = std::min(count, DSize - DPosition);
+    buf.assign(DData + DPosition, DData + DPosition + Count);
+    DPosition += Count;
+    return Count != 0;
+}
+
+std::pair< const char *, std::size_t > CMMapDataSource::Chunk() noexcept{
+    return std::make_pair(DData + DPosition, DSize - DPosition);
+}
+
+void CMMapDataSource::Advance(std::size_t count) noexcept{
+    DPosition += std::min(count, DSize - DPosition);
+}
+
+bool CMMapDataSource::StableChunks() const noexcept{
+    return true;
+}
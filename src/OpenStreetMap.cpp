@@ -1,4 +1,13 @@
 #include "OpenStreetMap.h"
+#include "ThreadPool.h"
+#include "XMLParseFeeder.h"
+#include <expat.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -118,63 +127,402 @@ struct COpenStreetMap::SImplementation{
     std::vector< std::shared_ptr<CStreetMap::SNode> > DNodesByIndex;
     std::unordered_map<TWayID, std::shared_ptr<CStreetMap::SWay> > DWayIDToWay;
     std::vector< std::shared_ptr<CStreetMap::SWay> > DWaysByIndex;
+    CXMLReader::SParseStatistics DStatistics;
+
+    // Elements the expat ingest acts on, an element's name is matched once per start and end tag
+    enum class EElement{OSM, Node, Way, ND, Tag, Other};
+
+    // Nodes and ways built by one expat parser from the whole input or from one of its chunks
+    struct SIngest{
+        XML_Parser DXMLParser;
+        std::size_t DChunkSize;
+        std::vector< std::shared_ptr<SNode> > DNodes;
+        std::vector< std::shared_ptr<SWay> > DWays;
+        // Element being built, at most one of them is set
+        std::shared_ptr<SNode> DCurrentNode;
+        std::shared_ptr<SWay> DCurrentWay;
+        // Set while the root element wrapped around a chunk is closed, so it is not taken as the end of the map
+        bool DClosingChunk = false;
+        // Set once the end of the map or a parse error is reached, nothing after it is part of the map
+        bool DStopped = false;
+        // Set if it stopped at the end of the map rather than on a parse error
+        bool DEndOfMap = false;
+
+        // chunksize is clamped to [MinChunkSize, MaxChunkSize] of CXMLReader
+        SIngest(std::size_t chunksize = CXMLReader::DefaultChunkSize)
+        : DChunkSize(std::clamp(chunksize, CXMLReader::MinChunkSize, CXMLReader::MaxChunkSize)){
+            DXMLParser = XML_ParserCreate(NULL);
+            XML_SetElementHandler(DXMLParser, StartElementHandlerCallback, EndElementHandlerCallback);
+            XML_SetUserData(DXMLParser, this);
+        }
+
+        ~SIngest(){
+            XML_ParserFree(DXMLParser);
+        }
+
+        SIngest(const SIngest &) = delete;
+        SIngest &operator=(const SIngest &) = delete;
+
+        // Expat copies what it is given into its buffer, so data is passed in pieces of at most the
+        // chunk size that stay in cache. Returns false once the ingest has stopped.
+        bool Parse(const char *data, std::size_t length, bool isfinal){
+            do{
+                auto Length = std::min(length, DChunkSize);
+                if(DStopped || (XML_Parse(DXMLParser, data, Length, isfinal && (Length == length)) != XML_STATUS_OK)){
+                    DStopped = true;
+                    break;
+                }
+                data += Length;
+                length -= Length;
+            }while(length);
+            return !DStopped;
+        }
+    };
+
+    static EElement Element(const XML_Char *name) noexcept{
+        switch(name[0]){
+            case 'n':   if(!std::strcmp(name, "node")){
+                            return EElement::Node;
+                        }
+                        return std::strcmp(name, "nd") ? EElement::Other : EElement::ND;
+            case 'w':   return std::strcmp(name, "way") ? EElement::Other : EElement::Way;
+            case 't':   return std::strcmp(name, "tag") ? EElement::Other : EElement::Tag;
+            case 'o':   return std::strcmp(name, "osm") ? EElement::Other : EElement::OSM;
+            default:    return EElement::Other;
+        }
+    }
+
+    // Value of the named attribute, or an empty string as a missing attribute reads through the XML reader
+    static const XML_Char *Attribute(const XML_Char **atts, const char *name) noexcept{
+        for(auto Attrptr = atts; *Attrptr; Attrptr += 2){
+            if(!std::strcmp(Attrptr[0], name)){
+                return Attrptr[1];
+            }
+        }
+        return "";
+    }
+
+    // Values that are not numbers convert to zero
+    template <typename TNumber>
+    static TNumber ToNumber(const XML_Char *value) noexcept{
+        TNumber Number = 0;
+        std::from_chars(value, value + std::strlen(value), Number);
+        return Number;
+    }
+
+    static void StartElementHandlerCallback(void *context, const XML_Char *name, const XML_Char **atts){
+        SIngest *Ingest = static_cast<SIngest*>(context);
+        switch(Element(name)){
+            case EElement::Node:{
+                TNodeID NewNodeID = 0;
+                double Lat = 0.0;
+                double Lon = 0.0;
+                for(auto Attrptr = atts; *Attrptr; Attrptr += 2){
+                    if(!std::strcmp(Attrptr[0], "id")){
+                        NewNodeID = ToNumber<TNodeID>(Attrptr[1]);
+                    }
+                    else if(!std::strcmp(Attrptr[0], "lat")){
+                        Lat = ToNumber<double>(Attrptr[1]);
+                    }
+                    else if(!std::strcmp(Attrptr[0], "lon")){
+                        Lon = ToNumber<double>(Attrptr[1]);
+                    }
+                }
+                Ingest->DCurrentNode = std::make_shared<SNode>(NewNodeID, std::make_pair(Lat,Lon));
+                Ingest->DNodes.push_back(Ingest->DCurrentNode);
+                break;
+            }
+            case EElement::Way:
+                Ingest->DCurrentWay = std::make_shared<SWay>();
+                Ingest->DCurrentWay->WID = ToNumber<TWayID>(Attribute(atts, "id"));
+                break;
+            case EElement::ND:
+                if(Ingest->DCurrentWay){
+                    Ingest->DCurrentWay->NodeIDs.push_back(ToNumber<TNodeID>(Attribute(atts, "ref")));
+                }
+                break;
+            case EElement::Tag:
+                if(Ingest->DCurrentNode){
+                    Ingest->DCurrentNode->SetAttribute(Attribute(atts, "k"), Attribute(atts, "v"));
+                }
+                else if(Ingest->DCurrentWay){
+                    Ingest->DCurrentWay->Attributes[Attribute(atts, "k")] = Attribute(atts, "v");
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    static void EndElementHandlerCallback(void *context, const XML_Char *name){
+        SIngest *Ingest = static_cast<SIngest*>(context);
+        switch(Element(name)){
+            case EElement::OSM:
+                // Anything after the end of the map is ignored, as it is when reading entities
+                if(!Ingest->DClosingChunk){
+                    Ingest->DStopped = true;
+                    Ingest->DEndOfMap = true;
+                    XML_StopParser(Ingest->DXMLParser, XML_FALSE);
+                }
+                break;
+            case EElement::Node:
+                Ingest->DCurrentNode.reset();
+                break;
+            case EElement::Way:
+                if(Ingest->DCurrentWay){
+                    Ingest->DWays.push_back(Ingest->DCurrentWay);
+                    Ingest->DCurrentWay.reset();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Adds the ingests' nodes and ways in order up to the first one that stopped, the same order
+    // and the same element for a repeated ID as parsing the whole input in one pass
+    void Merge(const std::vector< std::unique_ptr<SIngest> > &ingests){
+        std::size_t NodeCount = 0;
+        std::size_t WayCount = 0;
+        for(auto &Ingest : ingests){
+            NodeCount += Ingest->DNodes.size();
+            WayCount += Ingest->DWays.size();
+        }
+        DNodesByIndex.reserve(NodeCount);
+        DNodeIDToNode.reserve(NodeCount);
+        DWaysByIndex.reserve(WayCount);
+        DWayIDToWay.reserve(WayCount);
+        for(auto &Ingest : ingests){
+            for(auto &Node : Ingest->DNodes){
+                DNodesByIndex.push_back(Node);
+                DNodeIDToNode[Node->DID] = Node;
+            }
+            for(auto &Way : Ingest->DWays){
+                AddWay(Way);
+            }
+            if(Ingest->DStopped){
+                break;
+            }
+        }
+    }
+
+    std::shared_ptr<SNode> AddNode(TNodeID id, TLocation location){
+        auto NewNode = std::make_shared<SNode>(id,location);
+        DNodesByIndex.push_back(NewNode);
+        DNodeIDToNode[id] = NewNode;
+        return NewNode;
+    }
+
+    void AddWay(std::shared_ptr<SWay> way){
+        DWayIDToWay[way->WID] = way;
+        DWaysByIndex.push_back(way);
+    }
+
+    SImplementation(std::shared_ptr<CDataSource> src, std::size_t chunksize){
+        std::vector< std::unique_ptr<SIngest> > Ingests;
+        Ingests.push_back(std::make_unique<SIngest>());
+        auto &Ingest = *Ingests.front();
+        CXMLParseFeeder Feeder(src, chunksize);
+        while(!Feeder.EndOfData() && !Ingest.DStopped){
+            // Stops at the end of the map or on a parse error, keeping what was built before it
+            if(Feeder.Feed(Ingest.DXMLParser) != XML_STATUS_OK){
+                Ingest.DStopped = true;
+            }
+        }
+        Merge(Ingests);
+        DStatistics = Feeder.Statistics();
+    }
+
+    // Offset of the next tag at or after from, or the input's size if there is none. from must not be
+    // inside markup. Comments, CDATA sections, processing instructions and declarations are skipped,
+    // so a '<' inside them is not taken as a tag.
+    static std::size_t NextTag(std::string_view input, std::size_t from){
+        while((from = input.find('<', from)) != std::string_view::npos){
+            std::string_view SectionEnd;
+            if(input.compare(from, 4, "<!--") == 0){
+                SectionEnd = "-->";
+            }
+            else if(input.compare(from, 9, "<![CDATA[") == 0){
+                SectionEnd = "]]>";
+            }
+            else if(input.compare(from, 2, "<?") == 0){
+                SectionEnd = "?>";
+            }
+            else if(input.compare(from, 2, "<!") == 0){
+                SectionEnd = ">";
+            }
+            else{
+                return from;
+            }
+            from = input.find(SectionEnd, from + 2);
+            if(from == std::string_view::npos){
+                break;
+            }
+            from += SectionEnd.size();
+        }
+        return input.size();
+    }
+
+    // Name of the element whose start or end tag is at offset tag
+    static std::string_view TagName(std::string_view input, std::size_t tag){
+        auto Start = input.compare(tag, 2, "</") == 0 ? tag + 2 : tag + 1;
+        auto End = std::min(input.find_first_of(" \t\r\n/>", Start), input.size());
+        return input.substr(Start, End - Start);
+    }
+
+    SImplementation(std::shared_ptr<CDataSource> src, CThreadPool &pool, std::size_t splitsize, std::size_t chunksize){
+        // Chunks are parsed in place. A source that gives the whole input in one chunk that stays
+        // valid, such as a mapped file, is used as it is, any other is copied together first.
+        std::vector<char> Data;
+        auto Chunk = src->Chunk();
+        std::string_view Input(Chunk.first, Chunk.second);
+        bool InPlace = false;
+        if(src->StableChunks()){
+            src->Advance(Chunk.second);
+            InPlace = src->End();
+        }
+        if(!InPlace){
+            Data.assign(Chunk.first, Chunk.first + Chunk.second);
+            if(!src->StableChunks()){
+                src->Advance(Chunk.second);
+            }
+            for(Chunk = src->Chunk(); Chunk.second; Chunk = src->Chunk()){
+                Data.insert(Data.end(), Chunk.first, Chunk.first + Chunk.second);
+                src->Advance(Chunk.second);
+            }
+            Input = std::string_view(Data.data(), Data.size());
+        }
+        if(!splitsize){
+            splitsize = std::max(Input.size() / (pool.ThreadCount() * ParallelChunksPerThread), MinParallelChunkSize);
+        }
+
+        // Each chunk after the first starts with a node or way start tag. The first one holds the
+        // prolog and the root's start tag, so the later chunks are parsed wrapped in a root of the
+        // same name. Every tag is scanned from the start so none is looked for inside a comment.
+        std::vector< std::size_t > Boundaries = {0};
+        auto Root = NextTag(Input, 0);
+        std::string RootName(Root < Input.size() ? TagName(Input, Root) : std::string_view());
+        if((Root < Input.size()) && (Input.compare(Root, 2, "</") != 0)){
+            auto Target = splitsize;
+            for(auto Tag = NextTag(Input, Root + 1); Tag < Input.size(); Tag = NextTag(Input, Tag + 1)){
+                if(Tag >= Target){
+                    auto Name = TagName(Input, Tag);
+                    if((Input.compare(Tag, 2, "</") != 0) && ((Name == "node") || (Name == "way"))){
+                        Boundaries.push_back(Tag);
+                        Target = Tag + splitsize;
+                    }
+                }
+            }
+        }
+        Boundaries.push_back(Input.size());
+
+        auto ParseStart = std::chrono::steady_clock::now();
+        const std::string ChunkStart = "<" + RootName + ">";
+        const std::string ChunkEnd = "</" + RootName + ">";
+        auto ChunkCount = Boundaries.size() - 1;
+        std::vector< std::unique_ptr<SIngest> > Ingests(ChunkCount);
+        pool.ParallelFor(ChunkCount, [&](std::size_t index, std::size_t){
+            Ingests[index] = std::make_unique<SIngest>(chunksize);
+            auto &Ingest = *Ingests[index];
+            if(index && !Ingest.Parse(ChunkStart.data(), ChunkStart.size(), false)){
+                return;
+            }
+            bool LastChunk = index + 1 == ChunkCount;
+            if(!Ingest.Parse(Input.data() + Boundaries[index], Boundaries[index + 1] - Boundaries[index], LastChunk) || LastChunk){
+                return;
+            }
+            Ingest.DClosingChunk = true;
+            Ingest.Parse(ChunkEnd.data(), ChunkEnd.size(), true);
+            Ingest.DClosingChunk = false;
+        });
+        DStatistics.DBytesParsed = Input.size();
+        DStatistics.DChunkCount = ChunkCount;
+
+        // A chunk that fails before the end of the map may have been split in the wrong place, the
+        // input is then parsed again in one pass so the map is never built from partial chunks
+        for(auto &Ingest : Ingests){
+            if(Ingest->DEndOfMap){
+                break;
+            }
+            if(Ingest->DStopped){
+                Ingests.clear();
+                Ingests.push_back(std::make_unique<SIngest>(chunksize));
+                Ingests.front()->Parse(Input.data(), Input.size(), true);
+                DStatistics.DBytesParsed += Input.size();
+                DStatistics.DChunkCount++;
+                break;
+            }
+        }
+        Merge(Ingests);
+        DStatistics.DParseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - ParseStart).count();
+    }
 
     SImplementation(std::shared_ptr<CXMLReader> src){
-        SXMLEntity TempEntity;
+        // Elements and attributes are matched by interned name, and values are read in place
+        const auto OSMName = src->Intern("osm");
+        const auto NodeName = src->Intern("node");
+        const auto WayName = src->Intern("way");
+        const auto NDName = src->Intern("nd");
+        const auto TagName = src->Intern("tag");
+        const auto IDName = src->Intern("id");
+        const auto LatName = src->Intern("lat");
+        const auto LonName = src->Intern("lon");
+        const auto RefName = src->Intern("ref");
+        const auto KeyName = src->Intern("k");
+        const auto ValueName = src->Intern("v");
+        SXMLEntityView TempEntity;
 
         while(src->ReadEntity(TempEntity,true)){
-            if((TempEntity.DNameData == "osm")&&(SXMLEntity::EType::EndElement == TempEntity.DType)){
+            if((TempEntity.DNameID == OSMName)&&(SXMLEntity::EType::EndElement == TempEntity.DType)){
                 //reached end
                 break;
             }
-            else if((TempEntity.DNameData == "node")&&(SXMLEntity::EType::StartElement == TempEntity.DType)){
-                //parse node
-                TNodeID NewNodeID = std::stoull(TempEntity.AttributeValue("id"));
-                double Lat = std::stod(TempEntity.AttributeValue("lat"));
-                double Lon = std::stod(TempEntity.AttributeValue("lon"));
+            else if((TempEntity.DNameID == NodeName)&&(SXMLEntity::EType::StartElement == TempEntity.DType)){
+                //parse node, the reader ends each value with a null so it converts in place
+                TNodeID NewNodeID = std::strtoull(TempEntity.AttributeValue(IDName).data(), nullptr, 10);
+                double Lat = std::strtod(TempEntity.AttributeValue(LatName).data(), nullptr);
+                double Lon = std::strtod(TempEntity.AttributeValue(LonName).data(), nullptr);
                 TLocation NewNodeLocation = std::make_pair(Lat,Lon);
-                auto NewNode = std::make_shared<SNode>(NewNodeID,NewNodeLocation);
-                DNodesByIndex.push_back(NewNode);
-                DNodeIDToNode[NewNodeID] = NewNode;
+                auto NewNode = AddNode(NewNodeID,NewNodeLocation);
                 while(src->ReadEntity(TempEntity,true)){
-                    if((TempEntity.DNameData == "node")&&(SXMLEntity::EType::EndElement == TempEntity.DType)){
+                    if((TempEntity.DNameID == NodeName)&&(SXMLEntity::EType::EndElement == TempEntity.DType)){
                         break;
                     }
-                    else if((TempEntity.DNameData == "tag")&&(SXMLEntity::EType::StartElement == TempEntity.DType)){
-                        NewNode->SetAttribute(TempEntity.AttributeValue("k"),TempEntity.AttributeValue("v"));
+                    else if((TempEntity.DNameID == TagName)&&(SXMLEntity::EType::StartElement == TempEntity.DType)){
+                        NewNode->SetAttribute(std::string(TempEntity.AttributeValue(KeyName)),std::string(TempEntity.AttributeValue(ValueName)));
                     }
                 }
             }
 
-            else if((TempEntity.DNameData == "way")&&(SXMLEntity::EType::StartElement == TempEntity.DType)){
+            else if((TempEntity.DNameID == WayName)&&(SXMLEntity::EType::StartElement == TempEntity.DType)){
                 //parse way
-                TWayID NewWayID = std::stoull(TempEntity.AttributeValue("id"));
+                TWayID NewWayID = std::strtoull(TempEntity.AttributeValue(IDName).data(), nullptr, 10);
                 auto NewWay = std::make_shared<SWay>();
                 NewWay->WID = NewWayID;
 
                 // Read nested entities within the way element
                 while(src->ReadEntity(TempEntity, true)){
                     // If it's the end of the way element, break the loop
-                    if((TempEntity.DNameData == "way") && (SXMLEntity::EType::EndElement == TempEntity.DType)){
+                    if((TempEntity.DNameID == WayName) && (SXMLEntity::EType::EndElement == TempEntity.DType)){
                         break;
                     }
                     // If it's a node reference (nd element), add the node ID to the way's node list
-                    else if((TempEntity.DNameData == "nd") && (SXMLEntity::EType::StartElement == TempEntity.DType)){
-                        TNodeID NodeID = std::stoull(TempEntity.AttributeValue("ref"));
+                    else if((TempEntity.DNameID == NDName) && (SXMLEntity::EType::StartElement == TempEntity.DType)){
+                        TNodeID NodeID = std::strtoull(TempEntity.AttributeValue(RefName).data(), nullptr, 10);
                         NewWay->NodeIDs.push_back(NodeID);
                     }
                     // If it's a tag element, add the attribute to the way's attribute map
-                    else if((TempEntity.DNameData == "tag") && (SXMLEntity::EType::StartElement == TempEntity.DType)){
-                        std::string Key = TempEntity.AttributeValue("k");
-                        std::string Value = TempEntity.AttributeValue("v");
+                    else if((TempEntity.DNameID == TagName) && (SXMLEntity::EType::StartElement == TempEntity.DType)){
+                        std::string Key(TempEntity.AttributeValue(KeyName));
+                        std::string Value(TempEntity.AttributeValue(ValueName));
                         NewWay->Attributes[Key] = Value;
                     }
                 }
                 // Once all nd and tag elements have been processed, add the way to the data structures
-                DWayIDToWay[NewWayID] = NewWay;
-                DWaysByIndex.push_back(NewWay);
+                AddWay(NewWay);
             }
         }
+        DStatistics = src->ParseStatistics();
     }
 
     std::size_t NodeCount() const noexcept{
@@ -219,8 +567,17 @@ struct COpenStreetMap::SImplementation{
 COpenStreetMap::COpenStreetMap(std::shared_ptr<CXMLReader> src){
     DImplementation=std::make_unique<SImplementation>(src);
 }
+COpenStreetMap::COpenStreetMap(std::shared_ptr<CDataSource> src, std::size_t chunksize){
+    DImplementation=std::make_unique<SImplementation>(src, chunksize);
+}
+COpenStreetMap::COpenStreetMap(std::shared_ptr<CDataSource> src, CThreadPool &pool, std::size_t splitsize, std::size_t chunksize){
+    DImplementation=std::make_unique<SImplementation>(src, pool, splitsize, chunksize);
+}
 COpenStreetMap::~COpenStreetMap()=default;
 
+CXMLReader::SParseStatistics COpenStreetMap::ParseStatistics() const noexcept{
+    return DImplementation->DStatistics;
+}
 std::size_t COpenStreetMap::NodeCount() const noexcept{
     return DImplementation->NodeCount();
 }
@@ -0,0 +1,140 @@
+#include "PathCache.h"
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+struct CPathCache::SImplementation{
+    struct SKeyHash{
+        std::size_t operator()(const SKey &key) const noexcept{
+            auto Hash = std::hash< TNodeID >()(key.DSource) * 31 + std::hash< TNodeID >()(key.DDestination);
+            return Hash * 3 + static_cast< std::size_t >(key.DMetric);
+        }
+    };
+
+    // The front of DEntries is the most recently used, DIndex finds an entry's place in the list
+    struct SShard{
+        std::mutex DMutex;
+        std::list< std::pair< SKey, SEntry > > DEntries;
+        std::unordered_map< SKey, std::list< std::pair< SKey, SEntry > >::iterator, SKeyHash > DIndex;
+    };
+
+    std::vector< std::unique_ptr< SShard > > DShards;
+    std::size_t DShardCapacity = 0;
+    std::atomic< std::size_t > DHits{0};
+    std::atomic< std::size_t > DMisses{0};
+
+    SImplementation(std::size_t capacity, std::size_t shards){
+        // Fewer shards than requested when there are fewer entries than shards
+        auto ShardCount = std::max< std::size_t >(1, std::min(shards, capacity));
+        DShardCapacity = (capacity + ShardCount - 1) / ShardCount;
+        for(std::size_t Index = 0; Index < ShardCount; Index++){
+            DShards.push_back(std::make_unique< SShard >());
+        }
+    }
+
+    SShard &ShardOf(const SKey &key) const{
+        // The low bits pick the slot within a shard's table, so the high bits pick the shard
+        auto Hash = SKeyHash()(key);
+        return *DShards[(Hash ^ (Hash >> 16)) % DShards.size()];
+    }
+
+    bool Find(const SKey &key, SEntry &entry){
+        auto &Shard = ShardOf(key);
+        {
+            std::lock_guard< std::mutex > Lock(Shard.DMutex);
+            auto Search = Shard.DIndex.find(key);
+            if(Search != Shard.DIndex.end()){
+                Shard.DEntries.splice(Shard.DEntries.begin(), Shard.DEntries, Search->second);
+                entry = Search->second->second;
+                DHits++;
+                return true;
+            }
+        }
+        DMisses++;
+        return false;
+    }
+
+    void Insert(const SKey &key, SEntry entry){
+        if(!DShardCapacity){
+            return;
+        }
+        auto &Shard = ShardOf(key);
+        std::lock_guard< std::mutex > Lock(Shard.DMutex);
+        auto Search = Shard.DIndex.find(key);
+        if(Search != Shard.DIndex.end()){
+            Search->second->second = std::move(entry);
+            Shard.DEntries.splice(Shard.DEntries.begin(), Shard.DEntries, Search->second);
+            return;
+        }
+        if(Shard.DEntries.size() >= DShardCapacity){
+            Shard.DIndex.erase(Shard.DEntries.back().first);
+            Shard.DEntries.pop_back();
+        }
+        Shard.DEntries.emplace_front(key, std::move(entry));
+        Shard.DIndex[key] = Shard.DEntries.begin();
+    }
+
+    std::size_t Size() const{
+        std::size_t Total = 0;
+        for(auto &Shard : DShards){
+            std::lock_guard< std::mutex > Lock(Shard->DMutex);
+            Total += Shard->DEntries.size();
+        }
+        return Total;
+    }
+
+    void Clear(){
+        for(auto &Shard : DShards){
+            std::lock_guard< std::mutex > Lock(Shard->DMutex);
+            Shard->DIndex.clear();
+            Shard->DEntries.clear();
+        }
+    }
+};
+
+CPathCache::CPathCache(std::size_t capacity, std::size_t shards){
+    DImplementation = std::make_unique<SImplementation>(capacity, shards);
+}
+
+CPathCache::~CPathCache(){
+
+}
+
+std::size_t CPathCache::Capacity() const noexcept{
+    return DImplementation->DShardCapacity * DImplementation->DShards.size();
+}
+
+std::size_t CPathCache::ShardCount() const noexcept{
+    return DImplementation->DShards.size();
+}
+
+std::size_t CPathCache::Size() const{
+    return DImplementation->Size();
+}
+
+std::size_t CPathCache::Hits() const noexcept{
+    return DImplementation->DHits;
+}
+
+std::size_t CPathCache::Misses() const noexcept{
+    return DImplementation->DMisses;
+}
+
+bool CPathCache::Find(const SKey &key, SEntry &entry){
+    return DImplementation->Find(key, entry);
+}
+
+void CPathCache::Insert(const SKey &key, SEntry entry){
+    DImplementation->Insert(key, std::move(entry));
+}
+
+void CPathCache::Clear(){
+    DImplementation->Clear();
+}
+
+void CPathCache::ResetCounters() noexcept{
+    DImplementation->DHits = 0;
+    DImplementation->DMisses = 0;
+}
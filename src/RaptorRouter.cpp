@@ -0,0 +1,285 @@
+#include "RaptorRouter.h"
+#include <algorithm>
+#include <stdexcept>
+
+struct CRaptorRouter::SImplementation{
+    // Arrival at a stop in a round and the leg that reached it. DRound is the round of the label the
+    // leg continues from: the previous round's label for a ride and this round's ride label for a
+    // transfer.
+    struct SLabel{
+        double DTime;
+        SLeg DLeg;
+        std::size_t DRound;
+    };
+
+    struct SWorkspace : public SQueryWorkspace{
+        // Labels of every round, round k of stop s at k * StopCount + s. DRideLabels only holds the
+        // arrivals by ride, which the transfers of the same round start from.
+        std::vector< SLabel > DLabels;
+        std::vector< SLabel > DRideLabels;
+        std::vector< double > DBest;
+        std::vector< bool > DMarked;
+        std::vector< TStopIndex > DMarkedStops;
+        std::vector< std::pair< TStopIndex, double > > DRideImproved;
+        std::vector< std::size_t > DRouteQueue;
+        std::vector< TRouteIndex > DQueuedRoutes;
+    };
+
+    // The workspace as created by this router, another router's workspace is a caller error
+    static SWorkspace &OwnWorkspace(SQueryWorkspace &workspace){
+        auto Workspace = dynamic_cast< SWorkspace * >(&workspace);
+        if(!Workspace){
+            throw std::invalid_argument("CRaptorRouter: workspace was created by another router");
+        }
+        return *Workspace;
+    }
+
+    std::size_t DStopCount;
+    double DBoardTime;
+    double DAlightTime;
+
+    // Stops of route r are DRouteStops[DRouteOffsets[r]] to DRouteStops[DRouteOffsets[r + 1] - 1],
+    // DRouteTimes holds the ride time from the route's first stop to each of them
+    std::vector< std::size_t > DRouteOffsets;
+    std::vector< TStopIndex > DRouteStops;
+    std::vector< double > DRouteTimes;
+
+    // Routes serving stop s with the stop's position on them, from DStopRouteOffsets[s] to DStopRouteOffsets[s + 1]
+    std::vector< std::size_t > DStopRouteOffsets;
+    std::vector< std::pair< TRouteIndex, std::size_t > > DStopRoutes;
+
+    // Transfers leaving stop s, from DTransferOffsets[s] to DTransferOffsets[s + 1]
+    std::vector< std::size_t > DTransferOffsets;
+    std::vector< std::pair< TStopIndex, double > > DTransfers;
+
+    SImplementation(std::size_t stopcount, const std::vector< SRoute > &routes, const std::vector< STransfer > &transfers, double boardtime, double alighttime){
+        DStopCount = stopcount;
+        DBoardTime = boardtime;
+        DAlightTime = alighttime;
+        DRouteOffsets.push_back(0);
+        std::vector< std::size_t > StopRouteCounts(stopcount + 1, 0);
+        for(auto &Route : routes){
+            double Time = 0.0;
+            for(std::size_t Index = 0; Index < Route.DStops.size(); Index++){
+                if(Index){
+                    Time += Route.DRideTimes[Index - 1];
+                }
+                DRouteStops.push_back(Route.DStops[Index]);
+                DRouteTimes.push_back(Time);
+                StopRouteCounts[Route.DStops[Index] + 1]++;
+            }
+            DRouteOffsets.push_back(DRouteStops.size());
+        }
+        // Counting sort of the route stops by stop
+        for(std::size_t Index = 1; Index <= stopcount; Index++){
+            StopRouteCounts[Index] += StopRouteCounts[Index - 1];
+        }
+        DStopRouteOffsets = StopRouteCounts;
+        DStopRoutes.resize(DRouteStops.size());
+        for(std::size_t RouteIndex = 0; RouteIndex + 1 < DRouteOffsets.size(); RouteIndex++){
+            for(std::size_t Offset = DRouteOffsets[RouteIndex]; Offset < DRouteOffsets[RouteIndex + 1]; Offset++){
+                DStopRoutes[StopRouteCounts[DRouteStops[Offset]]++] = std::make_pair(RouteIndex, Offset - DRouteOffsets[RouteIndex]);
+            }
+        }
+        DTransferOffsets.assign(stopcount + 1, 0);
+        for(auto &Transfer : transfers){
+            DTransferOffsets[Transfer.DSource + 1]++;
+        }
+        for(std::size_t Index = 1; Index <= stopcount; Index++){
+            DTransferOffsets[Index] += DTransferOffsets[Index - 1];
+        }
+        auto TransferPositions = DTransferOffsets;
+        DTransfers.resize(transfers.size());
+        for(auto &Transfer : transfers){
+            DTransfers[TransferPositions[Transfer.DSource]++] = std::make_pair(Transfer.DDestination, Transfer.DTime);
+        }
+    }
+
+    std::size_t RouteCount() const noexcept{
+        return DRouteOffsets.size() - 1;
+    }
+
+    TStopIndex RouteStop(TRouteIndex route, std::size_t index) const noexcept{
+        if((route >= RouteCount())||(index >= DRouteOffsets[route + 1] - DRouteOffsets[route])){
+            return InvalidIndex;
+        }
+        return DRouteStops[DRouteOffsets[route] + index];
+    }
+
+    std::unique_ptr< SQueryWorkspace > CreateWorkspace() const{
+        return std::make_unique< SWorkspace >();
+    }
+
+    static void Mark(SWorkspace &workspace, TStopIndex stop){
+        if(!workspace.DMarked[stop]){
+            workspace.DMarked[stop] = true;
+            workspace.DMarkedStops.push_back(stop);
+        }
+    }
+
+    double FindFastestJourney(const std::vector< std::pair< TStopIndex, double > > &access, const std::vector< std::pair< TStopIndex, double > > &egress, std::size_t maxrounds, std::vector< SLeg > &legs, SQueryWorkspace &workspace) const{
+        auto &Workspace = OwnWorkspace(workspace);
+        const SLabel Unreached = {NoPathExists, {ELegType::Access, InvalidIndex, InvalidIndex, InvalidIndex, InvalidIndex, InvalidIndex}, InvalidIndex};
+        auto &Labels = Workspace.DLabels;
+        auto &RideLabels = Workspace.DRideLabels;
+        auto &Best = Workspace.DBest;
+        Labels.assign((maxrounds + 1) * DStopCount, Unreached);
+        RideLabels.assign((maxrounds + 1) * DStopCount, Unreached);
+        Best.assign(DStopCount, NoPathExists);
+        Workspace.DMarked.assign(DStopCount, false);
+        Workspace.DMarkedStops.clear();
+        Workspace.DRouteQueue.assign(RouteCount(), InvalidIndex);
+        Workspace.DQueuedRoutes.clear();
+
+        for(auto &Access : access){
+            if((Access.first < DStopCount)&&(Access.second < Best[Access.first])){
+                Labels[Access.first] = {Access.second, {ELegType::Access, InvalidIndex, Access.first, InvalidIndex, InvalidIndex, InvalidIndex}, InvalidIndex};
+                Best[Access.first] = Access.second;
+                Mark(Workspace, Access.first);
+            }
+        }
+
+        double BestJourney = NoPathExists;
+        std::size_t BestRound = InvalidIndex;
+        TStopIndex BestStop = InvalidIndex;
+        for(std::size_t Round = 1; (Round <= maxrounds) && !Workspace.DMarkedStops.empty(); Round++){
+            auto *Previous = &Labels[(Round - 1) * DStopCount];
+            auto *Current = &Labels[Round * DStopCount];
+            auto *CurrentRides = &RideLabels[Round * DStopCount];
+            std::copy(Previous, Previous + DStopCount, Current);
+
+            // Queue each route served by a marked stop from the earliest marked stop on it
+            for(auto Stop : Workspace.DMarkedStops){
+                Workspace.DMarked[Stop] = false;
+                for(std::size_t Offset = DStopRouteOffsets[Stop]; Offset < DStopRouteOffsets[Stop + 1]; Offset++){
+                    auto &StopRoute = DStopRoutes[Offset];
+                    auto &Queued = Workspace.DRouteQueue[StopRoute.first];
+                    if(Queued == InvalidIndex){
+                        Workspace.DQueuedRoutes.push_back(StopRoute.first);
+                        Queued = StopRoute.second;
+                    }
+                    Queued = std::min(Queued, StopRoute.second);
+                }
+            }
+            Workspace.DMarkedStops.clear();
+
+            // Ride each queued route, boarding wherever the previous round gets on it earlier
+            Workspace.DRideImproved.clear();
+            for(auto RouteIndex : Workspace.DQueuedRoutes){
+                auto First = DRouteOffsets[RouteIndex];
+                auto Count = DRouteOffsets[RouteIndex + 1] - First;
+                std::size_t BoardIndex = InvalidIndex;
+                double Departure = NoPathExists;
+                for(std::size_t Index = Workspace.DRouteQueue[RouteIndex]; Index < Count; Index++){
+                    auto Stop = DRouteStops[First + Index];
+                    double RideTime = BoardIndex == InvalidIndex ? 0.0 : DRouteTimes[First + Index] - DRouteTimes[First + BoardIndex];
+                    if(BoardIndex != InvalidIndex){
+                        double Arrival = Departure + RideTime + DAlightTime;
+                        if((Arrival < Best[Stop])&&(Arrival < BestJourney)){
+                            SLabel Label = {Arrival, {ELegType::Ride, DRouteStops[First + BoardIndex], Stop, RouteIndex, BoardIndex, Index}, Round - 1};
+                            if(CurrentRides[Stop].DTime == NoPathExists){
+                                Workspace.DRideImproved.push_back(std::make_pair(Stop, Arrival));
+                            }
+                            Current[Stop] = Label;
+                            CurrentRides[Stop] = Label;
+                            Best[Stop] = Arrival;
+                            Mark(Workspace, Stop);
+                        }
+                    }
+                    if(Previous[Stop].DTime != NoPathExists){
+                        double Boarded = Previous[Stop].DTime + DBoardTime;
+                        if((BoardIndex == InvalidIndex)||(Boarded < Departure + RideTime)){
+                            BoardIndex = Index;
+                            Departure = Boarded;
+                        }
+                    }
+                }
+                Workspace.DRouteQueue[RouteIndex] = InvalidIndex;
+            }
+            Workspace.DQueuedRoutes.clear();
+
+            // Walk the transfers from the stops reached by ride, starting from the ride arrivals
+            for(auto &Improved : Workspace.DRideImproved){
+                auto Source = Improved.first;
+                double Arrival = CurrentRides[Source].DTime;
+                for(std::size_t Offset = DTransferOffsets[Source]; Offset < DTransferOffsets[Source + 1]; Offset++){
+                    auto &Transfer = DTransfers[Offset];
+                    double TransferArrival = Arrival + Transfer.second;
+                    if((TransferArrival < Best[Transfer.first])&&(TransferArrival < BestJourney)){
+                        Current[Transfer.first] = {TransferArrival, {ELegType::Transfer, Source, Transfer.first, InvalidIndex, InvalidIndex, InvalidIndex}, Round};
+                        Best[Transfer.first] = TransferArrival;
+                        Mark(Workspace, Transfer.first);
+                    }
+                }
+            }
+
+            for(auto &Egress : egress){
+                if((Egress.first < DStopCount)&&(Current[Egress.first].DLeg.DType != ELegType::Access)&&(Current[Egress.first].DTime != NoPathExists)){
+                    double Journey = Current[Egress.first].DTime + Egress.second;
+                    if(Journey < BestJourney){
+                        BestJourney = Journey;
+                        BestRound = Round;
+                        BestStop = Egress.first;
+                    }
+                }
+            }
+        }
+        for(auto Stop : Workspace.DMarkedStops){
+            Workspace.DMarked[Stop] = false;
+        }
+        Workspace.DMarkedStops.clear();
+
+        legs.clear();
+        if(BestJourney == NoPathExists){
+            return NoPathExists;
+        }
+        legs.push_back({ELegType::Egress, BestStop, InvalidIndex, InvalidIndex, InvalidIndex, InvalidIndex});
+        std::size_t Round = BestRound;
+        TStopIndex Stop = BestStop;
+        bool RideLabel = false;
+        while(true){
+            auto &Label = RideLabel ? RideLabels[Round * DStopCount + Stop] : Labels[Round * DStopCount + Stop];
+            legs.push_back(Label.DLeg);
+            if(Label.DLeg.DType == ELegType::Access){
+                break;
+            }
+            RideLabel = Label.DLeg.DType == ELegType::Transfer;
+            Round = Label.DRound;
+            Stop = Label.DLeg.DSource;
+        }
+        std::reverse(legs.begin(), legs.end());
+        return BestJourney;
+    }
+};
+
+CRaptorRouter::CRaptorRouter(std::size_t stopcount, const std::vector< SRoute > &routes, const std::vector< STransfer > &transfers, double boardtime, double alighttime){
+    DImplementation = std::make_unique<SImplementation>(stopcount, routes, transfers, boardtime, alighttime);
+}
+
+CRaptorRouter::~CRaptorRouter(){
+
+}
+
+std::size_t CRaptorRouter::StopCount() const noexcept{
+    return DImplementation->DStopCount;
+}
+
+std::size_t CRaptorRouter::RouteCount() const noexcept{
+    return DImplementation->RouteCount();
+}
+
+std::size_t CRaptorRouter::TransferCount() const noexcept{
+    return DImplementation->DTransfers.size();
+}
+
+CRaptorRouter::TStopIndex CRaptorRouter::RouteStop(TRouteIndex route, std::size_t index) const noexcept{
+    return DImplementation->RouteStop(route, index);
+}
+
+std::unique_ptr<CRaptorRouter::SQueryWorkspace> CRaptorRouter::CreateWorkspace() const{
+    return DImplementation->CreateWorkspace();
+}
+
+double CRaptorRouter::FindFastestJourney(const std::vector< std::pair< TStopIndex, double > > &access, const std::vector< std::pair< TStopIndex, double > > &egress, std::size_t maxrounds, std::vector< SLeg > &legs, SQueryWorkspace &workspace) const{
+    return DImplementation->FindFastestJourney(access, egress, maxrounds, legs, workspace);
+}
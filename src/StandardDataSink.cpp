@@ -9,4 +9,9 @@ bool CStandardDataSink::Put(const char &ch) noexcept{
 bool CStandardDataSink::Write(const std::vector<char> &buf) noexcept{
     std::cout.write(buf.data(),buf.size());
     return std::cout.good();
-}
\ No newline at end of file
+}
+
+bool CStandardDataSink::Flush() noexcept{
+    std::cout.flush();
+    return std::cout.good();
+}
@@ -1,11 +1,21 @@
 #include "StandardDataSource.h"
+#include <algorithm>
 #include <iostream>
 
+namespace{
+    // Longest line Chunk takes from std::cin at a time
+    const std::size_t MaxChunkSize = 4096;
+}
+
 bool CStandardDataSource::End() const noexcept{
-    return std::cin.eof();
+    return (DIndex >= DBuffer.size()) && std::cin.eof();
 }
 
 bool CStandardDataSource::Get(char &ch) noexcept{
+    if(DIndex < DBuffer.size()){
+        ch = DBuffer[DIndex++];
+        return true;
+    }
     if(!std::cin.good()){
         return false;
     }
@@ -17,6 +27,10 @@ bool CStandardDataSource::Get(char &ch) noexcept{
 }
 
 bool CStandardDataSource::Peek(char &ch) noexcept{
+    if(DIndex < DBuffer.size()){
+        ch = DBuffer[DIndex];
+        return true;
+    }
     if(!std::cin.good()){
         return false;
     }
@@ -25,9 +39,6 @@ bool CStandardDataSource::Peek(char &ch) noexcept{
 }
 
 bool CStandardDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
-    if(!std::cin.good()){
-        return false;
-    }
     char TempCh;
     buf.clear();
     buf.reserve(count);
@@ -36,3 +47,29 @@ bool CStandardDataSource::Read(std::vector<char> &buf, std::size_t count) noexce
     }
     return !buf.empty();
 }
+
+std::pair< const char *, std::size_t > CStandardDataSource::Chunk() noexcept{
+    if(DIndex < DBuffer.size()){
+        return std::make_pair(DBuffer.data() + DIndex, DBuffer.size() - DIndex);
+    }
+    // Takes at most one line, so interactive input is not waited on past a newline
+    // Read straight from std::cin, Get would serve the bytes back from the buffer being filled
+    DBuffer.clear();
+    DIndex = 0;
+    while(DBuffer.size() < MaxChunkSize && std::cin.good()){
+        auto TempCh = std::cin.get();
+        if(TempCh == EOF){
+            break;
+        }
+        DBuffer.push_back(TempCh);
+        if(TempCh == '\n'){
+            break;
+        }
+        std::cin.peek();
+    }
+    return std::make_pair(DBuffer.data(), DBuffer.size());
+}
+
+void CStandardDataSource::Advance(std::size_t count) noexcept{
+    DIndex += std::min(count, DBuffer.size() - DIndex);
+}
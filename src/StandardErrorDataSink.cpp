@@ -9,4 +9,9 @@ bool CStandardErrorDataSink::Put(const char &ch) noexcept{
 bool CStandardErrorDataSink::Write(const std::vector<char> &buf) noexcept{
     std::cerr.write(buf.data(),buf.size());
     return std::cerr.good();
-}
\ No newline at end of file
+}
+
+bool CStandardErrorDataSink::Flush() noexcept{
+    std::cerr.flush();
+    return std::cerr.good();
+}
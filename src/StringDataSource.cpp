@@ -1,4 +1,5 @@
 #include "StringDataSource.h"
+#include <algorithm>
 
 CStringDataSource::CStringDataSource(const std::string &str) : DString(str), DIndex(0){
 
@@ -26,15 +27,24 @@ bool CStringDataSource::Peek(char &ch) noexcept{
 }
 
 bool CStringDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
-    buf.clear();
-    while(buf.size() < count){
-        char TempChar;
-        if(Get(TempChar)){
-            buf.push_back(TempChar);
-        }
-        else{
-            break;
-        }
-    }
+    auto Chunk = this->Chunk();
+    auto Count = std::min(count, Chunk.second);
+    buf.assign(Chunk.first, Chunk.first + Count);
+    DIndex += Count;
     return !buf.empty();
 }
+
+std::pair< const char *, std::size_t > CStringDataSource::Chunk() noexcept{
+    if(DIndex < DString.length()){
+        return std::make_pair(DString.data() + DIndex, DString.length() - DIndex);
+    }
+    return std::make_pair(DString.data() + DString.length(), 0);
+}
+
+void CStringDataSource::Advance(std::size_t count) noexcept{
+    DIndex += std::min(count, Chunk().second);
+}
+
+bool CStringDataSource::StableChunks() const noexcept{
+    return true;
+}
@@ -0,0 +1,169 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct CThreadPool::SImplementation{
+    // Range of indices [first, second) run as one unit of work
+    using TChunk = std::pair< std::size_t, std::size_t >;
+    // Chunks per worker a ParallelFor is split into, more chunks balance better but cost more locking
+    static constexpr std::size_t ChunksPerWorker = 8;
+
+    struct SWorkerQueue{
+        std::mutex DMutex;
+        std::deque< TChunk > DChunks;
+    };
+
+    std::vector< std::thread > DThreads;
+    std::vector< std::unique_ptr< SWorkerQueue > > DQueues;
+
+    // State of the ParallelFor in progress, guarded by DMutex
+    std::mutex DMutex;
+    std::condition_variable DWorkAvailable;
+    std::condition_variable DWorkDone;
+    const TTask *DTask = nullptr;
+    std::size_t DGeneration = 0;
+    std::size_t DRemainingChunks = 0;
+    std::exception_ptr DException;
+    bool DStopping = false;
+
+    // Serializes concurrent ParallelFor calls on the same pool
+    std::mutex DCallMutex;
+
+    SImplementation(std::size_t threads){
+        if(!threads){
+            threads = std::max< std::size_t >(1, std::thread::hardware_concurrency());
+        }
+        for(std::size_t Index = 0; Index < threads; Index++){
+            DQueues.push_back(std::make_unique< SWorkerQueue >());
+        }
+        for(std::size_t Index = 0; Index < threads; Index++){
+            DThreads.emplace_back([this, Index](){
+                WorkerLoop(Index);
+            });
+        }
+    }
+
+    ~SImplementation(){
+        {
+            std::lock_guard< std::mutex > Lock(DMutex);
+            DStopping = true;
+        }
+        DWorkAvailable.notify_all();
+        for(auto &Thread : DThreads){
+            Thread.join();
+        }
+    }
+
+    // Takes a chunk from the back of the worker's own queue, or steals from the front of another.
+    bool TakeChunk(std::size_t worker, TChunk &chunk){
+        {
+            auto &Own = *DQueues[worker];
+            std::lock_guard< std::mutex > Lock(Own.DMutex);
+            if(!Own.DChunks.empty()){
+                chunk = Own.DChunks.back();
+                Own.DChunks.pop_back();
+                return true;
+            }
+        }
+        for(std::size_t Offset = 1; Offset < DQueues.size(); Offset++){
+            auto &Victim = *DQueues[(worker + Offset) % DQueues.size()];
+            std::lock_guard< std::mutex > Lock(Victim.DMutex);
+            if(!Victim.DChunks.empty()){
+                chunk = Victim.DChunks.front();
+                Victim.DChunks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(std::size_t worker){
+        std::size_t SeenGeneration = 0;
+        while(true){
+            {
+                std::unique_lock< std::mutex > Lock(DMutex);
+                DWorkAvailable.wait(Lock, [&](){ return DStopping || (SeenGeneration != DGeneration); });
+                if(DStopping){
+                    return;
+                }
+                SeenGeneration = DGeneration;
+            }
+            TChunk Chunk;
+            while(TakeChunk(worker, Chunk)){
+                // Chunks are queued under DMutex together with their task, so reading it here
+                // always gives the task the chunk belongs to
+                const TTask *Task;
+                {
+                    std::lock_guard< std::mutex > Lock(DMutex);
+                    Task = DTask;
+                }
+                std::exception_ptr Exception;
+                try{
+                    for(auto Index = Chunk.first; Index < Chunk.second; Index++){
+                        (*Task)(Index, worker);
+                    }
+                }
+                catch(...){
+                    Exception = std::current_exception();
+                }
+                std::lock_guard< std::mutex > Lock(DMutex);
+                if(Exception && !DException){
+                    DException = Exception;
+                }
+                if(!--DRemainingChunks){
+                    DWorkDone.notify_all();
+                }
+            }
+        }
+    }
+
+    void ParallelFor(std::size_t count, const TTask &task){
+        if(!count){
+            return;
+        }
+        std::lock_guard< std::mutex > CallLock(DCallMutex);
+        std::size_t ChunkSize = std::max< std::size_t >(1, count / (DQueues.size() * ChunksPerWorker));
+        std::exception_ptr Exception;
+        {
+            std::unique_lock< std::mutex > Lock(DMutex);
+            DTask = &task;
+            DRemainingChunks = 0;
+            for(std::size_t First = 0; First < count; First += ChunkSize){
+                auto &Queue = *DQueues[DRemainingChunks % DQueues.size()];
+                std::lock_guard< std::mutex > QueueLock(Queue.DMutex);
+                Queue.DChunks.push_back(std::make_pair(First, std::min(First + ChunkSize, count)));
+                DRemainingChunks++;
+            }
+            DException = nullptr;
+            DGeneration++;
+            DWorkAvailable.notify_all();
+            DWorkDone.wait(Lock, [&](){ return !DRemainingChunks; });
+            DTask = nullptr;
+            Exception = DException;
+        }
+        if(Exception){
+            std::rethrow_exception(Exception);
+        }
+    }
+};
+
+CThreadPool::CThreadPool(std::size_t threads){
+    DImplementation = std::make_unique<SImplementation>(threads);
+}
+
+CThreadPool::~CThreadPool(){
+
+}
+
+std::size_t CThreadPool::ThreadCount() const noexcept{
+    return DImplementation->DThreads.size();
+}
+
+void CThreadPool::ParallelFor(std::size_t count, const TTask &task){
+    DImplementation->ParallelFor(count, task);
+}
@@ -1,109 +1,180 @@
 #include "XMLReader.h"
 #include "XMLEntity.h"
-#include "StringDataSource.h"
+#include "XMLParseFeeder.h"
 #include <expat.h>
-#include <queue>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
 struct CXMLReader::SImplementation{
+    // Entity parsed but not read yet. Character data is in DArena at DDataOffset, and the attributes
+    // are DAttributeRecords[DAttributeBegin, DAttributeEnd).
+    struct SRecord{
+        SXMLEntity::EType DType;
+        TNameID DNameID;
+        std::size_t DDataOffset;
+        std::size_t DDataLength;
+        std::size_t DAttributeBegin;
+        std::size_t DAttributeEnd;
+    };
+    struct SAttributeRecord{
+        TNameID DNameID;
+        std::size_t DValueOffset;
+        std::size_t DValueLength;
+    };
+
     std::shared_ptr<CDataSource> DDataSource;
     XML_Parser DXMLParser;
-    std::queue<SXMLEntity>DEntityQueue;
-    void StartELementHandler(const std::string &name, const std::vector<std::string> &attrs){
-        SXMLEntity TempEntity;
-        TempEntity.DNameData=name;
-        TempEntity.DType=SXMLEntity::EType::StartElement;
-        for(size_t Index=0; Index <attrs.size(); Index+=2){
-            TempEntity.SetAttribute(attrs[Index], attrs[Index+1]);
+    bool DEndOfData = false;
+    // Set while expat is stopped with entities left to parse, which resuming it will report
+    bool DSuspended = false;
+    CXMLParseFeeder DFeeder;
+    std::size_t DMaxQueuedEntities;
+    std::size_t DPeakQueuedEntities = 0;
+
+    // Interned names, the deque keeps each string in place so the map's keys and the views stay valid
+    std::deque<std::string> DNames;
+    std::unordered_map<std::string_view, TNameID> DNameIDs;
+
+    // Entities of the last parsed chunk, their storage is reused once all have been read. Values in
+    // the arena are followed by a null so they can be converted in place.
+    std::vector<SRecord> DRecords;
+    std::size_t DNextRecord = 0;
+    std::vector<SAttributeRecord> DAttributeRecords;
+    std::vector<char> DArena;
+    std::vector<SXMLEntityView::SAttribute> DAttributeViews;
+
+    TNameID Intern(std::string_view name){
+        auto Search = DNameIDs.find(name);
+        if(Search != DNameIDs.end()){
+            return Search->second;
+        }
+        TNameID NameID = DNames.size();
+        DNames.emplace_back(name);
+        DNameIDs.emplace(DNames.back(), NameID);
+        return NameID;
+    }
+
+    std::size_t Store(const char *data, std::size_t length){
+        auto Offset = DArena.size();
+        DArena.insert(DArena.end(), data, data + length);
+        DArena.push_back('\0');
+        return Offset;
+    }
+
+    // Stops expat once enough entities are waiting, it reports the current one and returns suspended
+    void PushRecord(const SRecord &record){
+        DRecords.push_back(record);
+        if((DRecords.size() == DMaxQueuedEntities) && (XML_GetErrorCode(DXMLParser) == XML_ERROR_NONE)){
+            XML_StopParser(DXMLParser, XML_TRUE);
         }
-        DEntityQueue.push(TempEntity);
-    };
-    void EndElementHandler(const std::string &name){
-    SXMLEntity TempEntity;
-    TempEntity.DNameData = name;
-    TempEntity.DType = SXMLEntity::EType::EndElement;
-    DEntityQueue.push(TempEntity);
-    };
-    void CharacterDataHandler(const std::string &cdata){
-   if (!cdata.empty()) {
-        SXMLEntity TempEntity;
-        TempEntity.DType = SXMLEntity::EType::CharData;
-        TempEntity.DNameData = cdata;
-        DEntityQueue.push(TempEntity);
     }
-    };
 
     static void StartElementHandlerCallback(void *context, const XML_Char *name, const XML_Char **atts){
         SImplementation *ReaderObject=static_cast<SImplementation*>(context);
-        std::vector<std::string> Attributes;
-        auto Attrptr=atts;
-        while(*Attrptr){
-            Attributes.push_back(*Attrptr);
-            Attrptr++;
+        SRecord Record{SXMLEntity::EType::StartElement, ReaderObject->Intern(name), 0, 0, ReaderObject->DAttributeRecords.size(), 0};
+        for(auto Attrptr=atts; *Attrptr; Attrptr+=2){
+            auto ValueLength = std::strlen(Attrptr[1]);
+            ReaderObject->DAttributeRecords.push_back({ReaderObject->Intern(Attrptr[0]), ReaderObject->Store(Attrptr[1], ValueLength), ValueLength});
         }
-        ReaderObject->StartELementHandler(name,Attributes);
+        Record.DAttributeEnd = ReaderObject->DAttributeRecords.size();
+        ReaderObject->PushRecord(Record);
     };
     static void EndElementHandlerCallback(void *context, const XML_Char *name){
         SImplementation *ReaderObject=static_cast<SImplementation*>(context);
-        ReaderObject->EndElementHandler(name);
+        ReaderObject->PushRecord({SXMLEntity::EType::EndElement, ReaderObject->Intern(name), 0, 0, 0, 0});
     };
     static void CharacterDataHandlerCallback(void *context, const XML_Char *s, int len){
         SImplementation *ReaderObject=static_cast<SImplementation*>(context);
-        ReaderObject->CharacterDataHandler(std::string(s,len));
+        if(0 < len){
+            ReaderObject->PushRecord({SXMLEntity::EType::CharData, SXMLEntityView::InvalidNameID, ReaderObject->Store(s, len), std::size_t(len), 0, 0});
+        }
     };
 
-    SImplementation(std::shared_ptr<CDataSource> src){
+    SImplementation(std::shared_ptr<CDataSource> src, std::size_t chunksize, std::size_t maxqueued) : DFeeder(src, chunksize){
         DDataSource=src;
+        DMaxQueuedEntities=std::max<std::size_t>(maxqueued, 1);
         DXMLParser=XML_ParserCreate(NULL);
         XML_SetStartElementHandler(DXMLParser,  StartElementHandlerCallback);
         XML_SetEndElementHandler(DXMLParser, EndElementHandlerCallback);
         XML_SetCharacterDataHandler(DXMLParser, CharacterDataHandlerCallback);
         XML_SetUserData(DXMLParser,this);
     };
+    ~SImplementation(){
+        XML_ParserFree(DXMLParser);
+    }
     bool End() const{
-        return DEntityQueue.empty() && DDataSource->End();
+        return (DNextRecord >= DRecords.size()) && !DSuspended && DDataSource->End();
     };
-   bool ReadEntity(SXMLEntity &entity, bool skipcdata) {
-    if(DEntityQueue.empty()) {
-        std::vector<char> DataBuffer(1024); // Adjust buffer size as needed
-        size_t ReadLength = 0;
-        bool EndOfData = false;
-
-        // Keep reading and parsing until we find an entity or run out of data
-        while(DEntityQueue.empty() && !EndOfData) {
-            if(DDataSource->Read(DataBuffer, DataBuffer.size())) {
-                ReadLength = DataBuffer.size();
-            } else {
-                EndOfData = true; // No more data to read
-                ReadLength = 0; // Ensure we call XML_Parse with isFinal = true
+    bool ReadEntity(SXMLEntityView &entity, bool skipcdata) {
+        while(true){
+            // Now check if we have an entity left from the last chunk
+            while(DNextRecord < DRecords.size()) {
+                const SRecord &Record = DRecords[DNextRecord++];
+                if(skipcdata && Record.DType == SXMLEntity::EType::CharData) {
+                    continue; // Skip this entity and check the next one
+                }
+                // Found a suitable entity to return
+                entity.DType = Record.DType;
+                entity.DNameID = Record.DNameID;
+                if(Record.DType == SXMLEntity::EType::CharData){
+                    entity.DNameData = std::string_view(DArena.data() + Record.DDataOffset, Record.DDataLength);
+                }
+                else{
+                    entity.DNameData = DNames[Record.DNameID];
+                }
+                DAttributeViews.clear();
+                for(auto Index = Record.DAttributeBegin; Index < Record.DAttributeEnd; Index++){
+                    auto &Attribute = DAttributeRecords[Index];
+                    DAttributeViews.push_back({Attribute.DNameID, DNames[Attribute.DNameID], std::string_view(DArena.data() + Attribute.DValueOffset, Attribute.DValueLength)});
+                }
+                entity.DAttributes = DAttributeViews.data();
+                entity.DAttributeCount = DAttributeViews.size();
+                return true;
             }
-
-            // Parse the data read from the source
-            if(XML_Parse(DXMLParser, DataBuffer.data(), ReadLength, EndOfData) == XML_STATUS_ERROR) {
-                // Handle parsing error (not shown here)
+            if(DEndOfData && !DSuspended){
+                // No more data will arrive, so no suitable entity is left to return
                 return false;
             }
+
+            // Every entity has been read, so their storage is reused for the next chunk
+            DRecords.clear();
+            DNextRecord = 0;
+            DAttributeRecords.clear();
+            DArena.clear();
+            if(!Parse()){
+                // Entities parsed before the error are still returned
+                DEndOfData = true;
+                DSuspended = false;
+            }
         }
     }
-
-    // Now check if we have an entity in the queue
-    while(!DEntityQueue.empty()) {
-        const SXMLEntity& frontEntity = DEntityQueue.front();
-        if(skipcdata && frontEntity.DType == SXMLEntity::EType::CharData) {
-            DEntityQueue.pop(); // Skip this entity and check the next one
-            continue;
+    // Resumes expat if it was stopped, or feeds it the next chunk of the source. Returns false on a
+    // parse error.
+    bool Parse(){
+        auto Status = DSuspended ? DFeeder.Resume(DXMLParser) : DFeeder.Feed(DXMLParser);
+        DEndOfData = DFeeder.EndOfData();
+        DSuspended = Status == XML_STATUS_SUSPENDED;
+        DPeakQueuedEntities = std::max(DPeakQueuedEntities, DRecords.size());
+        return Status != XML_STATUS_ERROR;
+    }
+    bool ReadEntity(SXMLEntity &entity, bool skipcdata) {
+        SXMLEntityView View;
+        if(!ReadEntity(View, skipcdata)){
+            return false;
+        }
+        entity.DType = View.DType;
+        entity.DNameData.assign(View.DNameData);
+        entity.DAttributes.clear();
+        for(std::size_t Index = 0; Index < View.DAttributeCount; Index++){
+            entity.SetAttribute(std::string(View.DAttributes[Index].DName), std::string(View.DAttributes[Index].DValue));
         }
-        // Found a suitable entity to return
-        entity = frontEntity;
-        DEntityQueue.pop();
         return true;
     }
 
-    // If we get here, it means there were no suitable entities to return
-    return false;
-}
-
 };
-CXMLReader::CXMLReader(std::shared_ptr< CDataSource > src){
-    DImplementation = std::make_unique<SImplementation>(src);
+CXMLReader::CXMLReader(std::shared_ptr< CDataSource > src, std::size_t chunksize, std::size_t maxqueued){
+    DImplementation = std::make_unique<SImplementation>(src, chunksize, maxqueued);
 }
 
 CXMLReader::~CXMLReader()=default;
@@ -111,6 +182,20 @@ CXMLReader::~CXMLReader()=default;
 bool CXMLReader::End() const{
     return DImplementation->End();
  }
+CXMLReader::SParseStatistics CXMLReader::ParseStatistics() const{
+    auto Statistics = DImplementation->DFeeder.Statistics();
+    Statistics.DPeakQueuedEntities = DImplementation->DPeakQueuedEntities;
+    return Statistics;
+}
+
 bool CXMLReader::ReadEntity(SXMLEntity &entity, bool skipcdata) {
     return DImplementation->ReadEntity(entity, skipcdata);
 }
+
+CXMLReader::TNameID CXMLReader::Intern(const std::string &name){
+    return DImplementation->Intern(name);
+}
+
+bool CXMLReader::ReadEntity(SXMLEntityView &entity, bool skipcdata) {
+    return DImplementation->ReadEntity(entity, skipcdata);
+}
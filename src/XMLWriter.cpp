@@ -39,7 +39,7 @@ struct CXMLWriter::SImplementation {
             Sink->Write(std::vector<char>(endTag.begin(), endTag.end()));
             OpenElements.pop_back();
         }
-        return true;
+        return Sink->Flush();
     }
 };
 
@@ -0,0 +1,109 @@
+#include "BufferedDataSink.h"
+#include "DSVWriter.h"
+#include "FileDataFactory.h"
+#include "KMLWriter.h"
+#include "StringUtils.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Times exporting random trips as DSV rows and as KML paths to files, once writing straight to the
+// file sinks and once through CBufferedDataSink, and prints the throughput of each.
+int main(int argc, char *argv[]){
+    std::string ResultsDirectory = "./results";
+    std::size_t TripCount = 10000;
+    std::size_t StepCount = 20;
+    std::size_t BufferSize = CBufferedDataSink::DefaultBufferSize;
+    for(int Index = 1; Index < argc; Index++){
+        auto SplitArg = StringUtils::Split(argv[Index],"=");
+        if(SplitArg.size() != 2){
+            std::cerr<<"Syntax Error: exportbench [--results=path | --trips=count | --steps=count | --buffer=bytes]"<<std::endl;
+            return EXIT_FAILURE;
+        }
+        if(SplitArg[0] == "--results"){
+            ResultsDirectory = SplitArg[1];
+        }
+        else if(SplitArg[0] == "--trips"){
+            TripCount = std::stoull(SplitArg[1]);
+        }
+        else if(SplitArg[0] == "--steps"){
+            StepCount = std::stoull(SplitArg[1]);
+        }
+        else if(SplitArg[0] == "--buffer"){
+            BufferSize = std::stoull(SplitArg[1]);
+        }
+        else{
+            std::cerr<<"Syntax Error: exportbench [--results=path | --trips=count | --steps=count | --buffer=bytes]"<<std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    auto ResultsFactory = std::make_shared<CFileDataFactory>(ResultsDirectory);
+
+    // Trips of walk, bike and bus steps through random nodes around Davis
+    const std::vector< std::string > Modes = {"Walk", "Bike", "Bus"};
+    std::mt19937_64 Generator(0);
+    std::uniform_int_distribution< std::size_t > ModeDistribution(0, Modes.size() - 1);
+    std::uniform_int_distribution< uint64_t > NodeDistribution(1, 10000000000ULL);
+    std::uniform_real_distribution< double > OffsetDistribution(-0.05, 0.05);
+    std::vector< std::vector< std::pair< std::string, uint64_t > > > Steps(TripCount);
+    std::vector< std::vector< CStreetMap::TLocation > > Paths(TripCount);
+    for(std::size_t Trip = 0; Trip < TripCount; Trip++){
+        for(std::size_t Step = 0; Step < StepCount; Step++){
+            Steps[Trip].push_back(std::make_pair(Modes[ModeDistribution(Generator)], NodeDistribution(Generator)));
+            Paths[Trip].push_back(std::make_pair(38.54 + OffsetDistribution(Generator), -121.74 + OffsetDistribution(Generator)));
+        }
+    }
+
+    auto MakeSink = [&](const std::string &name, bool buffered) -> std::shared_ptr<CDataSink>{
+        auto Sink = ResultsFactory->CreateSink(name);
+        if(buffered){
+            return std::make_shared<CBufferedDataSink>(Sink, BufferSize);
+        }
+        return Sink;
+    };
+    auto ExportDSV = [&](bool buffered){
+        auto Sink = MakeSink(buffered ? "export_buffered.csv" : "export.csv", buffered);
+        CDSVWriter Writer(Sink, ',');
+        std::size_t Bytes = 0;
+        auto Start = std::chrono::steady_clock::now();
+        for(auto &Trip : Steps){
+            Writer.WriteRow({"mode","node_id"});
+            Sink->Put('\n');
+            Bytes += 13;
+            for(auto &Step : Trip){
+                std::vector< std::string > Row = {Step.first, std::to_string(Step.second)};
+                Writer.WriteRow(Row);
+                Sink->Put('\n');
+                Bytes += Row[0].size() + Row[1].size() + 2;
+            }
+        }
+        Sink->Flush();
+        return std::make_pair(std::chrono::steady_clock::now() - Start, Bytes);
+    };
+    auto ExportKML = [&](bool buffered){
+        auto Start = std::chrono::steady_clock::now();
+        {
+            CKMLWriter Writer(MakeSink(buffered ? "export_buffered.kml" : "export.kml", buffered), "Trips", "Exported trips");
+            Writer.CreateLineStyle("Trip", 0xff0000ff, 3);
+            for(std::size_t Trip = 0; Trip < Paths.size(); Trip++){
+                Writer.CreatePath("Trip " + std::to_string(Trip), "Trip", Paths[Trip]);
+            }
+        }
+        return std::chrono::steady_clock::now() - Start;
+    };
+
+    auto Report = [&](const std::string &label, std::chrono::steady_clock::duration duration){
+        auto Seconds = std::chrono::duration<double>(duration).count();
+        std::cout<<label<<": "<<std::chrono::duration<double, std::milli>(duration).count()<<" ms, "<<TripCount / Seconds<<" trips/s"<<std::endl;
+    };
+    auto Direct = ExportDSV(false);
+    auto Buffered = ExportDSV(true);
+    std::cout<<"Trips: "<<TripCount<<", "<<StepCount<<" steps each, "<<Direct.second / 1024<<" KiB of DSV"<<std::endl;
+    Report("DSV direct", Direct.first);
+    Report("DSV buffered", Buffered.first);
+    Report("KML direct", ExportKML(false));
+    Report("KML buffered", ExportKML(true));
+    return EXIT_SUCCESS;
+}
@@ -75,8 +75,7 @@ int main(int argc, char *argv[]){
     auto StdErr = std::make_shared<CStandardErrorDataSink>();
     auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
     auto BusPathReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(BusPathFilename),',');
-    auto XMLReader = std::make_shared<CXMLReader>(DataFactory->CreateSource(OSMFilename));
-    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto StreetMap = std::make_shared<COpenStreetMap>(DataFactory->CreateSource(OSMFilename));
     CKMLTranslator KMLTranslator(StreetMap,StopReader,BusPathReader);
 
     for(auto &Filename : Parser.Filenames()){
@@ -0,0 +1,116 @@
+#include "DijkstraPathRouter.h"
+#include "GeographicUtils.h"
+#include "OpenStreetMap.h"
+#include "FileDataFactory.h"
+#include "XMLReader.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Times converting router paths of vertex IDs into node IDs, once by copying each vertex's std::any
+// tag out of the router and once by indexing a side table of node IDs, as the planner does. The
+// routes join the westmost nodes of the map to the eastmost ones, so they cross the city.
+int main(int argc, char *argv[]){
+    std::string DataDirectory = "./data";
+    std::size_t RouteCount = 20;
+    std::size_t Repeats = 1000;
+    for(int Index = 1; Index < argc; Index++){
+        auto SplitArg = StringUtils::Split(argv[Index],"=");
+        if(SplitArg.size() != 2){
+            std::cerr<<"Syntax Error: pathbench [--data=path | --routes=count | --repeats=count]"<<std::endl;
+            return EXIT_FAILURE;
+        }
+        if(SplitArg[0] == "--data"){
+            DataDirectory = SplitArg[1];
+        }
+        else if(SplitArg[0] == "--routes"){
+            RouteCount = std::stoull(SplitArg[1]);
+        }
+        else if(SplitArg[0] == "--repeats"){
+            Repeats = std::stoull(SplitArg[1]);
+        }
+        else{
+            std::cerr<<"Syntax Error: pathbench [--data=path | --routes=count | --repeats=count]"<<std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    auto DataFactory = std::make_shared<CFileDataFactory>(DataDirectory);
+    COpenStreetMap StreetMap(DataFactory->CreateSource("city.osm"));
+
+    CDijkstraPathRouter Router;
+    std::vector< CStreetMap::TNodeID > VertexNodeIDs;
+    std::unordered_map< CStreetMap::TNodeID, CPathRouter::TVertexID > NodeToVertexID;
+    for(std::size_t Index = 0; Index < StreetMap.NodeCount(); Index++){
+        auto Node = StreetMap.NodeByIndex(Index);
+        NodeToVertexID[Node->ID()] = Router.AddVertex(Node->ID());
+        VertexNodeIDs.push_back(Node->ID());
+    }
+    for(std::size_t Index = 0; Index < StreetMap.WayCount(); Index++){
+        auto Way = StreetMap.WayByIndex(Index);
+        for(std::size_t NodeIndex = 1; NodeIndex < Way->NodeCount(); NodeIndex++){
+            auto Previous = StreetMap.NodeByID(Way->GetNodeID(NodeIndex - 1));
+            auto Next = StreetMap.NodeByID(Way->GetNodeID(NodeIndex));
+            if(Previous && Next){
+                double Distance = SGeographicUtils::HaversineDistanceInMiles(Previous->Location(), Next->Location());
+                Router.AddEdge(NodeToVertexID[Previous->ID()], NodeToVertexID[Next->ID()], Distance, true);
+            }
+        }
+    }
+    Router.Precompute(std::chrono::steady_clock::now());
+
+    // Vertices in order of longitude, routes pair the ends
+    std::vector< CPathRouter::TVertexID > ByLongitude(VertexNodeIDs.size());
+    for(std::size_t Index = 0; Index < ByLongitude.size(); Index++){
+        ByLongitude[Index] = Index;
+    }
+    std::sort(ByLongitude.begin(), ByLongitude.end(), [&](CPathRouter::TVertexID left, CPathRouter::TVertexID right){
+        return StreetMap.NodeByID(VertexNodeIDs[left])->Location().second < StreetMap.NodeByID(VertexNodeIDs[right])->Location().second;
+    });
+    std::vector< std::vector< CPathRouter::TVertexID > > Routes;
+    std::size_t VertexTotal = 0;
+    for(std::size_t Index = 0; (Routes.size() < RouteCount) && (Index < ByLongitude.size() / 2); Index++){
+        std::vector< CPathRouter::TVertexID > Route;
+        if(Router.FindShortestPath(ByLongitude[Index], ByLongitude[ByLongitude.size() - 1 - Index], Route) != CPathRouter::NoPathExists){
+            VertexTotal += Route.size();
+            Routes.push_back(std::move(Route));
+        }
+    }
+    if(Routes.empty()){
+        std::cerr<<"No routes found"<<std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector< CStreetMap::TNodeID > Path;
+    std::size_t Checksum = 0;
+    auto TagStart = std::chrono::steady_clock::now();
+    for(std::size_t Repeat = 0; Repeat < Repeats; Repeat++){
+        for(auto &Route : Routes){
+            Path.clear();
+            for(auto VertexID : Route){
+                Path.push_back(std::any_cast<CStreetMap::TNodeID>(Router.GetVertexTag(VertexID)));
+            }
+            Checksum += Path.back();
+        }
+    }
+    auto TagDuration = std::chrono::steady_clock::now() - TagStart;
+    auto TableStart = std::chrono::steady_clock::now();
+    for(std::size_t Repeat = 0; Repeat < Repeats; Repeat++){
+        for(auto &Route : Routes){
+            Path.clear();
+            for(auto VertexID : Route){
+                Path.push_back(VertexNodeIDs[VertexID]);
+            }
+            Checksum -= Path.back();
+        }
+    }
+    auto TableDuration = std::chrono::steady_clock::now() - TableStart;
+
+    auto Conversions = double(VertexTotal) * Repeats;
+    std::cout<<"Routes: "<<Routes.size()<<", "<<VertexTotal / Routes.size()<<" vertices on average"<<std::endl;
+    std::cout<<"std::any tags: "<<std::chrono::duration<double, std::nano>(TagDuration).count() / Conversions<<" ns/vertex"<<std::endl;
+    std::cout<<"Side table: "<<std::chrono::duration<double, std::nano>(TableDuration).count() / Conversions<<" ns/vertex"<<std::endl;
+    return Checksum ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,8 +1,15 @@
 #include "TransportationPlannerConfig.h"
 #include "DijkstraTransportationPlanner.h"
+#include "DijkstraPathRouter.h"
+#include "BidirectionalDijkstraPathRouter.h"
+#include "ContractionHierarchyPathRouter.h"
+#include "ThreadPool.h"
+#include "PathCache.h"
+#include "GraphSnapshot.h"
 #include "OpenStreetMap.h"
 #include "CSVBusSystem.h"
 #include "FileDataFactory.h"
+#include "BufferedDataSink.h"
 #include "StandardDataSource.h"
 #include "StandardDataSink.h"
 #include "StandardErrorDataSink.h"
@@ -13,6 +20,9 @@
 #include <chrono>
 #include <vector>
 #include <cmath>
+#include <random>
+#include <algorithm>
+#include <functional>
 
 class CArgumentParser{
     private:
@@ -20,6 +30,17 @@ class CArgumentParser{
         std::string DResultsDirectory;
         uint64_t DNumPoints;
         uint64_t DSeed;
+        std::string DQueueType;
+        std::string DRouterType;
+        std::string DTransitType;
+        std::string DSourceType;
+        uint64_t DXMLChunkSize;
+        uint64_t DLandmarkCount;
+        uint64_t DThreadCount;
+        uint64_t DLoadThreadCount;
+        uint64_t DCacheEntries;
+        double DZipfExponent;
+        std::string DSnapshotPath;
         bool DArgumentsValid;
         bool DVerbose;
         
@@ -34,11 +55,22 @@ class CArgumentParser{
         bool Verbose() const;
         uint64_t NumPoints() const;
         uint64_t Seed() const;
+        std::string QueueType() const;
+        std::string RouterType() const;
+        std::string TransitType() const;
+        std::string SourceType() const;
+        uint64_t XMLChunkSize() const;
+        uint64_t LandmarkCount() const;
+        uint64_t ThreadCount() const;
+        uint64_t LoadThreadCount() const;
+        uint64_t CacheEntries() const;
+        double ZipfExponent() const;
+        std::string SnapshotPath() const;
 };
 
 class CSpeedTest{
     private:
-        std::shared_ptr<CTransportationPlanner> DPlanner;
+        std::shared_ptr<CDijkstraTransportationPlanner> DPlanner;
         std::shared_ptr<CDataSink> DOutput;
         std::shared_ptr<CDataSink> DNotify;
         bool DViolatedPrecomputeTime;
@@ -58,9 +90,18 @@ class CSpeedTest{
         void NotifyString(const std::string &str);
         void WriteStringToSink(std::shared_ptr<CDataSink> sink, const std::string &str);
     public:
-        CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config);
+        // Builds or loads the planner, the load time covers all of it including reading the data
+        using TPlannerLoader = std::function< std::shared_ptr<CDijkstraTransportationPlanner>() >;
 
-        bool RunTest(uint64_t seed, uint64_t numpoints, bool verbose);
+        CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config, TPlannerLoader loader);
+
+        std::shared_ptr<CDijkstraTransportationPlanner> Planner() const;
+
+        // Zero entries turns the planner's path cache off
+        void SetPathCacheCapacity(uint64_t entries);
+        // Zero threads runs the queries one after another on the calling thread. A positive zipf
+        // replays numpoints queries drawn from the random pairs, the pair of rank r with weight 1 / r^zipf.
+        bool RunTest(uint64_t seed, uint64_t numpoints, uint64_t threads, double zipf, bool verbose);
         bool OutputResults(std::shared_ptr<CDataFactory> results, bool verbose);
 };
 
@@ -69,6 +110,7 @@ int main(int argc, char *argv[]){
     const std::string OSMFilename = "city.osm";
     const std::string StopFilename = "stops.csv";
     const std::string RouteFilename = "routes.csv";
+    const std::string BusPathFilename = "buspaths.csv";
 
     // Skip program name
     for(int Index = 1; Index < argc; Index++){
@@ -79,21 +121,95 @@ int main(int argc, char *argv[]){
     if(!Parser.ArgumentsValid()){
         return EXIT_FAILURE;
     }
-    auto DataFactory = std::make_shared<CFileDataFactory>(Parser.DataDirectory());
+    auto SourceType = Parser.SourceType() == "mmap" ? CFileDataFactory::ESourceType::MemoryMapped : CFileDataFactory::ESourceType::Stream;
+    auto DataFactory = std::make_shared<CFileDataFactory>(Parser.DataDirectory(), SourceType);
     auto ResultsFactory = std::make_shared<CFileDataFactory>(Parser.ResultsDirectory());
     auto StdIn = std::make_shared<CStandardDataSource>();
     auto StdOut = std::make_shared<CStandardDataSink>();
     auto StdErr = std::make_shared<CStandardErrorDataSink>();
-    auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
-    auto RouteReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(RouteFilename),',');
-    auto BusSystem = std::make_shared<CCSVBusSystem>(StopReader, RouteReader);
-    auto XMLReader = std::make_shared<CXMLReader>(DataFactory->CreateSource(OSMFilename));
-    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
-    auto PlannerConfig = std::make_shared<STransportationPlannerConfig>(StreetMap, BusSystem);
-
-    CSpeedTest SpeedTester(StdOut,StdErr,PlannerConfig);
+    auto WriteLine = [](std::shared_ptr<CDataSink> sink, const std::string &line){
+        sink->Write(std::vector<char>(line.begin(), line.end()));
+        sink->Put('\n');
+        sink->Flush();
+    };
+    // The map and bus system are only read when the planner is built from them
+    auto PlannerConfig = std::make_shared<STransportationPlannerConfig>(nullptr, nullptr);
+    CDijkstraPathRouter::EQueueType QueueType = CDijkstraPathRouter::EQueueType::QuaternaryHeap;
+    if(Parser.QueueType() == "rebuild"){
+        QueueType = CDijkstraPathRouter::EQueueType::Rebuild;
+    }
+    else if(Parser.QueueType() == "binary"){
+        QueueType = CDijkstraPathRouter::EQueueType::BinaryHeap;
+    }
+    auto RouterType = Parser.RouterType();
+    auto LandmarkCount = Parser.LandmarkCount();
+    auto DijkstraRouters = std::make_shared< std::vector< std::shared_ptr<CDijkstraPathRouter> > >();
+    auto RouterFactory = [QueueType,RouterType,LandmarkCount,DijkstraRouters]() -> std::shared_ptr<CPathRouter>{
+        if(RouterType == "bidijkstra"){
+            return std::make_shared<CBidirectionalDijkstraPathRouter>();
+        }
+        if(RouterType == "ch"){
+            return std::make_shared<CContractionHierarchyPathRouter>();
+        }
+        auto Router = std::make_shared<CDijkstraPathRouter>(QueueType);
+        Router->SetLandmarkCount(LandmarkCount);
+        DijkstraRouters->push_back(Router);
+        return Router;
+    };
+
+    auto TransitEngine = Parser.TransitType() == "raptor" ? CDijkstraTransportationPlanner::ETransitEngine::Raptor : CDijkstraTransportationPlanner::ETransitEngine::Graph;
+    // A snapshot built from other data files, or with other settings, is replaced after building from the files
+    auto SnapshotPath = Parser.SnapshotPath();
+    auto SourceKey = CGraphSnapshot::FileKey({Parser.DataDirectory() + "/" + OSMFilename, Parser.DataDirectory() + "/" + StopFilename, Parser.DataDirectory() + "/" + RouteFilename, Parser.DataDirectory() + "/" + BusPathFilename});
+    bool LoadedSnapshot = false;
+    auto PlannerLoader = [&]() -> std::shared_ptr<CDijkstraTransportationPlanner>{
+        if(!SnapshotPath.empty()){
+            auto Planner = CDijkstraTransportationPlanner::LoadSnapshot(SnapshotPath, SourceKey, PlannerConfig, RouterFactory, TransitEngine);
+            if(Planner){
+                LoadedSnapshot = true;
+                return Planner;
+            }
+        }
+        auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
+        auto RouteReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(RouteFilename),',');
+        auto BusPathReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(BusPathFilename),',');
+        PlannerConfig->DBusSystem = std::make_shared<CCSVBusSystem>(StopReader, RouteReader, BusPathReader);
+        auto StreetMapStart = std::chrono::steady_clock::now();
+        std::shared_ptr<COpenStreetMap> StreetMap;
+        if(Parser.LoadThreadCount()){
+            CThreadPool LoadPool(Parser.LoadThreadCount());
+            StreetMap = std::make_shared<COpenStreetMap>(DataFactory->CreateSource(OSMFilename), LoadPool, 0, Parser.XMLChunkSize());
+        }
+        else{
+            StreetMap = std::make_shared<COpenStreetMap>(DataFactory->CreateSource(OSMFilename), Parser.XMLChunkSize());
+        }
+        PlannerConfig->DStreetMap = StreetMap;
+        auto Statistics = StreetMap->ParseStatistics();
+        std::stringstream Line;
+        Line<<"OSM: loaded "<<StreetMap->NodeCount()<<" nodes and "<<StreetMap->WayCount()<<" ways in "<<std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StreetMapStart).count()<<" ms, parsed "<<Statistics.DBytesParsed<<" bytes in "<<Statistics.DChunkCount<<" chunks at "<<Statistics.BytesPerSecond() / (1024 * 1024)<<" MiB/s";
+        WriteLine(StdOut, Line.str());
+        return std::make_shared<CDijkstraTransportationPlanner>(PlannerConfig, RouterFactory, TransitEngine);
+    };
+    CSpeedTest SpeedTester(StdOut,StdErr,PlannerConfig,PlannerLoader);
+    if(!SnapshotPath.empty()){
+        if(LoadedSnapshot){
+            WriteLine(StdOut, "Snapshot: loaded " + SnapshotPath);
+        }
+        else if(SpeedTester.Planner()->SaveSnapshot(SnapshotPath, SourceKey)){
+            WriteLine(StdOut, "Snapshot: saved " + SnapshotPath);
+        }
+        else{
+            WriteLine(StdErr, "Snapshot: failed to save " + SnapshotPath);
+        }
+    }
+    for(auto &Router : *DijkstraRouters){
+        if(Router->SelectedLandmarkCount()){
+            WriteLine(StdOut, "Landmarks: " + std::to_string(Router->SelectedLandmarkCount()) + " selected in " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(Router->LandmarkSelectionTime()).count()) + " ms, " + std::to_string(Router->LandmarkBytes()) + " bytes per landmark");
+        }
+    }
 
-    if(SpeedTester.RunTest(Parser.Seed(),Parser.NumPoints(),Parser.Verbose())){
+    SpeedTester.SetPathCacheCapacity(Parser.CacheEntries());
+    if(SpeedTester.RunTest(Parser.Seed(),Parser.NumPoints(),Parser.ThreadCount(),Parser.ZipfExponent(),Parser.Verbose())){
         if(SpeedTester.OutputResults(ResultsFactory,Parser.Verbose())){
             return EXIT_SUCCESS;        
         }
@@ -108,6 +224,16 @@ CArgumentParser::CArgumentParser(const std::vector<std::string> &args){
     DArgumentsValid = true;
     DNumPoints = 0;
     DSeed = 0;
+    DQueueType = "quaternary";
+    DRouterType = "dijkstra";
+    DTransitType = "graph";
+    DSourceType = "stream";
+    DXMLChunkSize = CXMLReader::DefaultChunkSize;
+    DLandmarkCount = 0;
+    DThreadCount = 0;
+    DLoadThreadCount = 0;
+    DCacheEntries = 0;
+    DZipfExponent = 0.0;
     DVerbose = false;
     for(auto &Argument : args){
         if(Argument.find("--data") == 0){
@@ -134,6 +260,114 @@ CArgumentParser::CArgumentParser(const std::vector<std::string> &args){
             }
             DSeed = std::stoull(SplitArg[1]);
         }
+        else if(Argument.find("--queue") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--queue"){
+                DArgumentsValid = false;
+                break;
+            }
+            DQueueType = SplitArg[1];
+            if(DQueueType != "rebuild" && DQueueType != "binary" && DQueueType != "quaternary"){
+                DArgumentsValid = false;
+                break;
+            }
+        }
+        else if(Argument.find("--router") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--router"){
+                DArgumentsValid = false;
+                break;
+            }
+            DRouterType = SplitArg[1];
+            if(DRouterType != "dijkstra" && DRouterType != "bidijkstra" && DRouterType != "ch"){
+                DArgumentsValid = false;
+                break;
+            }
+        }
+        else if(Argument.find("--transit") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--transit"){
+                DArgumentsValid = false;
+                break;
+            }
+            DTransitType = SplitArg[1];
+            if(DTransitType != "graph" && DTransitType != "raptor"){
+                DArgumentsValid = false;
+                break;
+            }
+        }
+        else if(Argument.find("--source") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--source"){
+                DArgumentsValid = false;
+                break;
+            }
+            DSourceType = SplitArg[1];
+            if(DSourceType != "stream" && DSourceType != "mmap"){
+                DArgumentsValid = false;
+                break;
+            }
+        }
+        else if(Argument.find("--xmlchunk") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--xmlchunk"){
+                DArgumentsValid = false;
+                break;
+            }
+            DXMLChunkSize = std::stoull(SplitArg[1]);
+        }
+        else if(Argument.find("--landmarks") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--landmarks"){
+                DArgumentsValid = false;
+                break;
+            }
+            DLandmarkCount = std::stoull(SplitArg[1]);
+        }
+        else if(Argument.find("--threads") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--threads"){
+                DArgumentsValid = false;
+                break;
+            }
+            DThreadCount = std::stoull(SplitArg[1]);
+        }
+        else if(Argument.find("--loadthreads") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--loadthreads"){
+                DArgumentsValid = false;
+                break;
+            }
+            DLoadThreadCount = std::stoull(SplitArg[1]);
+        }
+        else if(Argument.find("--cache") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--cache"){
+                DArgumentsValid = false;
+                break;
+            }
+            DCacheEntries = std::stoull(SplitArg[1]);
+        }
+        else if(Argument.find("--zipf") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--zipf"){
+                DArgumentsValid = false;
+                break;
+            }
+            DZipfExponent = std::stod(SplitArg[1]);
+            if(DZipfExponent < 0.0){
+                DArgumentsValid = false;
+                break;
+            }
+        }
+        else if(Argument.find("--snapshot") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--snapshot" || SplitArg[1].empty()){
+                DArgumentsValid = false;
+                break;
+            }
+            DSnapshotPath = SplitArg[1];
+        }
         else if(Argument == "--verbose"){
             DVerbose = true;
         }
@@ -159,7 +393,7 @@ CArgumentParser::CArgumentParser(const std::vector<std::string> &args){
 }
 
 void CArgumentParser::PrintSyntax() const{
-    std::cerr<<"Syntax Error: speedtest [--data=path | --results=path | --seed=rngseed | --verbose] [numpoints]"<<std::endl;
+    std::cerr<<"Syntax Error: speedtest [--data=path | --results=path | --seed=rngseed | --queue=rebuild|binary|quaternary | --router=dijkstra|bidijkstra|ch | --transit=graph|raptor | --source=stream|mmap | --xmlchunk=bytes | --landmarks=count | --threads=count | --loadthreads=count | --cache=entries | --zipf=exponent | --snapshot=path | --verbose] [numpoints]"<<std::endl;
 }
 
 bool CArgumentParser::ArgumentsValid() const{
@@ -186,13 +420,57 @@ uint64_t CArgumentParser::Seed() const{
     return DSeed;
 }
 
-CSpeedTest::CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config){
+std::string CArgumentParser::QueueType() const{
+    return DQueueType;
+}
+
+std::string CArgumentParser::RouterType() const{
+    return DRouterType;
+}
+
+std::string CArgumentParser::TransitType() const{
+    return DTransitType;
+}
+
+std::string CArgumentParser::SourceType() const{
+    return DSourceType;
+}
+
+uint64_t CArgumentParser::XMLChunkSize() const{
+    return DXMLChunkSize;
+}
+
+uint64_t CArgumentParser::LandmarkCount() const{
+    return DLandmarkCount;
+}
+
+uint64_t CArgumentParser::ThreadCount() const{
+    return DThreadCount;
+}
+
+uint64_t CArgumentParser::LoadThreadCount() const{
+    return DLoadThreadCount;
+}
+
+uint64_t CArgumentParser::CacheEntries() const{
+    return DCacheEntries;
+}
+
+double CArgumentParser::ZipfExponent() const{
+    return DZipfExponent;
+}
+
+std::string CArgumentParser::SnapshotPath() const{
+    return DSnapshotPath;
+}
+
+CSpeedTest::CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config, TPlannerLoader loader){
     const int MillisecondsPerSecond = 1000;
     DOutput = out;
     DNotify = notify;
     NotifyString("Loading\n");
     auto LoadStart = std::chrono::steady_clock::now();
-    DPlanner = std::make_shared<CDijkstraTransportationPlanner>(config);
+    DPlanner = loader();
     auto LoadDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-LoadStart);
     NotifyString("Loaded\n");
     DViolatedPrecomputeTime = config->PrecomputeTime() * MillisecondsPerSecond < LoadDuration.count();
@@ -202,6 +480,10 @@ CSpeedTest::CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink
     DLoadDurationCount = LoadDuration.count();
 }
 
+std::shared_ptr<CDijkstraTransportationPlanner> CSpeedTest::Planner() const{
+    return DPlanner;
+}
+
 std::string CSpeedTest::DistanceToString(double dist){
     if(CPathRouter::NoPathExists == dist){
         return "(N/A)";
@@ -288,7 +570,11 @@ void CSpeedTest::WriteStringToSink(std::shared_ptr<CDataSink> sink, const std::s
     sink->Write(std::vector<char>(str.begin(),str.end()));
 }
 
-bool CSpeedTest::RunTest(uint64_t seed, uint64_t numpoints, bool verbose){
+void CSpeedTest::SetPathCacheCapacity(uint64_t entries){
+    DPlanner->SetPathCacheCapacity(entries);
+}
+
+bool CSpeedTest::RunTest(uint64_t seed, uint64_t numpoints, uint64_t threads, double zipf, bool verbose){
     std::vector< CStreetMap::TNodeID > TempShortestPath;
     std::vector< CTransportationPlanner::TTripStep > TempFastestPath;
     std::vector< std::pair< CStreetMap::TNodeID , CStreetMap::TNodeID > > RandomNodePairs;
@@ -304,10 +590,36 @@ bool CSpeedTest::RunTest(uint64_t seed, uint64_t numpoints, bool verbose){
         auto DestNodeID = DPlanner->SortedNodeByIndex(DestIndex)->ID();
         RandomNodePairs.push_back(std::make_pair(SourceNodeID,DestNodeID));
     }
+    if(zipf > 0.0 && numpoints){
+        // Skewed replay where a few popular pairs make up most of the queries
+        NotifyString("Drawing Zipfian queries\n");
+        std::vector< double > Weights;
+        for(uint64_t Rank = 1; Rank <= numpoints; Rank++){
+            Weights.push_back(1.0 / std::pow(double(Rank), zipf));
+        }
+        std::mt19937_64 Generator(seed);
+        std::discrete_distribution< std::size_t > RankDistribution(Weights.begin(), Weights.end());
+        auto PopularPairs = RandomNodePairs;
+        for(auto &Pair : RandomNodePairs){
+            Pair = PopularPairs[RankDistribution(Generator)];
+        }
+    }
     DShortestPaths.resize(numpoints);
     DShortestDistance.resize(numpoints);
     DFastestPaths.resize(numpoints);
     DFastestTime.resize(numpoints);
+    if(threads){
+        // Workers are started before the clock so only the queries are timed
+        CThreadPool Pool(threads);
+        NotifyString("Finding paths on " + std::to_string(Pool.ThreadCount()) + " threads\n");
+        auto ProcessingStart = std::chrono::steady_clock::now();
+        DShortestDistance = DPlanner->FindShortestPaths(RandomNodePairs, DShortestPaths, Pool);
+        DFastestTime = DPlanner->FindFastestPaths(RandomNodePairs, DFastestPaths, Pool);
+        auto ProcessingDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-ProcessingStart);
+        NotifyString("Paths found\n");
+        DProcessingDurationCount = ProcessingDuration.count();
+        return true;
+    }
     NotifyString("Finding paths\n");
     auto ProcessingStart = std::chrono::steady_clock::now();
     for(uint64_t Index = 0; Index < numpoints; Index++){
@@ -326,7 +638,7 @@ bool CSpeedTest::RunTest(uint64_t seed, uint64_t numpoints, bool verbose){
 
 bool CSpeedTest::OutputResults(std::shared_ptr<CDataFactory> results, bool verbose){
     NotifyString("Outputting Results\n");
-    auto Brief = results->CreateSink("speed_test_brief.txt");
+    auto Brief = std::make_shared<CBufferedDataSink>(results->CreateSink("speed_test_brief.txt"));
     for(std::size_t Index = 0; Index < DShortestPaths.size(); Index++){
         WriteStringToSink(Brief,std::to_string(Index) + " SP:" + DistanceToString(DShortestDistance[Index]));
         if(verbose){
@@ -343,9 +655,15 @@ bool CSpeedTest::OutputResults(std::shared_ptr<CDataFactory> results, bool verbo
     auto MarginOfError = long(double(SamplesPerDay) / sqrt(DShortestPaths.size()));
     std::string Summary = "Duration (load): " + std::to_string(DLoadDurationCount) + "\n";
     Summary += "Duration (proc): " + std::to_string(DProcessingDurationCount) + "\n";
+    Summary += "Latency (avg): " + std::to_string(DProcessingDurationCount * 1000 / DShortestPaths.size()) + " us/query\n";
     Summary += "Queries per day: " + std::to_string(SamplesPerDay) + " (+-" + std::to_string(MarginOfError) + "), " + std::to_string(SamplesPerDay - MarginOfError) + " min\n";
+    auto Cache = DPlanner->PathCache();
+    if(Cache){
+        auto Lookups = std::max< std::size_t >(1, Cache->Hits() + Cache->Misses());
+        Summary += "Path cache: " + std::to_string(Cache->Hits()) + " hits, " + std::to_string(Cache->Misses()) + " misses (" + std::to_string(Cache->Hits() * 100 / Lookups) + "% hit rate)\n";
+    }
 
     WriteStringToSink(Brief,Summary);
     NotifyString(Summary);
-    return true;
+    return Brief->Flush();
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "BidirectionalDijkstraPathRouter.h"
+#include "DijkstraPathRouter.h"
+#include <random>
+
+TEST(BidirectionalDijkstraPathRouter, RouteTest){
+    CBidirectionalDijkstraPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 6; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+        EXPECT_EQ(Index,std::any_cast<std::size_t>(PathRouter.GetVertexTag(Vertices.back())));
+    }
+    PathRouter.AddEdge(Vertices[0],Vertices[4],3);
+    PathRouter.AddEdge(Vertices[4],Vertices[5],90);
+    PathRouter.AddEdge(Vertices[5],Vertices[3],6);
+    PathRouter.AddEdge(Vertices[3],Vertices[2],8);
+    PathRouter.AddEdge(Vertices[2],Vertices[0],1);
+    PathRouter.AddEdge(Vertices[2],Vertices[1],3);
+    PathRouter.AddEdge(Vertices[1],Vertices[3],9);
+    std::vector<CPathRouter::TVertexID> Route;
+    std::vector<CPathRouter::TVertexID> ExpectedRoute = {Vertices[2],Vertices[1],Vertices[3]};
+    EXPECT_EQ(12.0, PathRouter.FindShortestPath(Vertices[2],Vertices[3],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    ExpectedRoute = {Vertices[2],Vertices[0],Vertices[4],Vertices[5]};
+    EXPECT_EQ(94.0, PathRouter.FindShortestPath(Vertices[2],Vertices[5],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    ExpectedRoute = {Vertices[4]};
+    EXPECT_EQ(0.0, PathRouter.FindShortestPath(Vertices[4],Vertices[4],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+}
+
+TEST(BidirectionalDijkstraPathRouter, NoPathExists){
+    CBidirectionalDijkstraPathRouter PathRouter;
+    auto VertexID1 = PathRouter.AddVertex(std::string("Start"));
+    auto VertexID2 = PathRouter.AddVertex(std::string("End"));
+    std::vector<CPathRouter::TVertexID> Path;
+
+    PathRouter.AddEdge(VertexID2, VertexID1, 1.0);
+    EXPECT_EQ(CPathRouter::NoPathExists, PathRouter.FindShortestPath(VertexID1, VertexID2, Path));
+    EXPECT_EQ(CPathRouter::NoPathExists, PathRouter.FindShortestPath(VertexID1, 5, Path));
+    EXPECT_FALSE(PathRouter.AddEdge(VertexID1, VertexID2, -1.0));
+}
+
+TEST(BidirectionalDijkstraPathRouter, PrecomputeTest){
+    CBidirectionalDijkstraPathRouter PathRouter;
+    auto VertexID1 = PathRouter.AddVertex(1);
+    auto VertexID2 = PathRouter.AddVertex(2);
+    auto VertexID3 = PathRouter.AddVertex(3);
+    std::vector<CPathRouter::TVertexID> Path;
+
+    PathRouter.AddEdge(VertexID1, VertexID2, 5.0, true);
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    EXPECT_EQ(5.0, PathRouter.FindShortestPath(VertexID2, VertexID1, Path));
+    // Modifying the graph after Precompute must be reflected by the next query
+    PathRouter.AddEdge(VertexID1, VertexID3, 1.0);
+    PathRouter.AddEdge(VertexID3, VertexID2, 1.0);
+    std::vector<CPathRouter::TVertexID> ExpectedPath = {VertexID1, VertexID3, VertexID2};
+    EXPECT_EQ(2.0, PathRouter.FindShortestPath(VertexID1, VertexID2, Path));
+    EXPECT_EQ(ExpectedPath, Path);
+    EXPECT_EQ(3, std::any_cast<int>(PathRouter.GetVertexTag(VertexID3)));
+}
+
+TEST(BidirectionalDijkstraPathRouter, MatchesDijkstraTest){
+    CBidirectionalDijkstraPathRouter Bidirectional;
+    CDijkstraPathRouter Dijkstra;
+    std::mt19937 Generator(42);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Bidirectional.AddVertex(Index);
+        Dijkstra.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        double Weight = WeightDistribution(Generator);
+        bool Bidir = Index % 3 == 0;
+        Bidirectional.AddEdge(Source, Dest, Weight, Bidir);
+        Dijkstra.AddEdge(Source, Dest, Weight, Bidir);
+    }
+    Bidirectional.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    for(std::size_t Index = 0; Index < 200; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        std::vector<CPathRouter::TVertexID> BidirectionalPath, DijkstraPath;
+        auto Expected = Dijkstra.FindShortestPath(Source, Dest, DijkstraPath);
+        auto Actual = Bidirectional.FindShortestPath(Source, Dest, BidirectionalPath);
+        EXPECT_EQ(Expected, Actual);
+        if(CPathRouter::NoPathExists != Actual){
+            // Ties may produce a different path, so check that the path is valid and has the same length
+            ASSERT_FALSE(BidirectionalPath.empty());
+            EXPECT_EQ(Source, BidirectionalPath.front());
+            EXPECT_EQ(Dest, BidirectionalPath.back());
+            double Length = 0.0;
+            for(std::size_t Step = 1; Step < BidirectionalPath.size(); Step++){
+                std::vector<CPathRouter::TVertexID> Hop;
+                Length += Dijkstra.FindShortestPath(BidirectionalPath[Step-1], BidirectionalPath[Step], Hop);
+            }
+            EXPECT_LE(Length, Actual);
+        }
+    }
+}
+
+TEST(BidirectionalDijkstraPathRouter, WorkspaceTest){
+    CBidirectionalDijkstraPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 5; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    for(std::size_t Index = 1; Index < 5; Index++){
+        PathRouter.AddEdge(Vertices[Index-1],Vertices[Index],1.0);
+    }
+    auto Workspace = PathRouter.CreateWorkspace();
+    std::vector<CPathRouter::TVertexID> Path;
+    std::vector<CPathRouter::TVertexID> ExpectedPath = {Vertices[1],Vertices[2],Vertices[3]};
+    // Queries through a workspace also work before Precompute
+    EXPECT_EQ(2.0, PathRouter.FindShortestPath(Vertices[1],Vertices[3],Path,*Workspace));
+    EXPECT_EQ(ExpectedPath, Path);
+    PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    const CBidirectionalDijkstraPathRouter &SharedRouter = PathRouter;
+    for(std::size_t Round = 0; Round < 3; Round++){
+        EXPECT_EQ(2.0, SharedRouter.FindShortestPath(Vertices[1],Vertices[3],Path,*Workspace));
+        EXPECT_EQ(ExpectedPath, Path);
+        EXPECT_EQ(CPathRouter::NoPathExists, SharedRouter.FindShortestPath(Vertices[3],Vertices[1],Path,*Workspace));
+        EXPECT_EQ(4.0, SharedRouter.FindShortestPath(Vertices[0],Vertices[4],Path,*Workspace));
+    }
+}
+
+TEST(BidirectionalDijkstraPathRouter, MatrixTest){
+    CBidirectionalDijkstraPathRouter Bidirectional;
+    CDijkstraPathRouter Dijkstra;
+    std::mt19937 Generator(7);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Bidirectional.AddVertex(Index);
+        Dijkstra.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        double Weight = WeightDistribution(Generator);
+        bool Bidir = Index % 3 == 0;
+        Bidirectional.AddEdge(Source, Dest, Weight, Bidir);
+        Dijkstra.AddEdge(Source, Dest, Weight, Bidir);
+    }
+    std::vector< CPathRouter::TVertexID > Sources, Dests;
+    for(std::size_t Index = 0; Index < 10; Index++){
+        Sources.push_back(VertexDistribution(Generator));
+    }
+    for(std::size_t Index = 0; Index < 15; Index++){
+        Dests.push_back(VertexDistribution(Generator));
+    }
+    Sources.push_back(1000);
+    Dests.push_back(1000);
+    // Before Precompute the searches use the edge lists, afterwards the compressed arrays
+    for(bool Frozen : {false, true}){
+        if(Frozen){
+            Bidirectional.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+        }
+        auto Workspace = Bidirectional.CreateWorkspace();
+        auto Matrix = Bidirectional.FindDistanceMatrix(Sources, Dests, *Workspace);
+        ASSERT_EQ(Matrix.size(), Sources.size());
+        for(std::size_t Row = 0; Row < Sources.size(); Row++){
+            ASSERT_EQ(Matrix[Row].size(), Dests.size());
+            for(std::size_t Column = 0; Column < Dests.size(); Column++){
+                std::vector<CPathRouter::TVertexID> Path;
+                EXPECT_EQ(Matrix[Row][Column], Dijkstra.FindShortestPath(Sources[Row], Dests[Column], Path));
+            }
+            EXPECT_EQ(Bidirectional.FindDistances(Sources[Row], Dests, *Workspace), Matrix[Row]);
+        }
+    }
+}
+
+TEST(BidirectionalDijkstraPathRouter, ReachableTest){
+    CBidirectionalDijkstraPathRouter Router;
+    CDijkstraPathRouter Dijkstra;
+    std::mt19937 Generator(11);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Router.AddVertex(Index);
+        Dijkstra.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        double Weight = WeightDistribution(Generator);
+        Router.AddEdge(Source, Dest, Weight, Index % 3 == 0);
+        Dijkstra.AddEdge(Source, Dest, Weight, Index % 3 == 0);
+    }
+    Router.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    auto Workspace = Router.CreateWorkspace();
+    auto DijkstraWorkspace = Dijkstra.CreateWorkspace();
+    std::vector< CPathRouter::TVertexID > AllVertices;
+    for(std::size_t Index = 0; Index < 200; Index++){
+        AllVertices.push_back(Index);
+    }
+    for(double Budget : {0.0, 50.0, 150.0, 1000.0}){
+        auto Reached = Router.FindVerticesWithin(3, Budget, *Workspace);
+        auto Distances = Dijkstra.FindDistances(3, AllVertices, *DijkstraWorkspace);
+        std::size_t Expected = 0;
+        for(auto Distance : Distances){
+            Expected += Distance <= Budget ? 1 : 0;
+        }
+        EXPECT_EQ(Reached.size(), Expected);
+        for(std::size_t Index = 0; Index < Reached.size(); Index++){
+            EXPECT_EQ(Reached[Index].second, Distances[Reached[Index].first]);
+            if(Index){
+                EXPECT_LE(Reached[Index-1].second, Reached[Index].second);
+            }
+        }
+    }
+}
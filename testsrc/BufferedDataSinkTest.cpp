@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "BufferedDataSink.h"
+#include "StringDataSink.h"
+
+// Records the writes passed on by the buffered sink, and fails them once Fail is set
+class CRecordingDataSink : public CDataSink{
+    public:
+        std::vector< std::string > DWrites;
+        std::size_t DFlushCount = 0;
+        bool DFail = false;
+
+        bool Put(const char &ch) noexcept override{
+            DWrites.push_back(std::string(1,ch));
+            return !DFail;
+        }
+
+        bool Write(const std::vector<char> &buf) noexcept override{
+            DWrites.push_back(std::string(buf.begin(),buf.end()));
+            return !DFail;
+        }
+
+        bool Flush() noexcept override{
+            DFlushCount++;
+            return !DFail;
+        }
+};
+
+TEST(BufferedDataSink, PutTest){
+    auto Recorder = std::make_shared<CRecordingDataSink>();
+    CBufferedDataSink Sink(Recorder,4);
+
+    EXPECT_EQ(Sink.BufferSize(),4);
+    EXPECT_TRUE(Sink.Put('a'));
+    EXPECT_TRUE(Sink.Put('b'));
+    EXPECT_TRUE(Sink.Put('c'));
+    EXPECT_TRUE(Recorder->DWrites.empty());
+    EXPECT_TRUE(Sink.Put('d'));
+    ASSERT_EQ(Recorder->DWrites.size(),1);
+    EXPECT_EQ(Recorder->DWrites[0],"abcd");
+    EXPECT_TRUE(Sink.Put('e'));
+    EXPECT_TRUE(Sink.Flush());
+    ASSERT_EQ(Recorder->DWrites.size(),2);
+    EXPECT_EQ(Recorder->DWrites[1],"e");
+    EXPECT_EQ(Recorder->DFlushCount,1);
+}
+
+TEST(BufferedDataSink, WriteTest){
+    auto Recorder = std::make_shared<CRecordingDataSink>();
+    CBufferedDataSink Sink(Recorder,8);
+
+    EXPECT_TRUE(Sink.Write({'H','e','l','l','o'}));
+    EXPECT_TRUE(Recorder->DWrites.empty());
+    // A write that overflows the buffer fills it and leaves the rest buffered
+    EXPECT_TRUE(Sink.Write({' ','W','o','r'}));
+    ASSERT_EQ(Recorder->DWrites.size(),1);
+    EXPECT_EQ(Recorder->DWrites[0],"Hello Wo");
+    // Writes as large as the buffer follow the buffered bytes without being copied into it
+    EXPECT_TRUE(Sink.Put('l'));
+    EXPECT_TRUE(Sink.Write({'d',' ','a','g','a','i','n','!'}));
+    ASSERT_EQ(Recorder->DWrites.size(),3);
+    EXPECT_EQ(Recorder->DWrites[1],"rl");
+    EXPECT_EQ(Recorder->DWrites[2],"d again!");
+    EXPECT_TRUE(Sink.Write({}));
+    EXPECT_TRUE(Sink.Flush());
+    EXPECT_EQ(Recorder->DWrites.size(),3);
+}
+
+TEST(BufferedDataSink, DestructorTest){
+    auto StringSink = std::make_shared<CStringDataSink>();
+    {
+        CBufferedDataSink Sink(StringSink);
+        EXPECT_EQ(Sink.BufferSize(),CBufferedDataSink::DefaultBufferSize);
+        EXPECT_TRUE(Sink.Write({'B','y','e'}));
+        EXPECT_EQ(StringSink->String(),"");
+    }
+    EXPECT_EQ(StringSink->String(),"Bye");
+}
+
+TEST(BufferedDataSink, UnbufferedTest){
+    auto Recorder = std::make_shared<CRecordingDataSink>();
+    CBufferedDataSink Sink(Recorder,0);
+
+    EXPECT_TRUE(Sink.Put('a'));
+    EXPECT_TRUE(Sink.Write({'b','c'}));
+    ASSERT_EQ(Recorder->DWrites.size(),2);
+    EXPECT_EQ(Recorder->DWrites[0],"a");
+    EXPECT_EQ(Recorder->DWrites[1],"bc");
+}
+
+TEST(BufferedDataSink, ErrorTest){
+    auto Recorder = std::make_shared<CRecordingDataSink>();
+    CBufferedDataSink Sink(Recorder,2);
+
+    Recorder->DFail = true;
+    EXPECT_TRUE(Sink.Put('a'));
+    EXPECT_FALSE(Sink.Put('b'));
+    EXPECT_TRUE(Sink.Put('c'));
+    EXPECT_FALSE(Sink.Flush());
+    EXPECT_FALSE(Sink.Write({'x','y','z'}));
+}
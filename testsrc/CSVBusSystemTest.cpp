@@ -61,4 +61,32 @@ TEST(CSVBusSystem, RouteTest){
     EXPECT_EQ(Route1Index->GetStopID(0),1);
     EXPECT_EQ(Route1Index->GetStopID(1),2);
     EXPECT_EQ(Route1Index->GetStopID(2),1);
-}
\ No newline at end of file
+}
+TEST(CSVBusSystem, PathTest){
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,101\n"
+                                                                "2,102");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A,1\n"
+                                                                "A,2");
+    auto InStreamPaths = std::make_shared<CStringDataSource>(   "src_id,dest_id,routes,path\n"
+                                                                "101,102,A,\"101,105,103,102\"\n"
+                                                                "102,101,A,\"102\"");
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto CSVReaderPaths = std::make_shared<CDSVReader>(InStreamPaths,',');
+    CCSVBusSystem BusSystem(CSVReaderStops, CSVReaderRoutes, CSVReaderPaths);
+    // Paths of a single node are dropped
+    ASSERT_EQ(BusSystem.PathCount(),1);
+    auto Path = BusSystem.PathByIndex(0);
+    ASSERT_TRUE(bool(Path));
+    EXPECT_EQ(Path->StartNodeID(),101);
+    EXPECT_EQ(Path->EndNodeID(),102);
+    EXPECT_EQ(Path->NodeCount(),4);
+    EXPECT_EQ(Path->GetNodeID(1),105);
+    EXPECT_TRUE(Path->GetNodeID(4) == CStreetMap::InvalidNodeID);
+    EXPECT_EQ(BusSystem.PathByIndex(1),nullptr);
+
+    CCSVBusSystem NoPathBusSystem(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("stop_id,node_id"),','), std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("route,stop_id"),','));
+    EXPECT_EQ(NoPathBusSystem.PathCount(),0);
+}
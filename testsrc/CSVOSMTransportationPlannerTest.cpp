@@ -7,6 +7,13 @@
 #include "TransportationPlannerConfig.h"
 #include "DijkstraTransportationPlanner.h"
 #include "GeographicUtils.h"
+#include "ThreadPool.h"
+#include "PathCache.h"
+#include "DijkstraPathRouter.h"
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
 
 TEST(CSVOSMTransporationPlanner, SimpleTest){
     auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
@@ -293,4 +300,634 @@ TEST(CSVOSMTransporationPlanner, PathDescription){
     EXPECT_TRUE(Planner.GetPathDescription(Path3,Description3));
     EXPECT_EQ(Description3, ExpectedDescription3);
 
-}
\ No newline at end of file
+}
+TEST(CSVOSMTransporationPlanner, QueryContextTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< CTransportationPlanner::TNodeID > ExpectedShortestPath, ShortestPath;
+    std::vector< CTransportationPlanner::TTripStep > ExpectedFastestPath, FastestPath;
+    double ExpectedDistance = Planner.FindShortestPath(1,4,ExpectedShortestPath);
+    double ExpectedTime = Planner.FindFastestPath(1,4,ExpectedFastestPath);
+    ASSERT_NE(ExpectedDistance, CPathRouter::NoPathExists);
+
+    // Unknown nodes must not be added to the planner by a const query
+    auto Context = Planner.CreateQueryContext();
+    EXPECT_EQ(Planner.FindShortestPath(1,99,ShortestPath,*Context),CPathRouter::NoPathExists);
+    EXPECT_EQ(Planner.FindFastestPath(99,1,FastestPath,*Context),CPathRouter::NoPathExists);
+
+    // A context of another planner is rejected rather than replaced
+    struct SOtherContext : public CTransportationPlanner::SQueryContext{
+    };
+    SOtherContext OtherContext;
+    EXPECT_THROW(Planner.FindShortestPath(1,4,ShortestPath,OtherContext),std::invalid_argument);
+
+    const CDijkstraTransportationPlanner &SharedPlanner = Planner;
+    std::vector< std::size_t > Mismatches(4, 0);
+    std::vector< std::thread > Threads;
+    for(std::size_t ThreadIndex = 0; ThreadIndex < Mismatches.size(); ThreadIndex++){
+        Threads.emplace_back([&, ThreadIndex](){
+            auto ThreadContext = SharedPlanner.CreateQueryContext();
+            std::vector< CTransportationPlanner::TNodeID > ThreadShortestPath;
+            std::vector< CTransportationPlanner::TTripStep > ThreadFastestPath;
+            for(std::size_t Round = 0; Round < 100; Round++){
+                if((SharedPlanner.FindShortestPath(1,4,ThreadShortestPath,*ThreadContext) != ExpectedDistance)||(ThreadShortestPath != ExpectedShortestPath)){
+                    Mismatches[ThreadIndex]++;
+                }
+                if((SharedPlanner.FindFastestPath(1,4,ThreadFastestPath,*ThreadContext) != ExpectedTime)||(ThreadFastestPath != ExpectedFastestPath)){
+                    Mismatches[ThreadIndex]++;
+                }
+            }
+        });
+    }
+    for(auto &Thread : Threads){
+        Thread.join();
+    }
+    for(auto Count : Mismatches){
+        EXPECT_EQ(0, Count);
+    }
+}
+
+// Router with only the required methods, which records the threads its queries run on
+class CSerialPathRouter : public CPathRouter{
+    private:
+        CDijkstraPathRouter DRouter;
+    public:
+        std::mutex DMutex;
+        std::set< std::thread::id > DThreadIDs;
+
+        std::size_t VertexCount() const noexcept override{
+            return DRouter.VertexCount();
+        }
+        TVertexID AddVertex(std::any tag) noexcept override{
+            return DRouter.AddVertex(tag);
+        }
+        std::any GetVertexTag(TVertexID id) const noexcept override{
+            return DRouter.GetVertexTag(id);
+        }
+        bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept override{
+            return DRouter.AddEdge(src, dest, weight, bidir);
+        }
+        bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept override{
+            return DRouter.Precompute(deadline);
+        }
+        double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept override{
+            std::lock_guard< std::mutex > Lock(DMutex);
+            DThreadIDs.insert(std::this_thread::get_id());
+            return DRouter.FindShortestPath(src, dest, path);
+        }
+};
+
+TEST(CSVOSMTransporationPlanner, BatchQueryTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    std::vector< CDijkstraTransportationPlanner::TNodePair > Pairs;
+    for(std::size_t Round = 0; Round < 25; Round++){
+        for(CTransportationPlanner::TNodeID Src = 1; Src <= 4; Src++){
+            for(CTransportationPlanner::TNodeID Dest = 1; Dest <= 5; Dest++){
+                Pairs.push_back(std::make_pair(Src, Dest));
+            }
+        }
+    }
+    CThreadPool Pool(4);
+    std::vector< std::vector< CTransportationPlanner::TNodeID > > ShortestPaths;
+    std::vector< std::vector< CTransportationPlanner::TTripStep > > FastestPaths;
+    auto Distances = Planner.FindShortestPaths(Pairs, ShortestPaths, Pool);
+    auto Times = Planner.FindFastestPaths(Pairs, FastestPaths, Pool);
+    ASSERT_EQ(Distances.size(), Pairs.size());
+    ASSERT_EQ(ShortestPaths.size(), Pairs.size());
+    ASSERT_EQ(Times.size(), Pairs.size());
+    ASSERT_EQ(FastestPaths.size(), Pairs.size());
+    for(std::size_t Index = 0; Index < Pairs.size(); Index++){
+        std::vector< CTransportationPlanner::TNodeID > ShortestPath;
+        std::vector< CTransportationPlanner::TTripStep > FastestPath;
+        EXPECT_EQ(Distances[Index], Planner.FindShortestPath(Pairs[Index].first, Pairs[Index].second, ShortestPath));
+        EXPECT_EQ(ShortestPaths[Index], ShortestPath);
+        EXPECT_EQ(Times[Index], Planner.FindFastestPath(Pairs[Index].first, Pairs[Index].second, FastestPath));
+        EXPECT_EQ(FastestPaths[Index], FastestPath);
+    }
+
+    // Routers that are not safe to query at once have the batch run on the calling thread
+    std::vector< std::shared_ptr<CSerialPathRouter> > SerialRouters;
+    CDijkstraTransportationPlanner SerialPlanner(Config, [&](){
+        SerialRouters.push_back(std::make_shared<CSerialPathRouter>());
+        return SerialRouters.back();
+    });
+    std::vector< std::vector< CTransportationPlanner::TNodeID > > SerialPaths;
+    EXPECT_EQ(SerialPlanner.FindShortestPaths(Pairs, SerialPaths, Pool), Distances);
+    EXPECT_EQ(SerialPaths, ShortestPaths);
+    std::set< std::thread::id > ThreadIDs;
+    for(auto &Router : SerialRouters){
+        ThreadIDs.insert(Router->DThreadIDs.begin(), Router->DThreadIDs.end());
+    }
+    EXPECT_EQ(ThreadIDs, std::set< std::thread::id >({std::this_thread::get_id()}));
+}
+
+TEST(CSVOSMTransporationPlanner, MatrixTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<node id=\"5\" lat=\"38.4\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"12\">"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"5\"/>"
+                                                            "<tag k=\"bicycle\" v=\"no\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    // Node 5 can only be reached on foot and node 99 is not in the map
+    std::vector< CTransportationPlanner::TNodeID > Nodes = {1, 2, 3, 4, 5, 99};
+    auto Context = Planner.CreateQueryContext();
+    auto Distances = Planner.FindShortestDistanceMatrix(Nodes, Nodes, *Context);
+    auto Times = Planner.FindFastestTimeMatrix(Nodes, Nodes, *Context);
+    ASSERT_EQ(Distances.size(), Nodes.size());
+    ASSERT_EQ(Times.size(), Nodes.size());
+    for(std::size_t Row = 0; Row < Nodes.size(); Row++){
+        ASSERT_EQ(Distances[Row].size(), Nodes.size());
+        ASSERT_EQ(Times[Row].size(), Nodes.size());
+        for(std::size_t Column = 0; Column < Nodes.size(); Column++){
+            std::vector< CTransportationPlanner::TNodeID > ShortestPath;
+            std::vector< CTransportationPlanner::TTripStep > FastestPath;
+            EXPECT_EQ(Distances[Row][Column], Planner.FindShortestPath(Nodes[Row], Nodes[Column], ShortestPath, *Context));
+            EXPECT_EQ(Times[Row][Column], Planner.FindFastestPath(Nodes[Row], Nodes[Column], FastestPath, *Context));
+        }
+        EXPECT_EQ(Planner.FindShortestDistances(Nodes[Row], Nodes, *Context), Distances[Row]);
+        EXPECT_EQ(Planner.FindFastestTimes(Nodes[Row], Nodes, *Context), Times[Row]);
+    }
+    EXPECT_NE(Times[0][4], CPathRouter::NoPathExists);
+}
+
+TEST(CSVOSMTransporationPlanner, ReachableTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<node id=\"5\" lat=\"38.4\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"5\"/>"
+                                                            "<tag k=\"bicycle\" v=\"no\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    auto Context = Planner.CreateQueryContext();
+    std::vector< CTransportationPlanner::TNodeID > Nodes = {1, 2, 3, 4, 5};
+    auto Distances = Planner.FindShortestDistances(1, Nodes, *Context);
+    // Half way between the distances to nodes 2 and 3 reaches nodes 1 and 2 only
+    auto Budget = (Distances[1] + Distances[2]) / 2.0;
+    EXPECT_EQ(Planner.ReachableWithinDistance(1, Budget, *Context), std::vector< CTransportationPlanner::TNodeID >({1, 2}));
+    EXPECT_EQ(Planner.ReachableWithinDistance(1, 1000.0, *Context), Nodes);
+    EXPECT_TRUE(Planner.ReachableWithinDistance(99, 1000.0, *Context).empty());
+    // Node 5 cannot be reached by bike, and the walk budget is in seconds
+    auto Times = Planner.FindFastestTimes(1, Nodes, *Context);
+    EXPECT_EQ(Planner.ReachableWithin(1, 1e6, CTransportationPlanner::ETransportationMode::Bike, *Context), std::vector< CTransportationPlanner::TNodeID >({1, 2, 3, 4}));
+    EXPECT_EQ(Planner.ReachableWithin(1, Times[1] * 3600.0 - 1.0, CTransportationPlanner::ETransportationMode::Bike, *Context), std::vector< CTransportationPlanner::TNodeID >({1}));
+    EXPECT_EQ(Planner.ReachableWithin(1, 1e6, CTransportationPlanner::ETransportationMode::Walk, *Context), Nodes);
+
+    // The outline of the reachable nodes is their convex hull, node 4 lies on an edge and is left out
+    auto Outline = Planner.RegionOutline(Planner.ReachableWithinDistance(1, 1000.0, *Context));
+    std::vector< CStreetMap::TLocation > Expected = {{38.4,-121.8},{38.5,-121.7},{38.6,-121.7},{38.6,-121.8}};
+    EXPECT_EQ(Outline, Expected);
+}
+
+TEST(CSVOSMTransporationPlanner, BusStopPairTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.7\" lon=\"-121.7\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"bicycle\" v=\"no\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    // Stops are matched to the way by their node IDs, which differ from the stop IDs
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n"
+                                                            "101,1\n"
+                                                            "102,2\n"
+                                                            "103,3"
+                                                            );
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\n"
+                                                             "A,101\n"
+                                                             "A,102\n"
+                                                             "B,103\n"
+                                                             "B,102");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    double Distance12 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7));
+    double Distance23 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.7,-121.7));
+    // Route A rides from 1 to 2, nothing rides from 2 to 3 so that leg is walked. Boarding and
+    // alighting take the default bus stop time of 30 seconds each.
+    double BusTime = Distance12 / 25.0 + 60.0 / 3600.0;
+    double WalkTime = Distance23 * 1609.34 / 3.0 / 3600.0;
+    std::vector< CTransportationPlanner::TTripStep > Path, ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                            {CTransportationPlanner::ETransportationMode::Bus,2},
+                                                                            {CTransportationPlanner::ETransportationMode::Walk,3}};
+    EXPECT_NEAR(Planner.FindFastestPath(1, 3, Path), BusTime + WalkTime, 1e-9);
+    EXPECT_EQ(Path, ExpectedPath);
+    // Route B rides from 3 to 2
+    EXPECT_NEAR(Planner.FindFastestPath(3, 2, Path), Distance23 / 25.0 + 60.0 / 3600.0, 1e-9);
+}
+
+TEST(CSVOSMTransporationPlanner, BusRideTest){
+    auto OSM =  "<?xml version='1.0' encoding='UTF-8'?>"
+                "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                "<node id=\"3\" lat=\"38.7\" lon=\"-121.7\"/>"
+                "<node id=\"4\" lat=\"38.8\" lon=\"-121.7\"/>"
+                "<way id=\"10\">"
+                "<nd ref=\"1\"/>"
+                "<nd ref=\"2\"/>"
+                "<nd ref=\"3\"/>"
+                "<nd ref=\"4\"/>"
+                "<tag k=\"bicycle\" v=\"no\"/>"
+                "<tag k=\"maxspeed\" v=\"40 mph\"/>"
+                "</way>"
+                "</osm>";
+    auto Stops = "stop_id,node_id\n"
+                 "101,1\n"
+                 "104,4";
+    auto Routes = "route,stop_id\n"
+                  "A,101\n"
+                  "A,104";
+    auto CreatePlanner = [&](std::shared_ptr<CDSVReader> paths){
+        auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(OSM)));
+        auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops),','),
+                                                         std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes),','),
+                                                         paths);
+        return std::make_shared<CDijkstraTransportationPlanner>(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem));
+    };
+    double Distance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) +
+                      SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.7,-121.7)) +
+                      SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.7,-121.7),std::make_pair(38.8,-121.7));
+    std::vector< CTransportationPlanner::TTripStep > Path, ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                            {CTransportationPlanner::ETransportationMode::Bus,4}};
+    // Without bus paths the bus drives the street path between its stops at the way's speed limit,
+    // skipping the nodes in between
+    auto Planner = CreatePlanner(nullptr);
+    EXPECT_NEAR(Planner->FindFastestPath(1, 4, Path), Distance / 40.0 + 60.0 / 3600.0, 1e-9);
+    EXPECT_EQ(Path, ExpectedPath);
+    // The bus only runs from 1 to 4, so the way back is walked
+    EXPECT_NEAR(Planner->FindFastestPath(4, 1, Path), Distance * 1609.34 / 3.0 / 3600.0, 1e-9);
+    EXPECT_EQ(Path.size(), 4);
+    // A hop of a bus path that is not a street segment is driven at the default speed limit
+    auto PathPlanner = CreatePlanner(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("src_id,dest_id,routes,path\n"
+                                                                                                        "1,4,A,\"1,3,4\""),','));
+    double PathDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.7,-121.7));
+    double PathTime = PathDistance / 25.0 + SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.7,-121.7),std::make_pair(38.8,-121.7)) / 40.0;
+    EXPECT_NEAR(PathPlanner->FindFastestPath(1, 4, Path), PathTime + 60.0 / 3600.0, 1e-9);
+    EXPECT_EQ(Path, ExpectedPath);
+    // Ride vertices are not reported as reachable nodes
+    auto Context = PathPlanner->CreateQueryContext();
+    EXPECT_EQ(PathPlanner->ReachableWithin(1, 1e6, CTransportationPlanner::ETransportationMode::Bus, *Context), std::vector< CTransportationPlanner::TNodeID >({1, 4, 2, 3}));
+}
+
+TEST(CSVOSMTransporationPlanner, RaptorTest){
+    // Route A rides from 1 to 3 and route B from 4 to 6, the stops 3 and 4 are a short walk apart
+    auto OSM =  "<?xml version='1.0' encoding='UTF-8'?>"
+                "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                "<node id=\"3\" lat=\"38.7\" lon=\"-121.7\"/>"
+                "<node id=\"4\" lat=\"38.701\" lon=\"-121.7\"/>"
+                "<node id=\"5\" lat=\"38.8\" lon=\"-121.7\"/>"
+                "<node id=\"6\" lat=\"38.9\" lon=\"-121.7\"/>"
+                "<way id=\"10\">"
+                "<nd ref=\"1\"/>"
+                "<nd ref=\"2\"/>"
+                "<nd ref=\"3\"/>"
+                "<nd ref=\"4\"/>"
+                "<nd ref=\"5\"/>"
+                "<nd ref=\"6\"/>"
+                "<tag k=\"bicycle\" v=\"no\"/>"
+                "<tag k=\"maxspeed\" v=\"40 mph\"/>"
+                "</way>"
+                "</osm>";
+    auto Stops = "stop_id,node_id\n"
+                 "101,1\n"
+                 "103,3\n"
+                 "104,4\n"
+                 "106,6";
+    auto Routes = "route,stop_id\n"
+                  "A,101\n"
+                  "A,103\n"
+                  "B,104\n"
+                  "B,106";
+    auto CreatePlanner = [&](CDijkstraTransportationPlanner::ETransitEngine engine){
+        auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(OSM)));
+        auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops),','),
+                                                         std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes),','));
+        return std::make_shared<CDijkstraTransportationPlanner>(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem), nullptr, engine);
+    };
+    auto GraphPlanner = CreatePlanner(CDijkstraTransportationPlanner::ETransitEngine::Graph);
+    auto RaptorPlanner = CreatePlanner(CDijkstraTransportationPlanner::ETransitEngine::Raptor);
+    std::vector< CTransportationPlanner::TTripStep > GraphPath, RaptorPath, ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                                           {CTransportationPlanner::ETransportationMode::Bus,3},
+                                                                                           {CTransportationPlanner::ETransportationMode::Walk,4},
+                                                                                           {CTransportationPlanner::ETransportationMode::Bus,6}};
+    // Riding A, walking to 4 and riding B
+    EXPECT_NEAR(RaptorPlanner->FindFastestPath(1, 6, RaptorPath), GraphPlanner->FindFastestPath(1, 6, GraphPath), 1e-9);
+    EXPECT_EQ(RaptorPath, ExpectedPath);
+    EXPECT_EQ(GraphPath, ExpectedPath);
+    // Both engines agree on every trip, including walks to the first stop and from the last one
+    auto Context = RaptorPlanner->CreateQueryContext();
+    for(CTransportationPlanner::TNodeID Source = 1; Source <= 6; Source++){
+        for(CTransportationPlanner::TNodeID Destination = 1; Destination <= 6; Destination++){
+            double RaptorTime = RaptorPlanner->FindFastestPath(Source, Destination, RaptorPath, *Context);
+            EXPECT_NEAR(RaptorTime, GraphPlanner->FindFastestPath(Source, Destination, GraphPath), 1e-9);
+            ASSERT_FALSE(RaptorPath.empty());
+            EXPECT_EQ(RaptorPath.front().second, Source);
+            EXPECT_EQ(RaptorPath.back().second, Destination);
+        }
+    }
+}
+
+TEST(CSVOSMTransporationPlanner, RaptorTimeMatrixTest){
+    // The stops 3 and 4 are too far apart to change buses with RAPTOR, which the layered router allows
+    auto OSM =  "<?xml version='1.0' encoding='UTF-8'?>"
+                "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                "<node id=\"3\" lat=\"38.7\" lon=\"-121.7\"/>"
+                "<node id=\"4\" lat=\"38.75\" lon=\"-121.7\"/>"
+                "<node id=\"6\" lat=\"38.9\" lon=\"-121.7\"/>"
+                "<way id=\"10\">"
+                "<nd ref=\"1\"/>"
+                "<nd ref=\"3\"/>"
+                "<nd ref=\"4\"/>"
+                "<nd ref=\"6\"/>"
+                "<tag k=\"bicycle\" v=\"no\"/>"
+                "<tag k=\"maxspeed\" v=\"40 mph\"/>"
+                "</way>"
+                "</osm>";
+    auto Stops = "stop_id,node_id\n"
+                 "101,1\n"
+                 "103,3\n"
+                 "104,4\n"
+                 "106,6";
+    auto Routes = "route,stop_id\n"
+                  "A,101\n"
+                  "A,103\n"
+                  "B,104\n"
+                  "B,106";
+    auto CreatePlanner = [&](CDijkstraTransportationPlanner::ETransitEngine engine){
+        auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(OSM)));
+        auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops),','),
+                                                         std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes),','));
+        return std::make_shared<CDijkstraTransportationPlanner>(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem), nullptr, engine);
+    };
+    auto GraphPlanner = CreatePlanner(CDijkstraTransportationPlanner::ETransitEngine::Graph);
+    auto RaptorPlanner = CreatePlanner(CDijkstraTransportationPlanner::ETransitEngine::Raptor);
+    std::vector< CTransportationPlanner::TTripStep > Path;
+    EXPECT_GT(RaptorPlanner->FindFastestPath(1, 6, Path), GraphPlanner->FindFastestPath(1, 6, Path) + 1e-6);
+
+    // The matrix and the one-to-many times match the RAPTOR trips
+    std::vector< CTransportationPlanner::TNodeID > Nodes = {1, 3, 4, 6, 99};
+    auto Context = RaptorPlanner->CreateQueryContext();
+    auto Times = RaptorPlanner->FindFastestTimeMatrix(Nodes, Nodes, *Context);
+    for(std::size_t Row = 0; Row < Nodes.size(); Row++){
+        for(std::size_t Column = 0; Column < Nodes.size(); Column++){
+            EXPECT_NEAR(Times[Row][Column], RaptorPlanner->FindFastestPath(Nodes[Row], Nodes[Column], Path, *Context), 1e-9);
+        }
+        EXPECT_EQ(RaptorPlanner->FindFastestTimes(Nodes[Row], Nodes, *Context), Times[Row]);
+    }
+}
+
+TEST(CSVOSMTransporationPlanner, PathCacheTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    CDijkstraTransportationPlanner Planner(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem));
+    EXPECT_EQ(Planner.PathCache(), nullptr);
+    std::vector< CTransportationPlanner::TNodeID > ExpectedShortestPath, ShortestPath;
+    std::vector< CTransportationPlanner::TTripStep > ExpectedFastestPath, FastestPath;
+    double ExpectedDistance = Planner.FindShortestPath(1,4,ExpectedShortestPath);
+    double ExpectedTime = Planner.FindFastestPath(1,4,ExpectedFastestPath);
+
+    // The first query of a pair misses and the repeats hit with the same result
+    Planner.SetPathCacheCapacity(16);
+    auto Cache = Planner.PathCache();
+    ASSERT_NE(Cache, nullptr);
+    auto Context = Planner.CreateQueryContext();
+    for(int Round = 0; Round < 3; Round++){
+        EXPECT_EQ(Planner.FindShortestPath(1,4,ShortestPath,*Context), ExpectedDistance);
+        EXPECT_EQ(ShortestPath, ExpectedShortestPath);
+        EXPECT_EQ(Planner.FindFastestPath(1,4,FastestPath,*Context), ExpectedTime);
+        EXPECT_EQ(FastestPath, ExpectedFastestPath);
+    }
+    EXPECT_EQ(Cache->Misses(), 2);
+    EXPECT_EQ(Cache->Hits(), 4);
+    // Missing paths are cached too and leave the path alone
+    EXPECT_EQ(Planner.FindShortestPath(1,99,ShortestPath), CPathRouter::NoPathExists);
+    EXPECT_EQ(Planner.FindShortestPath(1,99,ShortestPath), CPathRouter::NoPathExists);
+    EXPECT_EQ(ShortestPath, ExpectedShortestPath);
+    EXPECT_EQ(Cache->Hits(), 5);
+    // Batch queries share the cache
+    CThreadPool Pool(2);
+    std::vector< std::vector< CTransportationPlanner::TNodeID > > ShortestPaths;
+    auto Distances = Planner.FindShortestPaths({{1,4},{1,4},{4,1}}, ShortestPaths, Pool);
+    EXPECT_EQ(Distances[0], ExpectedDistance);
+    EXPECT_EQ(ShortestPaths[1], ExpectedShortestPath);
+    EXPECT_EQ(Cache->Hits(), 7);
+    Planner.SetPathCacheCapacity(0);
+    EXPECT_EQ(Planner.PathCache(), nullptr);
+}
+
+TEST(CSVOSMTransporationPlanner, SnapshotTest){
+    auto OSM =  "<?xml version='1.0' encoding='UTF-8'?>"
+                "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                "<node id=\"3\" lat=\"38.7\" lon=\"-121.7\"/>"
+                "<node id=\"4\" lat=\"38.701\" lon=\"-121.7\"/>"
+                "<node id=\"5\" lat=\"38.8\" lon=\"-121.7\"/>"
+                "<node id=\"6\" lat=\"38.9\" lon=\"-121.7\"/>"
+                "<node id=\"7\" lat=\"38.8\" lon=\"-121.8\"/>"
+                "<way id=\"10\">"
+                "<nd ref=\"1\"/>"
+                "<nd ref=\"2\"/>"
+                "<nd ref=\"3\"/>"
+                "<nd ref=\"4\"/>"
+                "<nd ref=\"5\"/>"
+                "<nd ref=\"6\"/>"
+                "<tag k=\"maxspeed\" v=\"40 mph\"/>"
+                "</way>"
+                "<way id=\"11\">"
+                "<nd ref=\"5\"/>"
+                "<nd ref=\"7\"/>"
+                "<nd ref=\"1\"/>"
+                "<tag k=\"oneway\" v=\"yes\"/>"
+                "</way>"
+                "</osm>";
+    auto Stops = "stop_id,node_id\n"
+                 "101,1\n"
+                 "103,3\n"
+                 "104,4\n"
+                 "106,6";
+    auto Routes = "route,stop_id\n"
+                  "A,101\n"
+                  "A,103\n"
+                  "B,104\n"
+                  "B,106";
+    const std::string Path = "./testtmp/planner.snapshot";
+    const uint64_t SourceKey = 1234;
+    // A snapshot only needs the speeds of the configuration
+    auto SnapshotConfig = std::make_shared<STransportationPlannerConfig>(nullptr, nullptr);
+    for(auto Engine : {CDijkstraTransportationPlanner::ETransitEngine::Graph, CDijkstraTransportationPlanner::ETransitEngine::Raptor}){
+        std::remove(Path.c_str());
+        EXPECT_EQ(CDijkstraTransportationPlanner::LoadSnapshot(Path, SourceKey, SnapshotConfig, nullptr, Engine), nullptr);
+        auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(OSM)));
+        auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Stops),','),
+                                                         std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(Routes),','));
+        CDijkstraTransportationPlanner Planner(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem), nullptr, Engine);
+        ASSERT_TRUE(Planner.SaveSnapshot(Path, SourceKey));
+        auto Loaded = CDijkstraTransportationPlanner::LoadSnapshot(Path, SourceKey, SnapshotConfig, nullptr, Engine);
+        ASSERT_NE(Loaded, nullptr);
+
+        // The loaded planner answers every query the way the planner built from the sources does
+        ASSERT_EQ(Loaded->NodeCount(), Planner.NodeCount());
+        for(std::size_t Index = 0; Index < Planner.NodeCount(); Index++){
+            EXPECT_EQ(Loaded->SortedNodeByIndex(Index)->ID(), Planner.SortedNodeByIndex(Index)->ID());
+            EXPECT_EQ(Loaded->SortedNodeByIndex(Index)->Location(), Planner.SortedNodeByIndex(Index)->Location());
+        }
+        EXPECT_EQ(Loaded->SortedNodeByIndex(Planner.NodeCount()), nullptr);
+        std::vector< CTransportationPlanner::TNodeID > ShortestPath, LoadedShortestPath;
+        std::vector< CTransportationPlanner::TTripStep > FastestPath, LoadedFastestPath;
+        std::vector< std::string > Description, LoadedDescription;
+        for(CTransportationPlanner::TNodeID Source = 1; Source <= 7; Source++){
+            for(CTransportationPlanner::TNodeID Destination = 1; Destination <= 7; Destination++){
+                EXPECT_EQ(Loaded->FindShortestPath(Source, Destination, LoadedShortestPath), Planner.FindShortestPath(Source, Destination, ShortestPath));
+                EXPECT_EQ(LoadedShortestPath, ShortestPath);
+                EXPECT_EQ(Loaded->FindFastestPath(Source, Destination, LoadedFastestPath), Planner.FindFastestPath(Source, Destination, FastestPath));
+                EXPECT_EQ(LoadedFastestPath, FastestPath);
+            }
+        }
+        EXPECT_TRUE(Planner.GetPathDescription(FastestPath, Description));
+        EXPECT_TRUE(Loaded->GetPathDescription(LoadedFastestPath, LoadedDescription));
+        EXPECT_EQ(LoadedDescription, Description);
+
+        // Other sources, another transit engine or other speeds make the snapshot stale
+        auto OtherEngine = Engine == CDijkstraTransportationPlanner::ETransitEngine::Graph ? CDijkstraTransportationPlanner::ETransitEngine::Raptor : CDijkstraTransportationPlanner::ETransitEngine::Graph;
+        EXPECT_EQ(CDijkstraTransportationPlanner::LoadSnapshot(Path, SourceKey + 1, SnapshotConfig, nullptr, Engine), nullptr);
+        EXPECT_EQ(CDijkstraTransportationPlanner::LoadSnapshot(Path, SourceKey, SnapshotConfig, nullptr, OtherEngine), nullptr);
+        EXPECT_EQ(CDijkstraTransportationPlanner::LoadSnapshot(Path, SourceKey, std::make_shared<STransportationPlannerConfig>(nullptr, nullptr, 4.0), nullptr, Engine), nullptr);
+    }
+    std::remove(Path.c_str());
+}
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "ContractionHierarchyPathRouter.h"
+#include "DijkstraPathRouter.h"
+#include <random>
+
+TEST(ContractionHierarchyPathRouter, RouteTest){
+    CContractionHierarchyPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 6; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+        EXPECT_EQ(Index,std::any_cast<std::size_t>(PathRouter.GetVertexTag(Vertices.back())));
+    }
+    PathRouter.AddEdge(Vertices[0],Vertices[4],3);
+    PathRouter.AddEdge(Vertices[4],Vertices[5],90);
+    PathRouter.AddEdge(Vertices[5],Vertices[3],6);
+    PathRouter.AddEdge(Vertices[3],Vertices[2],8);
+    PathRouter.AddEdge(Vertices[2],Vertices[0],1);
+    PathRouter.AddEdge(Vertices[2],Vertices[1],3);
+    PathRouter.AddEdge(Vertices[1],Vertices[3],9);
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    EXPECT_EQ(6, PathRouter.ContractedCount());
+    std::vector<CPathRouter::TVertexID> Route;
+    std::vector<CPathRouter::TVertexID> ExpectedRoute = {Vertices[2],Vertices[1],Vertices[3]};
+    EXPECT_EQ(12.0, PathRouter.FindShortestPath(Vertices[2],Vertices[3],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    ExpectedRoute = {Vertices[3],Vertices[2],Vertices[0],Vertices[4],Vertices[5]};
+    EXPECT_EQ(102.0, PathRouter.FindShortestPath(Vertices[3],Vertices[5],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    ExpectedRoute = {Vertices[4]};
+    EXPECT_EQ(0.0, PathRouter.FindShortestPath(Vertices[4],Vertices[4],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+}
+
+TEST(ContractionHierarchyPathRouter, NoPathExists){
+    CContractionHierarchyPathRouter PathRouter;
+    auto VertexID1 = PathRouter.AddVertex(std::string("Start"));
+    auto VertexID2 = PathRouter.AddVertex(std::string("End"));
+    std::vector<CPathRouter::TVertexID> Path;
+
+    PathRouter.AddEdge(VertexID2, VertexID1, 1.0);
+    EXPECT_EQ(CPathRouter::NoPathExists, PathRouter.FindShortestPath(VertexID1, VertexID2, Path));
+    EXPECT_EQ(CPathRouter::NoPathExists, PathRouter.FindShortestPath(VertexID1, 5, Path));
+    EXPECT_FALSE(PathRouter.AddEdge(VertexID1, VertexID2, -1.0));
+}
+
+TEST(ContractionHierarchyPathRouter, DeadlineTest){
+    CContractionHierarchyPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 4; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    PathRouter.AddEdge(Vertices[0],Vertices[1],1.0,true);
+    PathRouter.AddEdge(Vertices[1],Vertices[2],1.0,true);
+    PathRouter.AddEdge(Vertices[2],Vertices[3],1.0,true);
+    // An expired deadline leaves every vertex in the core, queries still work
+    EXPECT_FALSE(PathRouter.Precompute(std::chrono::steady_clock::now() - std::chrono::seconds(1)));
+    EXPECT_EQ(0, PathRouter.ContractedCount());
+    std::vector<CPathRouter::TVertexID> Path;
+    std::vector<CPathRouter::TVertexID> ExpectedPath = {Vertices[3],Vertices[2],Vertices[1],Vertices[0]};
+    EXPECT_EQ(3.0, PathRouter.FindShortestPath(Vertices[3],Vertices[0],Path));
+    EXPECT_EQ(ExpectedPath, Path);
+    // A later Precompute with time to spare completes the hierarchy
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    EXPECT_EQ(4, PathRouter.ContractedCount());
+    EXPECT_EQ(3.0, PathRouter.FindShortestPath(Vertices[3],Vertices[0],Path));
+    EXPECT_EQ(ExpectedPath, Path);
+    // Modifying the graph discards the hierarchy
+    PathRouter.AddEdge(Vertices[3],Vertices[0],1.0);
+    EXPECT_EQ(0, PathRouter.ContractedCount());
+    ExpectedPath = {Vertices[3],Vertices[0]};
+    EXPECT_EQ(1.0, PathRouter.FindShortestPath(Vertices[3],Vertices[0],Path));
+    EXPECT_EQ(ExpectedPath, Path);
+}
+
+TEST(ContractionHierarchyPathRouter, MatchesDijkstraTest){
+    CDijkstraPathRouter Dijkstra;
+    std::mt19937 Generator(42);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    std::vector< std::tuple<std::size_t, std::size_t, double, bool> > Edges;
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Dijkstra.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        Edges.push_back(std::make_tuple(VertexDistribution(Generator), VertexDistribution(Generator), double(WeightDistribution(Generator)), Index % 3 == 0));
+        Dijkstra.AddEdge(std::get<0>(Edges.back()), std::get<1>(Edges.back()), std::get<2>(Edges.back()), std::get<3>(Edges.back()));
+    }
+    std::vector< std::pair<std::size_t, std::size_t> > Queries;
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Queries.push_back(std::make_pair(VertexDistribution(Generator), VertexDistribution(Generator)));
+    }
+    // Check both the full hierarchy and one cut short by its deadline
+    for(auto Deadline : {std::chrono::steady_clock::now() + std::chrono::seconds(10), std::chrono::steady_clock::now()}){
+        CContractionHierarchyPathRouter Hierarchy;
+        for(std::size_t Index = 0; Index < 200; Index++){
+            Hierarchy.AddVertex(Index);
+        }
+        for(auto &Edge : Edges){
+            Hierarchy.AddEdge(std::get<0>(Edge), std::get<1>(Edge), std::get<2>(Edge), std::get<3>(Edge));
+        }
+        Hierarchy.Precompute(Deadline);
+        for(auto &Query : Queries){
+            std::vector<CPathRouter::TVertexID> HierarchyPath, DijkstraPath;
+            auto Expected = Dijkstra.FindShortestPath(Query.first, Query.second, DijkstraPath);
+            auto Actual = Hierarchy.FindShortestPath(Query.first, Query.second, HierarchyPath);
+            EXPECT_EQ(Expected, Actual);
+            if(CPathRouter::NoPathExists != Actual){
+                // The unpacked path must consist of original edges adding up to the distance
+                ASSERT_FALSE(HierarchyPath.empty());
+                EXPECT_EQ(Query.first, HierarchyPath.front());
+                EXPECT_EQ(Query.second, HierarchyPath.back());
+                double Length = 0.0;
+                for(std::size_t Step = 1; Step < HierarchyPath.size(); Step++){
+                    double Hop = CPathRouter::NoPathExists;
+                    for(auto &Edge : Edges){
+                        if(((std::get<0>(Edge) == HierarchyPath[Step-1])&&(std::get<1>(Edge) == HierarchyPath[Step]))||(std::get<3>(Edge)&&(std::get<1>(Edge) == HierarchyPath[Step-1])&&(std::get<0>(Edge) == HierarchyPath[Step]))){
+                            Hop = std::min(Hop, std::get<2>(Edge));
+                        }
+                    }
+                    Length += Hop;
+                }
+                EXPECT_EQ(Actual, Length);
+            }
+        }
+    }
+}
+
+TEST(ContractionHierarchyPathRouter, WorkspaceTest){
+    CContractionHierarchyPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 5; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    for(std::size_t Index = 1; Index < 5; Index++){
+        PathRouter.AddEdge(Vertices[Index-1],Vertices[Index],1.0);
+    }
+    auto Workspace = PathRouter.CreateWorkspace();
+    std::vector<CPathRouter::TVertexID> Path;
+    std::vector<CPathRouter::TVertexID> ExpectedPath = {Vertices[1],Vertices[2],Vertices[3]};
+    // Queries through a workspace also work before Precompute
+    EXPECT_EQ(2.0, PathRouter.FindShortestPath(Vertices[1],Vertices[3],Path,*Workspace));
+    EXPECT_EQ(ExpectedPath, Path);
+    PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    const CContractionHierarchyPathRouter &SharedRouter = PathRouter;
+    for(std::size_t Round = 0; Round < 3; Round++){
+        EXPECT_EQ(2.0, SharedRouter.FindShortestPath(Vertices[1],Vertices[3],Path,*Workspace));
+        EXPECT_EQ(ExpectedPath, Path);
+        EXPECT_EQ(CPathRouter::NoPathExists, SharedRouter.FindShortestPath(Vertices[3],Vertices[1],Path,*Workspace));
+        EXPECT_EQ(4.0, SharedRouter.FindShortestPath(Vertices[0],Vertices[4],Path,*Workspace));
+    }
+}
+
+TEST(ContractionHierarchyPathRouter, MatrixTest){
+    CDijkstraPathRouter Dijkstra;
+    std::mt19937 Generator(7);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    std::vector< std::tuple<std::size_t, std::size_t, double, bool> > Edges;
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Dijkstra.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        Edges.push_back(std::make_tuple(VertexDistribution(Generator), VertexDistribution(Generator), double(WeightDistribution(Generator)), Index % 3 == 0));
+        Dijkstra.AddEdge(std::get<0>(Edges.back()), std::get<1>(Edges.back()), std::get<2>(Edges.back()), std::get<3>(Edges.back()));
+    }
+    std::vector< CPathRouter::TVertexID > Sources, Dests;
+    for(std::size_t Index = 0; Index < 10; Index++){
+        Sources.push_back(VertexDistribution(Generator));
+    }
+    for(std::size_t Index = 0; Index < 15; Index++){
+        Dests.push_back(VertexDistribution(Generator));
+    }
+    Sources.push_back(1000);
+    Dests.push_back(Dests.front());
+    Dests.push_back(1000);
+    // Check the full hierarchy, one cut short by its deadline, and a router with no hierarchy
+    for(std::size_t Build = 0; Build < 3; Build++){
+        CContractionHierarchyPathRouter Hierarchy;
+        for(std::size_t Index = 0; Index < 200; Index++){
+            Hierarchy.AddVertex(Index);
+        }
+        for(auto &Edge : Edges){
+            Hierarchy.AddEdge(std::get<0>(Edge), std::get<1>(Edge), std::get<2>(Edge), std::get<3>(Edge));
+        }
+        if(Build < 2){
+            Hierarchy.Precompute(Build ? std::chrono::steady_clock::now() : std::chrono::steady_clock::now() + std::chrono::seconds(10));
+        }
+        auto Workspace = Hierarchy.CreateWorkspace();
+        auto Matrix = Hierarchy.FindDistanceMatrix(Sources, Dests, *Workspace);
+        ASSERT_EQ(Matrix.size(), Sources.size());
+        for(std::size_t Row = 0; Row < Sources.size(); Row++){
+            ASSERT_EQ(Matrix[Row].size(), Dests.size());
+            for(std::size_t Column = 0; Column < Dests.size(); Column++){
+                std::vector<CPathRouter::TVertexID> Path;
+                EXPECT_EQ(Matrix[Row][Column], Dijkstra.FindShortestPath(Sources[Row], Dests[Column], Path));
+            }
+        }
+        EXPECT_EQ(Hierarchy.FindDistances(Sources.front(), Dests, *Workspace), Matrix.front());
+    }
+}
+
+TEST(ContractionHierarchyPathRouter, ReachableTest){
+    CContractionHierarchyPathRouter Router;
+    CDijkstraPathRouter Dijkstra;
+    std::mt19937 Generator(11);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Router.AddVertex(Index);
+        Dijkstra.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        double Weight = WeightDistribution(Generator);
+        Router.AddEdge(Source, Dest, Weight, Index % 3 == 0);
+        Dijkstra.AddEdge(Source, Dest, Weight, Index % 3 == 0);
+    }
+    Router.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    auto Workspace = Router.CreateWorkspace();
+    auto DijkstraWorkspace = Dijkstra.CreateWorkspace();
+    std::vector< CPathRouter::TVertexID > AllVertices;
+    for(std::size_t Index = 0; Index < 200; Index++){
+        AllVertices.push_back(Index);
+    }
+    for(double Budget : {0.0, 50.0, 150.0, 1000.0}){
+        auto Reached = Router.FindVerticesWithin(3, Budget, *Workspace);
+        auto Distances = Dijkstra.FindDistances(3, AllVertices, *DijkstraWorkspace);
+        std::size_t Expected = 0;
+        for(auto Distance : Distances){
+            Expected += Distance <= Budget ? 1 : 0;
+        }
+        EXPECT_EQ(Reached.size(), Expected);
+        for(std::size_t Index = 0; Index < Reached.size(); Index++){
+            EXPECT_EQ(Reached[Index].second, Distances[Reached[Index].first]);
+            if(Index){
+                EXPECT_LE(Reached[Index-1].second, Reached[Index].second);
+            }
+        }
+    }
+}
@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "DijkstraPathRouter.h"
+#include "IndexedPriorityQueue.h"
+#include "MultiMetricGraph.h"
+#include <random>
+#include <thread>
+#include <tuple>
 
 TEST(DijkstraPathRouter, RouteTest){
     CDijkstraPathRouter PathRouter;
@@ -104,7 +109,7 @@ TEST(DijkstraPathRouter, AddingDuplicateEdges) {
     PathRouter.AddEdge(VertexID1, VertexID2, 3.0); // Second addition
 
     std::vector<CPathRouter::TVertexID> Path;
-    double PathLength = PathRouter.FindShortestPath(VertexID1, VertexID2, Path);
+    PathRouter.FindShortestPath(VertexID1, VertexID2, Path);
 
     // The test expectation depends on how the implementation handles duplicate edges
     // This needs to be adjusted according to the actual behavior (e.g., it could keep the first, keep the last, or sum the weights)
@@ -121,3 +126,392 @@ TEST(DijkstraPathRouter, NegativeEdgeWeight) {
     // The operation should fail or ignore the edge with negative weight
     EXPECT_FALSE(Success);
 }
+
+TEST(DijkstraPathRouter, QueueTypeTest){
+    for(auto QueueType : {CDijkstraPathRouter::EQueueType::Rebuild, CDijkstraPathRouter::EQueueType::BinaryHeap, CDijkstraPathRouter::EQueueType::QuaternaryHeap}){
+        CDijkstraPathRouter PathRouter(QueueType);
+        EXPECT_EQ(QueueType, PathRouter.QueueType());
+        std::vector<CPathRouter::TVertexID> Vertices;
+        for(std::size_t Index = 0; Index < 6; Index++){
+            Vertices.push_back(PathRouter.AddVertex(Index));
+        }
+        PathRouter.AddEdge(Vertices[0],Vertices[4],3);
+        PathRouter.AddEdge(Vertices[4],Vertices[5],90);
+        PathRouter.AddEdge(Vertices[5],Vertices[3],6);
+        PathRouter.AddEdge(Vertices[3],Vertices[2],8);
+        PathRouter.AddEdge(Vertices[2],Vertices[0],1);
+        PathRouter.AddEdge(Vertices[2],Vertices[1],3);
+        PathRouter.AddEdge(Vertices[1],Vertices[3],9);
+        std::vector<CPathRouter::TVertexID> Route;
+        std::vector<CPathRouter::TVertexID> ExpectedRoute = {Vertices[2],Vertices[0],Vertices[4],Vertices[5]};
+        EXPECT_EQ(94.0, PathRouter.FindShortestPath(Vertices[2],Vertices[5],Route));
+        EXPECT_EQ(Route,ExpectedRoute);
+        ExpectedRoute = {Vertices[3]};
+        EXPECT_EQ(0.0, PathRouter.FindShortestPath(Vertices[3],Vertices[3],Route));
+        EXPECT_EQ(Route,ExpectedRoute);
+    }
+}
+
+TEST(DijkstraPathRouter, IndexedPriorityQueueTest){
+    CIndexedPriorityQueue<4> Queue(8);
+    EXPECT_TRUE(Queue.Empty());
+    Queue.Push(3, 7.0);
+    Queue.Push(5, 2.0);
+    Queue.Push(1, 9.0);
+    Queue.Push(6, 4.0);
+    EXPECT_EQ(4, Queue.Size());
+    EXPECT_TRUE(Queue.Contains(1));
+    EXPECT_FALSE(Queue.Contains(2));
+    Queue.Push(1, 1.0);
+    Queue.Push(3, 8.0);
+    EXPECT_EQ(4, Queue.Size());
+    EXPECT_EQ(1.0, Queue.TopPriority());
+    EXPECT_EQ(1, Queue.Pop());
+    EXPECT_FALSE(Queue.Contains(1));
+    EXPECT_EQ(5, Queue.Pop());
+    EXPECT_EQ(6, Queue.Pop());
+    EXPECT_EQ(3, Queue.Top());
+    EXPECT_EQ(7.0, Queue.TopPriority());
+    Queue.Clear();
+    EXPECT_TRUE(Queue.Empty());
+    EXPECT_FALSE(Queue.Contains(3));
+}
+
+TEST(DijkstraPathRouter, PrecomputeTest){
+    CDijkstraPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 6; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    PathRouter.AddEdge(Vertices[0],Vertices[4],3);
+    PathRouter.AddEdge(Vertices[4],Vertices[5],90);
+    PathRouter.AddEdge(Vertices[5],Vertices[3],6);
+    PathRouter.AddEdge(Vertices[3],Vertices[2],8);
+    PathRouter.AddEdge(Vertices[2],Vertices[0],1);
+    PathRouter.AddEdge(Vertices[2],Vertices[1],3);
+    PathRouter.AddEdge(Vertices[1],Vertices[3],9);
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(30)));
+    std::vector<CPathRouter::TVertexID> Route;
+    std::vector<CPathRouter::TVertexID> ExpectedRoute = {Vertices[2],Vertices[1],Vertices[3]};
+    EXPECT_EQ(12.0, PathRouter.FindShortestPath(Vertices[2],Vertices[3],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    EXPECT_EQ(3, std::any_cast<std::size_t>(PathRouter.GetVertexTag(Vertices[3])));
+
+    // Modifying the graph after Precompute must still be reflected in queries
+    auto VertexID = PathRouter.AddVertex(std::size_t(6));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[2],VertexID,1,true));
+    EXPECT_TRUE(PathRouter.AddEdge(VertexID,Vertices[3],1));
+    ExpectedRoute = {Vertices[2],VertexID,Vertices[3]};
+    EXPECT_EQ(2.0, PathRouter.FindShortestPath(Vertices[2],Vertices[3],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(30)));
+    ExpectedRoute = {Vertices[3],Vertices[2],VertexID};
+    EXPECT_EQ(9.0, PathRouter.FindShortestPath(Vertices[3],VertexID,Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+}
+
+TEST(DijkstraPathRouter, HeuristicTest){
+    // Vertices on a line at positions 0, 1, ..., 9 with a detour that is never shorter
+    CDijkstraPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 10; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    for(std::size_t Index = 1; Index < 10; Index++){
+        PathRouter.AddEdge(Vertices[Index-1],Vertices[Index],1.0,true);
+    }
+    PathRouter.AddEdge(Vertices[0],Vertices[9],9.5,true);
+    std::size_t HeuristicCalls = 0;
+    PathRouter.SetHeuristic([&HeuristicCalls](CPathRouter::TVertexID vertex, CPathRouter::TVertexID dest){
+        HeuristicCalls++;
+        return vertex < dest ? double(dest - vertex) : double(vertex - dest);
+    });
+    std::vector<CPathRouter::TVertexID> Route;
+    std::vector<CPathRouter::TVertexID> ExpectedRoute = {Vertices[2],Vertices[3],Vertices[4],Vertices[5]};
+    EXPECT_EQ(3.0, PathRouter.FindShortestPath(Vertices[2],Vertices[5],Route));
+    EXPECT_EQ(Route,ExpectedRoute);
+    EXPECT_LT(0, HeuristicCalls);
+    EXPECT_EQ(9.0, PathRouter.FindShortestPath(Vertices[0],Vertices[9],Route));
+    EXPECT_EQ(10, Route.size());
+    PathRouter.SetHeuristic(nullptr);
+    HeuristicCalls = 0;
+    EXPECT_EQ(9.0, PathRouter.FindShortestPath(Vertices[9],Vertices[0],Route));
+    EXPECT_EQ(0, HeuristicCalls);
+}
+
+TEST(DijkstraPathRouter, LandmarkTest){
+    CDijkstraPathRouter Plain, Landmarks;
+    std::mt19937 Generator(42);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    for(std::size_t Index = 0; Index < 200; Index++){
+        Plain.AddVertex(Index);
+        Landmarks.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        double Weight = WeightDistribution(Generator);
+        Plain.AddEdge(Source, Dest, Weight, Index % 3 == 0);
+        Landmarks.AddEdge(Source, Dest, Weight, Index % 3 == 0);
+    }
+    Landmarks.SetLandmarkCount(4);
+    EXPECT_EQ(4, Landmarks.LandmarkCount());
+    // An expired deadline selects no landmarks
+    Landmarks.Precompute(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    EXPECT_EQ(0, Landmarks.SelectedLandmarkCount());
+    Landmarks.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    EXPECT_EQ(4, Landmarks.SelectedLandmarkCount());
+    EXPECT_EQ(2 * 200 * sizeof(double), Landmarks.LandmarkBytes());
+    EXPECT_LT(0, Landmarks.LandmarkSelectionTime().count());
+    for(std::size_t Index = 0; Index < 200; Index++){
+        auto Source = VertexDistribution(Generator);
+        auto Dest = VertexDistribution(Generator);
+        std::vector<CPathRouter::TVertexID> PlainPath, LandmarkPath;
+        EXPECT_EQ(Plain.FindShortestPath(Source, Dest, PlainPath), Landmarks.FindShortestPath(Source, Dest, LandmarkPath));
+    }
+    // Modifying the graph drops the landmarks until the next Precompute
+    Landmarks.AddEdge(0, 1, 1.0);
+    EXPECT_EQ(0, Landmarks.SelectedLandmarkCount());
+    std::vector<CPathRouter::TVertexID> Path;
+    EXPECT_EQ(1.0, Landmarks.FindShortestPath(0, 1, Path));
+}
+
+TEST(DijkstraPathRouter, WorkspaceTest){
+    CDijkstraPathRouter PathRouter;
+    std::mt19937 Generator(42);
+    std::uniform_int_distribution<std::size_t> VertexDistribution(0, 199);
+    std::uniform_int_distribution<int> WeightDistribution(1, 100);
+    for(std::size_t Index = 0; Index < 200; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < 600; Index++){
+        PathRouter.AddEdge(VertexDistribution(Generator), VertexDistribution(Generator), WeightDistribution(Generator), Index % 3 == 0);
+    }
+    PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    std::vector< std::pair<std::size_t, std::size_t> > Queries;
+    std::vector< double > Expected;
+    for(std::size_t Index = 0; Index < 100; Index++){
+        std::vector<CPathRouter::TVertexID> Path;
+        Queries.push_back(std::make_pair(VertexDistribution(Generator), VertexDistribution(Generator)));
+        Expected.push_back(PathRouter.FindShortestPath(Queries.back().first, Queries.back().second, Path));
+    }
+    // One workspace per thread, each reused for all of its queries
+    const CDijkstraPathRouter &SharedRouter = PathRouter;
+    std::vector< std::size_t > Mismatches(4, 0);
+    std::vector< std::thread > Threads;
+    for(std::size_t ThreadIndex = 0; ThreadIndex < Mismatches.size(); ThreadIndex++){
+        Threads.emplace_back([&, ThreadIndex](){
+            auto Workspace = SharedRouter.CreateWorkspace();
+            std::vector<CPathRouter::TVertexID> Path;
+            for(std::size_t Round = 0; Round < 5; Round++){
+                for(std::size_t Index = 0; Index < Queries.size(); Index++){
+                    if(Expected[Index] != SharedRouter.FindShortestPath(Queries[Index].first, Queries[Index].second, Path, *Workspace)){
+                        Mismatches[ThreadIndex]++;
+                    }
+                }
+            }
+        });
+    }
+    for(auto &Thread : Threads){
+        Thread.join();
+    }
+    for(auto Count : Mismatches){
+        EXPECT_EQ(0, Count);
+    }
+    // A workspace keeps working after the graph grows
+    auto Workspace = PathRouter.CreateWorkspace();
+    std::vector<CPathRouter::TVertexID> Path;
+    PathRouter.FindShortestPath(0, 1, Path, *Workspace);
+    auto NewVertex = PathRouter.AddVertex(std::size_t(200));
+    PathRouter.AddEdge(0, NewVertex, 0.5);
+    std::vector<CPathRouter::TVertexID> ExpectedPath = {0, NewVertex};
+    EXPECT_EQ(0.5, PathRouter.FindShortestPath(0, NewVertex, Path, *Workspace));
+    EXPECT_EQ(ExpectedPath, Path);
+    // A workspace of another router ends the noexcept query instead of being replaced
+    auto OtherWorkspace = CDijkstraPathRouter(CDijkstraPathRouter::EQueueType::Rebuild).CreateWorkspace();
+    EXPECT_DEATH(PathRouter.FindShortestPath(0, 1, Path, *OtherWorkspace), "another router");
+}
+
+TEST(DijkstraPathRouter, MatrixTest){
+    CDijkstraPathRouter PathRouter;
+    std::vector<CPathRouter::TVertexID> Vertices;
+    for(std::size_t Index = 0; Index < 6; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    PathRouter.AddEdge(Vertices[0], Vertices[1], 4.0);
+    PathRouter.AddEdge(Vertices[0], Vertices[2], 1.0);
+    PathRouter.AddEdge(Vertices[2], Vertices[1], 2.0);
+    PathRouter.AddEdge(Vertices[1], Vertices[3], 5.0, true);
+    PathRouter.AddEdge(Vertices[4], Vertices[0], 1.0);
+    // Vertex 5 is unreachable and 99 does not exist
+    auto Workspace = PathRouter.CreateWorkspace();
+    std::vector<double> Expected = {0.0, 3.0, 1.0, 8.0, CPathRouter::NoPathExists, CPathRouter::NoPathExists, CPathRouter::NoPathExists, 3.0};
+    EXPECT_EQ(PathRouter.FindDistances(Vertices[0], {0, 1, 2, 3, 4, 5, 99, 1}, *Workspace), Expected);
+    auto Matrix = PathRouter.FindDistanceMatrix({Vertices[4], Vertices[3], 99}, {Vertices[1], Vertices[0]}, *Workspace);
+    ASSERT_EQ(Matrix.size(), 3);
+    EXPECT_EQ(Matrix[0], std::vector<double>({4.0, 1.0}));
+    EXPECT_EQ(Matrix[1], std::vector<double>({5.0, CPathRouter::NoPathExists}));
+    EXPECT_EQ(Matrix[2], std::vector<double>({CPathRouter::NoPathExists, CPathRouter::NoPathExists}));
+    // The search must give the same answers after freezing and for every queue type
+    PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    EXPECT_EQ(PathRouter.FindDistances(Vertices[0], {0, 1, 2, 3, 4, 5, 99, 1}, *Workspace), Expected);
+    for(auto QueueType : {CDijkstraPathRouter::EQueueType::Rebuild, CDijkstraPathRouter::EQueueType::BinaryHeap}){
+        CDijkstraPathRouter QueueRouter(QueueType);
+        for(std::size_t Index = 0; Index < 6; Index++){
+            QueueRouter.AddVertex(Index);
+        }
+        QueueRouter.AddEdge(0, 1, 4.0);
+        QueueRouter.AddEdge(0, 2, 1.0);
+        QueueRouter.AddEdge(2, 1, 2.0);
+        QueueRouter.AddEdge(1, 3, 5.0, true);
+        QueueRouter.AddEdge(4, 0, 1.0);
+        auto QueueWorkspace = QueueRouter.CreateWorkspace();
+        EXPECT_EQ(QueueRouter.FindDistances(0, {0, 1, 2, 3, 4, 5, 99, 1}, *QueueWorkspace), Expected);
+    }
+}
+
+TEST(DijkstraPathRouter, ReachableTest){
+    CDijkstraPathRouter PathRouter;
+    for(std::size_t Index = 0; Index < 6; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    PathRouter.AddEdge(0, 1, 4.0);
+    PathRouter.AddEdge(0, 2, 1.0);
+    PathRouter.AddEdge(2, 1, 2.0);
+    PathRouter.AddEdge(1, 3, 5.0, true);
+    PathRouter.AddEdge(4, 0, 1.0);
+    auto Workspace = PathRouter.CreateWorkspace();
+    using TReached = std::vector< std::pair<CPathRouter::TVertexID, double> >;
+    EXPECT_EQ(PathRouter.FindVerticesWithin(0, 0.0, *Workspace), TReached({{0, 0.0}}));
+    EXPECT_EQ(PathRouter.FindVerticesWithin(0, 3.0, *Workspace), TReached({{0, 0.0}, {2, 1.0}, {1, 3.0}}));
+    EXPECT_EQ(PathRouter.FindVerticesWithin(0, 100.0, *Workspace), TReached({{0, 0.0}, {2, 1.0}, {1, 3.0}, {3, 8.0}}));
+    EXPECT_TRUE(PathRouter.FindVerticesWithin(0, -1.0, *Workspace).empty());
+    EXPECT_TRUE(PathRouter.FindVerticesWithin(99, 100.0, *Workspace).empty());
+    PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    EXPECT_EQ(PathRouter.FindVerticesWithin(0, 3.0, *Workspace), TReached({{0, 0.0}, {2, 1.0}, {1, 3.0}}));
+}
+
+// Router implementing only the pure virtual methods of CPathRouter, as routers written before the
+// workspace and distance queries do
+class CBasicPathRouter : public CPathRouter{
+    private:
+        CDijkstraPathRouter DRouter;
+    public:
+        std::size_t DQueryCount = 0;
+
+        std::size_t VertexCount() const noexcept override{
+            return DRouter.VertexCount();
+        }
+        TVertexID AddVertex(std::any tag) noexcept override{
+            return DRouter.AddVertex(tag);
+        }
+        std::any GetVertexTag(TVertexID id) const noexcept override{
+            return DRouter.GetVertexTag(id);
+        }
+        bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept override{
+            return DRouter.AddEdge(src, dest, weight, bidir);
+        }
+        bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept override{
+            return DRouter.Precompute(deadline);
+        }
+        double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept override{
+            DQueryCount++;
+            return DRouter.FindShortestPath(src, dest, path);
+        }
+};
+
+TEST(DijkstraPathRouter, DefaultQueryTest){
+    CBasicPathRouter BasicRouter;
+    // Queried through the base class, as the derived FindShortestPath hides the other overload
+    CPathRouter &PathRouter = BasicRouter;
+    for(std::size_t Index = 0; Index < 6; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    PathRouter.AddEdge(0, 1, 4.0);
+    PathRouter.AddEdge(0, 2, 1.0);
+    PathRouter.AddEdge(2, 1, 2.0);
+    PathRouter.AddEdge(1, 3, 5.0, true);
+    PathRouter.AddEdge(4, 0, 1.0);
+    auto Workspace = PathRouter.CreateWorkspace();
+    ASSERT_NE(Workspace, nullptr);
+
+    std::vector<CPathRouter::TVertexID> Path;
+    EXPECT_EQ(PathRouter.FindShortestPath(0, 1, Path, *Workspace), 3.0);
+    EXPECT_EQ(Path, std::vector<CPathRouter::TVertexID>({0, 2, 1}));
+    std::vector<double> Expected = {0.0, 3.0, 1.0, 8.0, CPathRouter::NoPathExists, CPathRouter::NoPathExists, CPathRouter::NoPathExists};
+    EXPECT_EQ(PathRouter.FindDistances(0, {0, 1, 2, 3, 4, 5, 99}, *Workspace), Expected);
+    auto Matrix = PathRouter.FindDistanceMatrix({4, 3}, {1, 0}, *Workspace);
+    ASSERT_EQ(Matrix.size(), 2);
+    EXPECT_EQ(Matrix[0], std::vector<double>({4.0, 1.0}));
+    EXPECT_EQ(Matrix[1], std::vector<double>({5.0, CPathRouter::NoPathExists}));
+    using TReached = std::vector< std::pair<CPathRouter::TVertexID, double> >;
+    EXPECT_EQ(PathRouter.FindVerticesWithin(0, 3.0, *Workspace), TReached({{0, 0.0}, {2, 1.0}, {1, 3.0}}));
+    EXPECT_TRUE(PathRouter.FindVerticesWithin(99, 100.0, *Workspace).empty());
+    // Every default query went through the router's own FindShortestPath
+    EXPECT_EQ(BasicRouter.DQueryCount, 1 + 7 + 4 + 6);
+    EXPECT_FALSE(PathRouter.ConcurrentQueries());
+    EXPECT_TRUE(CDijkstraPathRouter().ConcurrentQueries());
+}
+
+TEST(DijkstraPathRouter, SharedGraphTest){
+    // Metric 0 has every edge, metric 1 leaves out the direct edge from 0 to 2
+    auto Graph = std::make_shared<CMultiMetricGraph>(2);
+    for(std::size_t Index = 0; Index < 3; Index++){
+        EXPECT_EQ(Index, Graph->AddVertex(Index));
+    }
+    EXPECT_TRUE(Graph->AddEdge(0, 1, {1.0, 2.0}));
+    EXPECT_TRUE(Graph->AddEdge(1, 2, {1.0, 2.0}, true));
+    EXPECT_TRUE(Graph->AddEdge(0, 2, {1.5, CPathRouter::NoPathExists}));
+    EXPECT_FALSE(Graph->AddEdge(0, 3, {1.0, 1.0}));
+    EXPECT_FALSE(Graph->AddEdge(0, 1, {1.0}));
+    EXPECT_FALSE(Graph->AddEdge(0, 1, {1.0, -1.0}));
+    EXPECT_EQ(Graph->EdgeCount(), 4);
+
+    // Only a frozen graph with the metric can be shared
+    CDijkstraPathRouter Distance, Time;
+    EXPECT_FALSE(Distance.ShareGraph(Graph, 0));
+    ASSERT_TRUE(Graph->Freeze());
+    EXPECT_FALSE(Distance.ShareGraph(Graph, 2));
+    EXPECT_TRUE(Distance.ShareGraph(Graph, 0));
+    EXPECT_TRUE(Time.ShareGraph(Graph, 1));
+    EXPECT_EQ(Distance.VertexCount(), 3);
+    EXPECT_EQ(std::any_cast<std::size_t>(Time.GetVertexTag(2)), 2);
+    std::vector<CPathRouter::TVertexID> Route;
+    EXPECT_EQ(Distance.FindShortestPath(0, 2, Route), 1.5);
+    EXPECT_EQ(Route, std::vector<CPathRouter::TVertexID>({0, 2}));
+    EXPECT_EQ(Time.FindShortestPath(0, 2, Route), 4.0);
+    EXPECT_EQ(Route, std::vector<CPathRouter::TVertexID>({0, 1, 2}));
+    EXPECT_EQ(Time.FindShortestPath(2, 1, Route), 2.0);
+    EXPECT_EQ(Time.FindShortestPath(2, 0, Route), CPathRouter::NoPathExists);
+    // A sharing router cannot change the graph
+    EXPECT_EQ(Time.AddVertex(std::size_t(3)), CPathRouter::InvalidVertexID);
+    EXPECT_FALSE(Time.AddEdge(2, 0, 1.0));
+
+    // Adding to the graph thaws it, and freezing it again keeps each vertex's edges in order
+    EXPECT_EQ(Graph->AddVertex(std::size_t(3)), 3);
+    EXPECT_FALSE(Graph->Frozen());
+    EXPECT_TRUE(Graph->AddEdge(2, 3, {1.0, 1.0}));
+    ASSERT_TRUE(Graph->Freeze());
+    EXPECT_EQ(Time.VertexCount(), 4);
+    EXPECT_EQ(Time.FindShortestPath(0, 3, Route), 5.0);
+    std::vector<CPathRouter::TVertexID> Targets;
+    Graph->ForEachEdge(2, 0, [&](CPathRouter::TVertexID target, double){
+        Targets.push_back(target);
+    });
+    EXPECT_EQ(Targets, std::vector<CPathRouter::TVertexID>({1, 3}));
+    auto Workspace = Distance.CreateWorkspace();
+    EXPECT_EQ(Distance.FindDistances(0, {1, 2, 3}, *Workspace), std::vector<double>({1.0, 1.5, 2.5}));
+
+    // The whole-graph walk gives the same edges of a metric before and after freezing
+    std::vector< std::tuple<CPathRouter::TVertexID, CPathRouter::TVertexID, double> > FrozenEdges, PendingEdges;
+    Graph->ForEachEdge(1, [&](CPathRouter::TVertexID source, CPathRouter::TVertexID target, double weight){
+        FrozenEdges.emplace_back(source, target, weight);
+    });
+    Graph->Thaw();
+    Graph->ForEachEdge(1, [&](CPathRouter::TVertexID source, CPathRouter::TVertexID target, double weight){
+        PendingEdges.emplace_back(source, target, weight);
+    });
+    EXPECT_EQ(FrozenEdges.size(), 4);
+    EXPECT_EQ(FrozenEdges, PendingEdges);
+}
@@ -2,7 +2,11 @@
 #include "FileDataFactory.h"
 #include "FileDataSink.h"
 #include "FileDataSource.h"
+#include "MMapDataSource.h"
+#include "StandardDataSource.h"
 #include <cstdio>
+#include <iostream>
+#include <sstream>
 
 // Assume being run from Makefile so testtmp is subdirectory
 
@@ -55,3 +59,141 @@ TEST(FileDataSourceSink, WriteTest){
     EXPECT_EQ(InBuffer,OutBuffer);
     EXPECT_TRUE(Source->End());
 }
+
+TEST(FileDataSourceSink, MMapEmptyTest){
+    CFileDataFactory DataFactory(BaseDirectory, CFileDataFactory::ESourceType::MemoryMapped);
+    std::string Filename = "mmapempty.txt";
+    std::remove((BaseDirectory + Filename).c_str());
+    auto Missing = DataFactory.CreateSource(Filename);
+    char TempCh;
+    EXPECT_TRUE(Missing->End());
+    EXPECT_FALSE(Missing->Get(TempCh));
+    {
+        auto Sink = DataFactory.CreateSink(Filename);
+    }
+    auto Source = DataFactory.CreateSource(Filename);
+    std::vector<char> InBuffer;
+    EXPECT_TRUE(Source->End());
+    EXPECT_FALSE(Source->Peek(TempCh));
+    EXPECT_FALSE(Source->Read(InBuffer,10));
+    EXPECT_TRUE(InBuffer.empty());
+}
+
+TEST(FileDataSourceSink, MMapReadTest){
+    CFileDataFactory DataFactory(BaseDirectory);
+    CFileDataFactory MappedFactory(BaseDirectory, CFileDataFactory::ESourceType::MemoryMapped);
+    std::string Filename = "mmapread.txt";
+    std::remove((BaseDirectory + Filename).c_str());
+    std::vector<char> OutBuffer, InBuffer;
+    for(char Ch = ' '; Ch < '~'; Ch++){
+        OutBuffer.push_back(Ch);
+    }
+    {
+        auto Sink = DataFactory.CreateSink(Filename);
+        EXPECT_TRUE(Sink->Write(OutBuffer));
+    }
+    auto Source = MappedFactory.CreateSource(Filename);
+    EXPECT_NE(std::dynamic_pointer_cast<CMMapDataSource>(Source),nullptr);
+    char TempCh;
+    EXPECT_TRUE(Source->Peek(TempCh));
+    EXPECT_EQ(TempCh,' ');
+    EXPECT_TRUE(Source->Get(TempCh));
+    EXPECT_EQ(TempCh,' ');
+    EXPECT_TRUE(Source->Read(InBuffer,10));
+    EXPECT_EQ(InBuffer,std::vector<char>(OutBuffer.begin() + 1, OutBuffer.begin() + 11));
+    EXPECT_TRUE(Source->Read(InBuffer,OutBuffer.size()));
+    EXPECT_EQ(InBuffer,std::vector<char>(OutBuffer.begin() + 11, OutBuffer.end()));
+    EXPECT_TRUE(Source->End());
+    EXPECT_FALSE(Source->Get(TempCh));
+}
+
+TEST(FileDataSourceSink, MMapChunkTest){
+    CFileDataFactory DataFactory(BaseDirectory);
+    std::string Filename = "mmapspan.txt";
+    std::remove((BaseDirectory + Filename).c_str());
+    std::vector<char> OutBuffer = {'a','b','c','d','e'};
+    {
+        auto Sink = DataFactory.CreateSink(Filename);
+        EXPECT_TRUE(Sink->Write(OutBuffer));
+    }
+    CMMapDataSource Source(BaseDirectory + Filename);
+    auto Chunk = Source.Chunk();
+    ASSERT_EQ(Chunk.second,5);
+    EXPECT_EQ(std::string(Chunk.first,Chunk.second),"abcde");
+    Source.Advance(2);
+    char TempCh;
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh,'c');
+    Chunk = Source.Chunk();
+    EXPECT_EQ(std::string(Chunk.first,Chunk.second),"de");
+    Source.Advance(10);
+    EXPECT_TRUE(Source.End());
+    EXPECT_EQ(Source.Chunk().second,0);
+}
+
+TEST(FileDataSourceSink, ChunkTest){
+    CFileDataFactory DataFactory(BaseDirectory);
+    std::string Filename = "chunk.txt";
+    std::remove((BaseDirectory + Filename).c_str());
+    // Longer than the blocks the source reads, so the chunks end inside the data
+    std::string OutString;
+    for(int Index = 0; Index < 20000; Index++){
+        OutString += std::to_string(Index) + "\n";
+    }
+    {
+        auto Sink = DataFactory.CreateSink(Filename);
+        EXPECT_TRUE(Sink->Write(std::vector<char>(OutString.begin(), OutString.end())));
+    }
+    auto Source = DataFactory.CreateSource(Filename);
+    char TempCh;
+    EXPECT_TRUE(Source->Get(TempCh));
+    EXPECT_EQ(TempCh,'0');
+    std::string InString(1,TempCh);
+    std::size_t ChunkCount = 0;
+    while(!Source->End()){
+        auto Chunk = Source->Chunk();
+        ASSERT_LT(0,Chunk.second);
+        InString.append(Chunk.first,Chunk.second);
+        Source->Advance(Chunk.second);
+        ChunkCount++;
+    }
+    EXPECT_LT(1,ChunkCount);
+    EXPECT_EQ(InString,OutString);
+    EXPECT_EQ(Source->Chunk().second,0);
+    EXPECT_FALSE(Source->Get(TempCh));
+
+    std::vector<char> InBuffer;
+    Source = DataFactory.CreateSource(Filename);
+    EXPECT_TRUE(Source->Read(InBuffer,OutString.size() + 1));
+    EXPECT_EQ(std::string(InBuffer.begin(),InBuffer.end()),OutString);
+    EXPECT_TRUE(Source->End());
+}
+
+TEST(FileDataSourceSink, StandardChunkTest){
+    // std::cin reads from a string for the test, each chunk is at most one line
+    std::istringstream Input("abc\ndef\ngh");
+    auto OriginalBuffer = std::cin.rdbuf(Input.rdbuf());
+    std::cin.clear();
+    CStandardDataSource Source;
+    auto Chunk = Source.Chunk();
+    EXPECT_EQ(std::string(Chunk.first, Chunk.second), "abc\n");
+    Source.Advance(1);
+    Chunk = Source.Chunk();
+    EXPECT_EQ(std::string(Chunk.first, Chunk.second), "bc\n");
+    char TempCh;
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh, 'b');
+    Source.Advance(2);
+    Chunk = Source.Chunk();
+    EXPECT_EQ(std::string(Chunk.first, Chunk.second), "def\n");
+    Source.Advance(Chunk.second);
+    Chunk = Source.Chunk();
+    EXPECT_EQ(std::string(Chunk.first, Chunk.second), "gh");
+    EXPECT_FALSE(Source.End());
+    Source.Advance(Chunk.second);
+    EXPECT_TRUE(Source.End());
+    EXPECT_EQ(Source.Chunk().second, 0);
+    EXPECT_FALSE(Source.Get(TempCh));
+    std::cin.rdbuf(OriginalBuffer);
+    std::cin.clear();
+}
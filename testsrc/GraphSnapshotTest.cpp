@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "GraphSnapshot.h"
+#include <cstdio>
+#include <fstream>
+
+// Assume being run from Makefile so testtmp is subdirectory
+const std::string BaseDirectory = "./testtmp/";
+
+TEST(GraphSnapshot, RoundTripTest){
+    std::string Path = BaseDirectory + "roundtrip.snapshot";
+    std::remove(Path.c_str());
+    std::vector< uint64_t > IDs = {5, 1, 9};
+    std::vector< double > Weights = {0.5, 1.25};
+    std::vector< uint32_t > Offsets = {0, 1, 3};
+    CGraphSnapshot::CWriter Writer;
+    Writer.Add(1, IDs);
+    Writer.Add(2, Weights);
+    Writer.Add(7, Offsets);
+    Writer.Add(8, std::vector< char >());
+    ASSERT_TRUE(Writer.Write(Path, 42));
+
+    auto Snapshot = CGraphSnapshot::Open(Path, 42);
+    ASSERT_NE(Snapshot, nullptr);
+    EXPECT_EQ(Snapshot->SourceKey(), 42);
+    EXPECT_EQ(Snapshot->SectionCount(), 4);
+    EXPECT_TRUE(Snapshot->HasSection(7));
+    EXPECT_FALSE(Snapshot->HasSection(3));
+    std::vector< uint64_t > ReadIDs;
+    std::vector< double > ReadWeights;
+    std::vector< char > ReadEmpty = {'x'};
+    EXPECT_TRUE(Snapshot->Read(1, ReadIDs));
+    EXPECT_EQ(ReadIDs, IDs);
+    EXPECT_TRUE(Snapshot->Read(2, ReadWeights));
+    EXPECT_EQ(ReadWeights, Weights);
+    EXPECT_TRUE(Snapshot->Read(8, ReadEmpty));
+    EXPECT_TRUE(ReadEmpty.empty());
+    // Sections are viewed in place and aligned for their values
+    auto View = Snapshot->View< uint32_t >(7);
+    ASSERT_NE(View.first, nullptr);
+    EXPECT_EQ(View.second, 3);
+    EXPECT_EQ(reinterpret_cast< uintptr_t >(View.first) % alignof(uint32_t), 0);
+    EXPECT_EQ(std::vector< uint32_t >(View.first, View.first + View.second), Offsets);
+    // Missing sections and values of another size are not read
+    EXPECT_FALSE(Snapshot->Read(3, ReadIDs));
+    EXPECT_FALSE(Snapshot->Read(7, ReadIDs));
+    EXPECT_EQ(Snapshot->View< uint64_t >(7).first, nullptr);
+    std::remove(Path.c_str());
+}
+
+TEST(GraphSnapshot, StaleTest){
+    std::string Path = BaseDirectory + "stale.snapshot";
+    std::remove(Path.c_str());
+    EXPECT_EQ(CGraphSnapshot::Open(Path, 1), nullptr);
+    CGraphSnapshot::CWriter Writer;
+    Writer.Add(1, std::vector< double >(100, 2.5));
+    ASSERT_TRUE(Writer.Write(Path, 1));
+    EXPECT_NE(CGraphSnapshot::Open(Path, 1), nullptr);
+    // Built from other sources
+    EXPECT_EQ(CGraphSnapshot::Open(Path, 2), nullptr);
+
+    std::vector< char > Contents;
+    {
+        std::ifstream File(Path, std::ios::binary);
+        Contents.assign(std::istreambuf_iterator< char >(File), std::istreambuf_iterator< char >());
+    }
+    auto WriteContents = [&](const std::vector< char > &contents){
+        std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+        File.write(contents.data(), contents.size());
+    };
+    // A changed byte fails the checksum
+    auto Damaged = Contents;
+    Damaged[Damaged.size() - 3] ^= 0x10;
+    WriteContents(Damaged);
+    EXPECT_EQ(CGraphSnapshot::Open(Path, 1), nullptr);
+    // Truncated
+    WriteContents(std::vector< char >(Contents.begin(), Contents.end() - 8));
+    EXPECT_EQ(CGraphSnapshot::Open(Path, 1), nullptr);
+    WriteContents(std::vector< char >(Contents.begin(), Contents.begin() + 10));
+    EXPECT_EQ(CGraphSnapshot::Open(Path, 1), nullptr);
+    // Another format version, which follows the 8 byte magic
+    auto Versioned = Contents;
+    Versioned[8] ^= 0x01;
+    WriteContents(Versioned);
+    EXPECT_EQ(CGraphSnapshot::Open(Path, 1), nullptr);
+    WriteContents(Contents);
+    EXPECT_NE(CGraphSnapshot::Open(Path, 1), nullptr);
+    std::remove(Path.c_str());
+}
+
+TEST(GraphSnapshot, FileKeyTest){
+    std::string Path = BaseDirectory + "source.txt";
+    {
+        std::ofstream File(Path, std::ios::trunc);
+        File<<"abc";
+    }
+    auto Key = CGraphSnapshot::FileKey({Path});
+    EXPECT_EQ(CGraphSnapshot::FileKey({Path}), Key);
+    {
+        std::ofstream File(Path, std::ios::app);
+        File<<"d";
+    }
+    EXPECT_NE(CGraphSnapshot::FileKey({Path}), Key);
+    std::remove(Path.c_str());
+    EXPECT_NE(CGraphSnapshot::FileKey({Path}), Key);
+}
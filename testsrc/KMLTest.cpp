@@ -132,4 +132,50 @@ TEST(KMLWriterTest, PathTest){
                                     "    </Placemark>\n"
                                     "  </Document>\n"
                                     "</kml>");
-}
\ No newline at end of file
+}
+TEST(KMLWriterTest, PolygonTest){
+    auto OutStream = std::make_shared<CStringDataSink>();
+    {
+        CKMLWriter KMLWriter(OutStream,"Polygon","Polygon KML test");
+        EXPECT_TRUE(KMLWriter.CreatePolygonStyle("PolygonStyleID",0xff123456,0x7f654321,2));
+        EXPECT_FALSE(KMLWriter.CreatePolygonStyle("PolygonStyleID",0xff123456,0x7f654321,2));
+        EXPECT_FALSE(KMLWriter.CreatePolygon("Empty","PolygonStyleID",{}));
+        EXPECT_FALSE(KMLWriter.CreatePolygon("NoStyle","MissingStyleID",{{38.5,-121.7},{38.6,-121.8},{38.7,-121.7}}));
+        EXPECT_TRUE(KMLWriter.CreatePolygon("PolygonName","PolygonStyleID",{{38.5,-121.7},{38.6,-121.8},{38.7,-121.7}}));
+    }
+    
+    EXPECT_EQ(OutStream->String(),  "<?xml version='1.0' encoding='UTF-8'?>\n"
+                                    "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n"
+                                    "  <Document>\n"
+                                    "    <name>Polygon</name>\n"
+                                    "    <description>Polygon KML test</description>\n"
+                                    "    <Style id=\"PolygonStyleID\">\n"
+                                    "      <LineStyle>\n"
+                                    "        <color>ff123456</color>\n"
+                                    "        <width>2</width>\n"
+                                    "      </LineStyle>\n"
+                                    "      <PolyStyle>\n"
+                                    "        <color>7f654321</color>\n"
+                                    "      </PolyStyle>\n"
+                                    "    </Style>\n"
+                                    "    <Placemark>\n"
+                                    "      <name>PolygonName</name>\n"
+                                    "      <styleUrl>#PolygonStyleID</styleUrl>\n"
+                                    "      <Polygon>\n"
+                                    "        <tessellate>1</tessellate>\n"
+                                    "        <altitudeMode>relativeToGround</altitudeMode>\n"
+                                    "        <outerBoundaryIs>\n"
+                                    "          <LinearRing>\n"
+                                    "            <coordinates>\n"
+                                    "              -121.700000,38.500000\n"
+                                    "              -121.800000,38.600000\n"
+                                    "              -121.700000,38.700000\n"
+                                    "              -121.700000,38.500000\n"
+                                    "            </coordinates>\n"
+                                    "          </LinearRing>\n"
+                                    "        </outerBoundaryIs>\n"
+                                    "      </Polygon>\n"
+                                    "    </Placemark>\n"
+                                    "  </Document>\n"
+                                    "</kml>");
+}
@@ -3,6 +3,7 @@
 #include "StreetMap.h"
 #include "StringDataSource.h"
 #include "XMLReader.h"
+#include "ThreadPool.h"
 TEST(OpenStreetMap, SimpleExampleTest){
     auto InStream = std::make_shared<CStringDataSource>("<?xml version='1.0' encoding='UTF-8'?>"
                                                         "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
@@ -152,4 +153,182 @@ TEST(OpenStreetMap, WayWithNoNodesTest) {
     EXPECT_EQ(StreetMap.WayCount(), 1);
     auto way = StreetMap.WayByIndex(0);
     EXPECT_EQ(way->NodeCount(), 0);
-}
\ No newline at end of file
+}
+TEST(OpenStreetMap, SourceIngestTest) {
+    const std::string OSM = "<?xml version='1.0' encoding='UTF-8'?>"
+        "<osm version=\"0.6\">"
+        "<node id=\"1\" lat=\"38.5178523\" lon=\"-121.7712408\">"
+        "<tag k=\"name\" v=\"Fish &amp; Chips\"/>"
+        "<tag k=\"amenity\" v=\"restaurant\"/>"
+        "</node>"
+        "<node id=\"2\" version=\"3\" lon=\"-121.7408606\" lat=\"38.535052\"/>"
+        "<node id=\"3\" lat=\"1.5e1\" lon=\"bad\"/>"
+        "<way id=\"10\">"
+        "<nd ref=\"1\"/>"
+        "<nd ref=\"2\"/>"
+        "<tag k=\"highway\" v=\"residential\"/>"
+        "</way>"
+        "<nd ref=\"3\"/>"
+        "<tag k=\"stray\" v=\"tag\"/>"
+        "</osm>"
+        "<node id=\"4\" lat=\"0.0\" lon=\"0.0\"/>";
+    COpenStreetMap ReaderMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(OSM)));
+    COpenStreetMap SourceMap(std::make_shared<CStringDataSource>(OSM));
+
+    // Both paths build the same map
+    ASSERT_EQ(SourceMap.NodeCount(), 3);
+    ASSERT_EQ(SourceMap.NodeCount(), ReaderMap.NodeCount());
+    ASSERT_EQ(SourceMap.WayCount(), ReaderMap.WayCount());
+    for(std::size_t Index = 0; Index < SourceMap.NodeCount(); Index++){
+        auto SourceNode = SourceMap.NodeByIndex(Index);
+        auto ReaderNode = ReaderMap.NodeByIndex(Index);
+        EXPECT_EQ(SourceNode->ID(), ReaderNode->ID());
+        EXPECT_EQ(SourceNode->Location(), ReaderNode->Location());
+        ASSERT_EQ(SourceNode->AttributeCount(), ReaderNode->AttributeCount());
+        for(std::size_t Key = 0; Key < SourceNode->AttributeCount(); Key++){
+            EXPECT_EQ(SourceNode->GetAttributeKey(Key), ReaderNode->GetAttributeKey(Key));
+            EXPECT_EQ(SourceNode->GetAttribute(SourceNode->GetAttributeKey(Key)), ReaderNode->GetAttribute(ReaderNode->GetAttributeKey(Key)));
+        }
+    }
+    EXPECT_EQ(SourceMap.NodeByID(1)->GetAttribute("name"), "Fish & Chips");
+    EXPECT_EQ(SourceMap.NodeByID(2)->Location(), std::make_pair(38.535052, -121.7408606));
+    EXPECT_EQ(SourceMap.NodeByID(3)->Location(), std::make_pair(15.0, 0.0));
+    EXPECT_EQ(SourceMap.NodeByID(4), nullptr);
+
+    auto Way = SourceMap.WayByID(10);
+    ASSERT_NE(Way, nullptr);
+    ASSERT_EQ(Way->NodeCount(), 2);
+    EXPECT_EQ(Way->GetNodeID(0), 1);
+    EXPECT_EQ(Way->GetNodeID(1), 2);
+    EXPECT_EQ(Way->GetAttribute("highway"), "residential");
+    EXPECT_EQ(Way->AttributeCount(), ReaderMap.WayByID(10)->AttributeCount());
+
+    // Both report the bytes they parsed in one chunk
+    EXPECT_EQ(SourceMap.ParseStatistics().DBytesParsed, OSM.size());
+    EXPECT_EQ(SourceMap.ParseStatistics().DChunkCount, 1);
+    EXPECT_EQ(ReaderMap.ParseStatistics().DBytesParsed, OSM.size());
+}
+TEST(OpenStreetMap, SourceIngestErrorTest) {
+    // Elements before a parse error are kept
+    COpenStreetMap StreetMap(std::make_shared<CStringDataSource>(
+        "<?xml version='1.0' encoding='UTF-8'?>"
+        "<osm><node id=\"1\" lat=\"1.0\" lon=\"-1.0\"/><way id=\"10\"><nd ref=\"1\"/></way><node id=\"2\"</osm>"));
+
+    EXPECT_EQ(StreetMap.NodeCount(), 1);
+    EXPECT_EQ(StreetMap.WayCount(), 1);
+    EXPECT_EQ(StreetMap.WayByIndex(0)->GetNodeID(0), 1);
+}
+// Expects the maps to have the same nodes and ways in the same order
+static void ExpectSameMap(const CStreetMap &expected, const CStreetMap &actual){
+    ASSERT_EQ(actual.NodeCount(), expected.NodeCount());
+    ASSERT_EQ(actual.WayCount(), expected.WayCount());
+    for(std::size_t Index = 0; Index < expected.NodeCount(); Index++){
+        auto ExpectedNode = expected.NodeByIndex(Index);
+        auto ActualNode = actual.NodeByIndex(Index);
+        EXPECT_EQ(ActualNode->ID(), ExpectedNode->ID());
+        EXPECT_EQ(ActualNode->Location(), ExpectedNode->Location());
+        ASSERT_EQ(ActualNode->AttributeCount(), ExpectedNode->AttributeCount());
+        for(std::size_t Key = 0; Key < ExpectedNode->AttributeCount(); Key++){
+            EXPECT_EQ(ActualNode->GetAttributeKey(Key), ExpectedNode->GetAttributeKey(Key));
+            EXPECT_EQ(ActualNode->GetAttribute(ActualNode->GetAttributeKey(Key)), ExpectedNode->GetAttribute(ExpectedNode->GetAttributeKey(Key)));
+        }
+        EXPECT_EQ(actual.NodeByID(ExpectedNode->ID())->Location(), expected.NodeByID(ExpectedNode->ID())->Location());
+    }
+    for(std::size_t Index = 0; Index < expected.WayCount(); Index++){
+        auto ExpectedWay = expected.WayByIndex(Index);
+        auto ActualWay = actual.WayByIndex(Index);
+        EXPECT_EQ(ActualWay->ID(), ExpectedWay->ID());
+        ASSERT_EQ(ActualWay->NodeCount(), ExpectedWay->NodeCount());
+        for(std::size_t Node = 0; Node < ExpectedWay->NodeCount(); Node++){
+            EXPECT_EQ(ActualWay->GetNodeID(Node), ExpectedWay->GetNodeID(Node));
+        }
+        EXPECT_EQ(ActualWay->AttributeCount(), ExpectedWay->AttributeCount());
+        EXPECT_EQ(ActualWay->GetAttribute("highway"), ExpectedWay->GetAttribute("highway"));
+        EXPECT_EQ(actual.WayByID(ExpectedWay->ID())->NodeCount(), expected.WayByID(ExpectedWay->ID())->NodeCount());
+    }
+}
+
+// String source that gives a few bytes at a time in chunks that do not stay valid
+class CPieceDataSource : public CStringDataSource{
+    public:
+        CPieceDataSource(const std::string &str) : CStringDataSource(str){}
+
+        std::pair< const char *, std::size_t > Chunk() noexcept override{
+            auto Piece = CStringDataSource::Chunk();
+            Piece.second = std::min(Piece.second, std::size_t(7));
+            return Piece;
+        }
+
+        bool StableChunks() const noexcept override{
+            return false;
+        }
+};
+
+TEST(OpenStreetMap, ParallelIngestTest) {
+    std::string OSM = "<?xml version='1.0' encoding='UTF-8'?>\n<osm version=\"0.6\">\n";
+    for(int Index = 0; Index < 2000; Index++){
+        // Every tenth ID repeats an earlier one, the later element is the one found by ID
+        auto ID = std::to_string(Index % 10 == 9 ? Index / 2 : Index);
+        OSM += "\t<node id=\"" + ID + "\" lat=\"" + std::to_string(38.5 + Index * 0.0001) + "\" lon=\"-121.7\">\n";
+        OSM += "\t\t<tag k=\"name\" v=\"Node " + std::to_string(Index) + "\"/>\n\t</node>\n";
+    }
+    for(int Index = 0; Index < 500; Index++){
+        OSM += "\t<way id=\"" + std::to_string(Index % 7 == 6 ? Index / 2 : Index) + "\">\n";
+        for(int Node = 0; Node < Index % 5; Node++){
+            OSM += "\t\t<nd ref=\"" + std::to_string(Index + Node) + "\"/>\n";
+        }
+        OSM += "\t\t<tag k=\"highway\" v=\"road " + std::to_string(Index) + "\"/>\n\t</way>\n";
+    }
+    OSM += "</osm>\n";
+    COpenStreetMap SequentialMap(std::make_shared<CStringDataSource>(OSM));
+    CThreadPool Pool(4);
+
+    for(std::size_t SplitSize : {std::size_t(1), std::size_t(1000), std::size_t(65536), std::size_t(0)}){
+        COpenStreetMap ParallelMap(std::make_shared<CStringDataSource>(OSM), Pool, SplitSize);
+        ExpectSameMap(SequentialMap, ParallelMap);
+    }
+    // A source that gives the input in pieces is copied together first
+    COpenStreetMap PieceMap(std::make_shared<CPieceDataSource>(OSM), Pool, 1000, 1);
+    ExpectSameMap(SequentialMap, PieceMap);
+    EXPECT_EQ(PieceMap.ParseStatistics().DBytesParsed, OSM.size());
+    EXPECT_GT(PieceMap.ParseStatistics().DChunkCount, 1);
+    EXPECT_EQ(SequentialMap.NodeCount(), 2000);
+    EXPECT_EQ(SequentialMap.WayCount(), 500);
+}
+
+TEST(OpenStreetMap, ParallelIngestEndTest) {
+    CThreadPool Pool(2);
+    // Elements after the end of the map or after a parse error are left out in every chunk
+    for(std::string OSM : {std::string("<osm><node id=\"1\" lat=\"1.0\" lon=\"-1.0\"/><way id=\"10\"><nd ref=\"1\"/></way></osm><node id=\"2\" lat=\"0\" lon=\"0\"/><way id=\"11\"></way>"),
+                           std::string("<osm><node id=\"1\" lat=\"1.0\" lon=\"-1.0\"/><way id=\"10\"><nd ref=\"1\"/></way><node id=\"2\"<way id=\"11\"></way></osm>")}){
+        COpenStreetMap SequentialMap(std::make_shared<CStringDataSource>(OSM));
+        COpenStreetMap ParallelMap(std::make_shared<CStringDataSource>(OSM), Pool, 1);
+        ExpectSameMap(SequentialMap, ParallelMap);
+    }
+    COpenStreetMap EmptyMap(std::make_shared<CStringDataSource>(""), Pool);
+    EXPECT_EQ(EmptyMap.NodeCount(), 0);
+    EXPECT_EQ(EmptyMap.WayCount(), 0);
+}
+
+TEST(OpenStreetMap, ParallelIngestMarkupTest) {
+    CThreadPool Pool(2);
+    // Tags inside comments, CDATA sections and processing instructions are not split at, and the
+    // chunks are wrapped in the document's own root
+    for(std::string OSM : {std::string("<?xml version='1.0'?><!-- <node id=\"9\" lat=\"0\" lon=\"0\"/> --><osm><node id=\"1\" lat=\"1.0\" lon=\"-1.0\"/>"
+                                       "<!-- <node id=\"8\"> <way id=\"12\"> --><way id=\"10\"><nd ref=\"1\"/></way>"
+                                       "<![CDATA[<node id=\"7\"/>]]><?note <way id=\"13\"?><node id=\"2\" lat=\"2.0\" lon=\"-2.0\"/></osm>"),
+                           std::string("<map><node id=\"1\" lat=\"1.0\" lon=\"-1.0\"/><way id=\"10\"><nd ref=\"1\"/></way><node id=\"2\" lat=\"2.0\" lon=\"-2.0\"/></map>")}){
+        COpenStreetMap SequentialMap(std::make_shared<CStringDataSource>(OSM));
+        COpenStreetMap ParallelMap(std::make_shared<CStringDataSource>(OSM), Pool, 1);
+        ExpectSameMap(SequentialMap, ParallelMap);
+        EXPECT_EQ(ParallelMap.NodeCount(), 2);
+        EXPECT_EQ(ParallelMap.WayCount(), 1);
+        EXPECT_EQ(ParallelMap.ParseStatistics().DChunkCount, 4);
+    }
+    // A way inside a node is split out of it, which fails to parse, so the input is parsed in one pass
+    std::string OSM = "<osm><node id=\"1\" lat=\"1.0\" lon=\"-1.0\"><way id=\"10\"><nd ref=\"1\"/></way></node><node id=\"2\" lat=\"0\" lon=\"0\"/></osm>";
+    COpenStreetMap SequentialMap(std::make_shared<CStringDataSource>(OSM));
+    COpenStreetMap ParallelMap(std::make_shared<CStringDataSource>(OSM), Pool, 1);
+    ExpectSameMap(SequentialMap, ParallelMap);
+    EXPECT_EQ(ParallelMap.ParseStatistics().DBytesParsed, 2 * OSM.size());
+}
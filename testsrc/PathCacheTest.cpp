@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "PathCache.h"
+#include <thread>
+#include <vector>
+
+using EMetric = CPathCache::EMetric;
+
+TEST(PathCache, FindInsertTest){
+    CPathCache Cache(4, 1);
+    EXPECT_EQ(Cache.Capacity(), 4);
+    EXPECT_EQ(Cache.ShardCount(), 1);
+    CPathCache::SEntry Entry;
+    EXPECT_FALSE(Cache.Find({1, 2, EMetric::Distance}, Entry));
+    Cache.Insert({1, 2, EMetric::Distance}, {3.5, {1, 5, 2}, {}});
+    Cache.Insert({1, 2, EMetric::Time}, {0.25, {}, {{CTransportationPlanner::ETransportationMode::Walk, 1}, {CTransportationPlanner::ETransportationMode::Bus, 2}}});
+    EXPECT_EQ(Cache.Size(), 2);
+    ASSERT_TRUE(Cache.Find({1, 2, EMetric::Distance}, Entry));
+    EXPECT_EQ(Entry.DCost, 3.5);
+    EXPECT_EQ(Entry.DNodes, std::vector< CPathCache::TNodeID >({1, 5, 2}));
+    // The metric and the direction are part of the key
+    ASSERT_TRUE(Cache.Find({1, 2, EMetric::Time}, Entry));
+    EXPECT_EQ(Entry.DCost, 0.25);
+    EXPECT_EQ(Entry.DSteps.size(), 2);
+    EXPECT_FALSE(Cache.Find({2, 1, EMetric::Distance}, Entry));
+    EXPECT_EQ(Cache.Hits(), 2);
+    EXPECT_EQ(Cache.Misses(), 2);
+    // Inserting an existing key replaces its entry
+    Cache.Insert({1, 2, EMetric::Distance}, {4.0, {1, 2}, {}});
+    EXPECT_EQ(Cache.Size(), 2);
+    ASSERT_TRUE(Cache.Find({1, 2, EMetric::Distance}, Entry));
+    EXPECT_EQ(Entry.DCost, 4.0);
+    Cache.ResetCounters();
+    EXPECT_EQ(Cache.Hits(), 0);
+    EXPECT_EQ(Cache.Misses(), 0);
+    Cache.Clear();
+    EXPECT_EQ(Cache.Size(), 0);
+    EXPECT_FALSE(Cache.Find({1, 2, EMetric::Distance}, Entry));
+}
+
+TEST(PathCache, EvictionTest){
+    // The least recently used entry goes first, finding an entry counts as using it
+    CPathCache Cache(3, 1);
+    CPathCache::SEntry Entry;
+    Cache.Insert({1, 2, EMetric::Distance}, {1.0, {}, {}});
+    Cache.Insert({1, 3, EMetric::Distance}, {2.0, {}, {}});
+    Cache.Insert({1, 4, EMetric::Distance}, {3.0, {}, {}});
+    EXPECT_TRUE(Cache.Find({1, 2, EMetric::Distance}, Entry));
+    Cache.Insert({1, 5, EMetric::Distance}, {4.0, {}, {}});
+    EXPECT_EQ(Cache.Size(), 3);
+    EXPECT_FALSE(Cache.Find({1, 3, EMetric::Distance}, Entry));
+    EXPECT_TRUE(Cache.Find({1, 2, EMetric::Distance}, Entry));
+    EXPECT_TRUE(Cache.Find({1, 4, EMetric::Distance}, Entry));
+    EXPECT_TRUE(Cache.Find({1, 5, EMetric::Distance}, Entry));
+}
+
+TEST(PathCache, CapacityTest){
+    // The capacity is split evenly over the shards and rounded up
+    CPathCache Cache(10, 4);
+    EXPECT_EQ(Cache.ShardCount(), 4);
+    EXPECT_EQ(Cache.Capacity(), 12);
+    for(CPathCache::TNodeID Index = 0; Index < 100; Index++){
+        Cache.Insert({Index, Index + 1, EMetric::Time}, {double(Index), {}, {}});
+    }
+    EXPECT_LE(Cache.Size(), 12);
+    // Fewer entries than shards
+    CPathCache SmallCache(2, 16);
+    EXPECT_EQ(SmallCache.ShardCount(), 2);
+    EXPECT_EQ(SmallCache.Capacity(), 2);
+    // A cache without capacity stores nothing
+    CPathCache EmptyCache(0);
+    CPathCache::SEntry Entry;
+    EmptyCache.Insert({1, 2, EMetric::Distance}, {1.0, {}, {}});
+    EXPECT_EQ(EmptyCache.Size(), 0);
+    EXPECT_FALSE(EmptyCache.Find({1, 2, EMetric::Distance}, Entry));
+}
+
+TEST(PathCache, ConcurrentTest){
+    // Every thread looks up the same keys, each key is inserted once per thread on a miss
+    CPathCache Cache(1024);
+    const std::size_t ThreadCount = 4, KeyCount = 32, Repeats = 100;
+    std::vector< std::thread > Threads;
+    for(std::size_t Index = 0; Index < ThreadCount; Index++){
+        Threads.emplace_back([&](){
+            CPathCache::SEntry Entry;
+            for(std::size_t Repeat = 0; Repeat < Repeats; Repeat++){
+                for(CPathCache::TNodeID Key = 0; Key < KeyCount; Key++){
+                    if(Cache.Find({Key, Key, EMetric::Distance}, Entry)){
+                        EXPECT_EQ(Entry.DCost, double(Key));
+                        EXPECT_EQ(Entry.DNodes.size(), Key);
+                    }
+                    else{
+                        Cache.Insert({Key, Key, EMetric::Distance}, {double(Key), std::vector< CPathCache::TNodeID >(Key, Key), {}});
+                    }
+                }
+            }
+        });
+    }
+    for(auto &Thread : Threads){
+        Thread.join();
+    }
+    EXPECT_EQ(Cache.Hits() + Cache.Misses(), ThreadCount * KeyCount * Repeats);
+    EXPECT_LE(Cache.Misses(), ThreadCount * KeyCount);
+    EXPECT_EQ(Cache.Size(), KeyCount);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "RaptorRouter.h"
+#include <stdexcept>
+
+using ELegType = CRaptorRouter::ELegType;
+
+TEST(RaptorRouter, SimpleTest){
+    // Route 0 rides 0, 1, 2 and route 1 rides 3, 2. Boarding and alighting take one each.
+    std::vector< CRaptorRouter::SRoute > Routes = {{{0, 1, 2}, {10.0, 10.0}}, {{3, 2}, {4.0}}};
+    CRaptorRouter Router(4, Routes, {}, 1.0, 1.0);
+    EXPECT_EQ(Router.StopCount(), 4);
+    EXPECT_EQ(Router.RouteCount(), 2);
+    EXPECT_EQ(Router.TransferCount(), 0);
+    EXPECT_EQ(Router.RouteStop(0, 2), 2);
+    EXPECT_EQ(Router.RouteStop(1, 0), 3);
+    EXPECT_EQ(Router.RouteStop(1, 2), CRaptorRouter::InvalidIndex);
+    EXPECT_EQ(Router.RouteStop(2, 0), CRaptorRouter::InvalidIndex);
+
+    auto Workspace = Router.CreateWorkspace();
+    std::vector< CRaptorRouter::SLeg > Legs;
+    EXPECT_EQ(Router.FindFastestJourney({{0, 0.0}}, {{2, 0.0}}, 4, Legs, *Workspace), 22.0);
+    ASSERT_EQ(Legs.size(), 3);
+    EXPECT_EQ(Legs[0].DType, ELegType::Access);
+    EXPECT_EQ(Legs[0].DDestination, 0);
+    EXPECT_EQ(Legs[1].DType, ELegType::Ride);
+    EXPECT_EQ(Legs[1].DRoute, 0);
+    EXPECT_EQ(Legs[1].DBoardIndex, 0);
+    EXPECT_EQ(Legs[1].DAlightIndex, 2);
+    EXPECT_EQ(Legs[2].DType, ELegType::Egress);
+    EXPECT_EQ(Legs[2].DSource, 2);
+    // The access and egress times are added, and the faster origin stop is chosen
+    EXPECT_EQ(Router.FindFastestJourney({{0, 3.0}, {3, 20.0}}, {{2, 5.0}}, 4, Legs, *Workspace), 30.0);
+    EXPECT_EQ(Router.FindFastestJourney({{0, 3.0}, {3, 10.0}}, {{2, 5.0}}, 4, Legs, *Workspace), 21.0);
+    ASSERT_EQ(Legs.size(), 3);
+    EXPECT_EQ(Legs[1].DRoute, 1);
+    // Routes only run forward, and a journey needs a ride
+    EXPECT_EQ(Router.FindFastestJourney({{2, 0.0}}, {{0, 0.0}}, 4, Legs, *Workspace), CRaptorRouter::NoPathExists);
+    EXPECT_TRUE(Legs.empty());
+    EXPECT_EQ(Router.FindFastestJourney({{2, 0.0}}, {{2, 0.0}}, 4, Legs, *Workspace), CRaptorRouter::NoPathExists);
+}
+
+TEST(RaptorRouter, BoardLaterTest){
+    // Reaching stop 1 on foot and boarding there beats riding from stop 0
+    std::vector< CRaptorRouter::SRoute > Routes = {{{0, 1, 2}, {100.0, 1.0}}};
+    CRaptorRouter Router(3, Routes, {}, 1.0, 1.0);
+    auto Workspace = Router.CreateWorkspace();
+    std::vector< CRaptorRouter::SLeg > Legs;
+    EXPECT_EQ(Router.FindFastestJourney({{0, 0.0}, {1, 5.0}}, {{2, 0.0}}, 1, Legs, *Workspace), 8.0);
+    ASSERT_EQ(Legs.size(), 3);
+    EXPECT_EQ(Legs[0].DDestination, 1);
+    EXPECT_EQ(Legs[1].DBoardIndex, 1);
+    EXPECT_EQ(Legs[1].DSource, 1);
+    EXPECT_EQ(Legs[1].DDestination, 2);
+}
+
+TEST(RaptorRouter, TransferTest){
+    // Route 0 rides 0 to 1, route 1 rides 2 to 3, and 1 and 2 are joined by a walk. Route 2 rides
+    // 0 to 3 directly but slowly.
+    std::vector< CRaptorRouter::SRoute > Routes = {{{0, 1}, {10.0}}, {{2, 3}, {10.0}}, {{0, 3}, {100.0}}};
+    std::vector< CRaptorRouter::STransfer > Transfers = {{1, 2, 5.0}};
+    CRaptorRouter Router(4, Routes, Transfers, 1.0, 1.0);
+    EXPECT_EQ(Router.TransferCount(), 1);
+    auto Workspace = Router.CreateWorkspace();
+    std::vector< CRaptorRouter::SLeg > Legs;
+    EXPECT_EQ(Router.FindFastestJourney({{0, 0.0}}, {{3, 0.0}}, 2, Legs, *Workspace), 29.0);
+    ASSERT_EQ(Legs.size(), 5);
+    EXPECT_EQ(Legs[1].DType, ELegType::Ride);
+    EXPECT_EQ(Legs[1].DRoute, 0);
+    EXPECT_EQ(Legs[2].DType, ELegType::Transfer);
+    EXPECT_EQ(Legs[2].DSource, 1);
+    EXPECT_EQ(Legs[2].DDestination, 2);
+    EXPECT_EQ(Legs[3].DType, ELegType::Ride);
+    EXPECT_EQ(Legs[3].DRoute, 1);
+    EXPECT_EQ(Legs[4].DType, ELegType::Egress);
+    // With a single round only the direct route is found
+    EXPECT_EQ(Router.FindFastestJourney({{0, 0.0}}, {{3, 0.0}}, 1, Legs, *Workspace), 102.0);
+    ASSERT_EQ(Legs.size(), 3);
+    EXPECT_EQ(Legs[1].DRoute, 2);
+}
+
+TEST(RaptorRouter, RideTransferRideTest){
+    // Changing routes at a stop alights and boards again
+    std::vector< CRaptorRouter::SRoute > Routes = {{{0, 1}, {10.0}}, {{1, 2}, {10.0}}};
+    CRaptorRouter Router(3, Routes, {}, 2.0, 3.0);
+    std::vector< CRaptorRouter::SLeg > Legs;
+    auto Workspace = Router.CreateWorkspace();
+    EXPECT_EQ(Router.FindFastestJourney({{0, 0.0}}, {{2, 0.0}}, 3, Legs, *Workspace), 30.0);
+    EXPECT_EQ(Legs.size(), 4);
+    EXPECT_EQ(Router.FindFastestJourney({{0, 0.0}}, {{2, 0.0}}, 1, Legs, *Workspace), CRaptorRouter::NoPathExists);
+}
+
+TEST(RaptorRouter, WorkspaceTest){
+    // A workspace of another router is rejected rather than replaced
+    struct SOtherWorkspace : public CRaptorRouter::SQueryWorkspace{
+    };
+    std::vector< CRaptorRouter::SRoute > Routes = {{{0, 1}, {10.0}}};
+    CRaptorRouter Router(2, Routes, {}, 1.0, 1.0);
+    SOtherWorkspace OtherWorkspace;
+    std::vector< CRaptorRouter::SLeg > Legs;
+    EXPECT_THROW(Router.FindFastestJourney({{0, 0.0}}, {{1, 0.0}}, 2, Legs, OtherWorkspace), std::invalid_argument);
+}
@@ -81,3 +81,23 @@ TEST(StringDataSource, ReadTest){
     EXPECT_FALSE(Source2.Peek(TempCh));
     EXPECT_EQ(TempCh,'x');
 }
+
+TEST(StringDataSource, ChunkTest){
+    CStringDataSource EmptySource("");
+    CStringDataSource Source("Hello");
+    char TempCh;
+
+    EXPECT_EQ(EmptySource.Chunk().second,0);
+    auto Chunk = Source.Chunk();
+    ASSERT_EQ(Chunk.second,5);
+    EXPECT_EQ(std::string(Chunk.first,Chunk.second),"Hello");
+    Source.Advance(2);
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh,'l');
+    Chunk = Source.Chunk();
+    EXPECT_EQ(std::string(Chunk.first,Chunk.second),"lo");
+    Source.Advance(5);
+    EXPECT_TRUE(Source.End());
+    EXPECT_EQ(Source.Chunk().second,0);
+    EXPECT_FALSE(Source.Peek(TempCh));
+}
@@ -10,6 +10,9 @@ class CMockTransportationPlanner : public CTransportationPlanner{
         MOCK_METHOD(std::shared_ptr<CStreetMap::SNode> , SortedNodeByIndex, (std::size_t index), (const, noexcept, override));
         MOCK_METHOD(double, FindShortestPath, (TNodeID src, TNodeID dest, std::vector< TNodeID > &path), (override));
         MOCK_METHOD(double, FindFastestPath, (TNodeID src, TNodeID dest, std::vector< TTripStep > &path), (override));
+        MOCK_METHOD(std::unique_ptr<SQueryContext>, CreateQueryContext, (), (const, override));
+        MOCK_METHOD(double, FindShortestPath, (TNodeID src, TNodeID dest, std::vector< TNodeID > &path, SQueryContext &context), (const, override));
+        MOCK_METHOD(double, FindFastestPath, (TNodeID src, TNodeID dest, std::vector< TTripStep > &path, SQueryContext &context), (const, override));
         MOCK_METHOD(bool, GetPathDescription, (const std::vector< TTripStep > &path, std::vector< std::string > &desc), (const, override));
 };
 
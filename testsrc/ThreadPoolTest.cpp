@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPool, ThreadCountTest){
+    CThreadPool Pool(3);
+    EXPECT_EQ(Pool.ThreadCount(), 3);
+    CThreadPool DefaultPool;
+    EXPECT_GE(DefaultPool.ThreadCount(), 1);
+}
+
+TEST(ThreadPool, ParallelForTest){
+    CThreadPool Pool(4);
+    std::vector< std::size_t > Hits(1000, 0);
+    std::vector< std::atomic< std::size_t > > WorkerIndices(1000);
+    Pool.ParallelFor(Hits.size(), [&](std::size_t index, std::size_t worker){
+        Hits[index]++;
+        WorkerIndices[index] = worker;
+    });
+    for(std::size_t Index = 0; Index < Hits.size(); Index++){
+        EXPECT_EQ(Hits[Index], 1);
+        EXPECT_LT(WorkerIndices[Index], Pool.ThreadCount());
+    }
+    bool Called = false;
+    Pool.ParallelFor(0, [&](std::size_t, std::size_t){
+        Called = true;
+    });
+    EXPECT_FALSE(Called);
+}
+
+TEST(ThreadPool, StealTest){
+    // Index zero blocks its worker until every other index has run, which only happens if the other
+    // workers steal the chunks left in the blocked worker's queue. Few enough indices are used that
+    // every chunk holds one.
+    CThreadPool Pool(4);
+    std::atomic< std::size_t > Count(0);
+    bool Finished = false;
+    Pool.ParallelFor(32, [&](std::size_t index, std::size_t){
+        if(!index){
+            auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while((Count != 31)&&(std::chrono::steady_clock::now() < Deadline)){
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            Finished = Count == 31;
+        }
+        else{
+            Count++;
+        }
+    });
+    EXPECT_TRUE(Finished);
+}
+
+TEST(ThreadPool, RepeatTest){
+    CThreadPool Pool(4);
+    for(std::size_t Round = 0; Round < 200; Round++){
+        std::atomic< std::size_t > Sum(0);
+        Pool.ParallelFor(Round, [&](std::size_t index, std::size_t){
+            Sum += index;
+        });
+        EXPECT_EQ(Sum, Round * (Round ? Round - 1 : 0) / 2);
+    }
+}
+
+TEST(ThreadPool, ExceptionTest){
+    CThreadPool Pool(2);
+    std::atomic< std::size_t > Count(0);
+    EXPECT_THROW(Pool.ParallelFor(100, [&](std::size_t index, std::size_t){
+        Count++;
+        if(50 == index){
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+    // The pool is still usable after a task throws
+    Count = 0;
+    Pool.ParallelFor(100, [&](std::size_t, std::size_t){
+        Count++;
+    });
+    EXPECT_EQ(Count, 100);
+}
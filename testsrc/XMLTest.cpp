@@ -4,6 +4,9 @@
 #include "StringUtils.h"
 #include "StringDataSource.h"
 #include "StringDataSink.h"
+#include "MMapDataSource.h"
+#include <cstdio>
+#include <fstream>
 
 TEST(XMLReaderTest, SimpleTest){
     auto InStream = std::make_shared<CStringDataSource>("<element name=\"val\"></element>");
@@ -192,6 +195,153 @@ TEST(XMLReaderTest, LongCDataTest){
     EXPECT_TRUE(Reader.End());
 }*/
 
+TEST(XMLReaderTest, ViewTest){
+    auto InStream = std::make_shared<CStringDataSource>("<osm version=\"0.6\">\n"
+                                                        "\t<node id=\"1\" lat=\"38.5\" lon=\"-121.7\">\n"
+                                                        "\t\t<tag k=\"name\" v=\"A &amp; B\"/>\n"
+                                                        "\t</node>\n"
+                                                        "</osm>");
+    CXMLReader Reader(InStream);
+    auto NodeName = Reader.Intern("node");
+    auto IDName = Reader.Intern("id");
+    auto LonName = Reader.Intern("lon");
+    auto MissingName = Reader.Intern("missing");
+    SXMLEntityView Entity;
+
+    EXPECT_EQ(Reader.Intern("node"), NodeName);
+    EXPECT_NE(IDName, NodeName);
+    ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "osm");
+    EXPECT_EQ(Entity.DNameID, Reader.Intern("osm"));
+    ASSERT_EQ(Entity.DAttributeCount, 1);
+    EXPECT_EQ(Entity.DAttributes[0].DName, "version");
+    EXPECT_EQ(Entity.DAttributes[0].DValue, "0.6");
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DNameID, NodeName);
+    EXPECT_EQ(Entity.DAttributeCount, 3);
+    EXPECT_TRUE(Entity.AttributeExists(LonName));
+    EXPECT_EQ(Entity.AttributeValue(IDName), "1");
+    EXPECT_EQ(Entity.AttributeValue(LonName), "-121.7");
+    // Values end with a null, as does the empty value of a missing attribute
+    EXPECT_STREQ(Entity.AttributeValue(LonName).data(), "-121.7");
+    EXPECT_FALSE(Entity.AttributeExists(MissingName));
+    EXPECT_EQ(Entity.AttributeValue(MissingName), "");
+    EXPECT_STREQ(Entity.AttributeValue(MissingName).data(), "");
+
+    ASSERT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameID, SXMLEntityView::InvalidNameID);
+    ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DNameData, "tag");
+    EXPECT_EQ(Entity.AttributeValue(Reader.Intern("v")), "A & B");
+    ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "tag");
+    EXPECT_EQ(Entity.DAttributeCount, 0);
+    ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DNameID, NodeName);
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+
+    // Entities can still be read as copies from the same reader
+    SXMLEntity Copy;
+    ASSERT_TRUE(Reader.ReadEntity(Copy, true));
+    EXPECT_EQ(Copy.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Copy.DNameData, "osm");
+    EXPECT_FALSE(Reader.ReadEntity(Entity, true));
+    EXPECT_TRUE(Reader.End());
+}
+
+TEST(XMLReaderTest, MappedFileTest){
+    // Large enough that elements straddle the chunks the reader parses a mapped file in
+    const std::string Filename = "./testtmp/mapped.xml";
+    const int NodeCount = 5000;
+    {
+        std::ofstream File(Filename, std::ios::trunc);
+        File<<"<osm>\n";
+        for(int Index = 0; Index < NodeCount; Index++){
+            File<<"\t<node id=\""<<Index<<"\" lat=\"38.5178523\" lon=\"-121.7712408\"/>\n";
+        }
+        File<<"</osm>\n";
+    }
+    CXMLReader Reader(std::make_shared<CMMapDataSource>(Filename));
+    SXMLEntity Entity;
+
+    EXPECT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DNameData, "osm");
+    for(int Index = 0; Index < NodeCount; Index++){
+        ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+        EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+        EXPECT_EQ(Entity.AttributeValue("id"), std::to_string(Index));
+        EXPECT_EQ(Entity.AttributeValue("lon"), "-121.7712408");
+        ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+        EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    }
+    EXPECT_TRUE(Reader.ReadEntity(Entity, true));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "osm");
+    EXPECT_FALSE(Reader.ReadEntity(Entity, true));
+    EXPECT_TRUE(Reader.End());
+    std::remove(Filename.c_str());
+}
+
+TEST(XMLReaderTest, QueuedEntitiesTest){
+    // Three chunks' worth of elements, read with at most ten entities parsed ahead
+    std::string Document = "<osm>";
+    const int NodeCount = 8000;
+    for(int Index = 0; Index < NodeCount; Index++){
+        Document += "<node id=\"" + std::to_string(Index) + "\" lat=\"38.5178523\" lon=\"-121.7712408\"/>";
+    }
+    Document += "</osm>";
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Document), 0, 10);
+    SXMLEntityView Entity;
+    auto IDName = Reader.Intern("id");
+
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "osm");
+    for(int Index = 0; Index < NodeCount; Index++){
+        ASSERT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+        EXPECT_EQ(Entity.AttributeValue(IDName), std::to_string(Index));
+        ASSERT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    }
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "osm");
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
+
+    auto Statistics = Reader.ParseStatistics();
+    EXPECT_EQ(Statistics.DBytesParsed, Document.size());
+    // The chunk size is clamped up to MinChunkSize
+    EXPECT_EQ(Statistics.DChunkCount, (Document.size() + CXMLReader::MinChunkSize - 1) / CXMLReader::MinChunkSize);
+    EXPECT_LE(Statistics.DPeakQueuedEntities, 11);
+    EXPECT_GE(Statistics.DSuspendCount, NodeCount * 2 / 11);
+}
+
+TEST(XMLReaderTest, StatisticsTest){
+    std::string Document = "<osm>";
+    for(int Index = 0; Index < 20000; Index++){
+        Document += "<node id=\"" + std::to_string(Index) + "\"/>";
+    }
+    Document += "</osm>";
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Document), CXMLReader::MaxChunkSize * 4);
+    SXMLEntity Entity;
+
+    EXPECT_EQ(Reader.ParseStatistics().DBytesParsed, 0);
+    EXPECT_EQ(Reader.ParseStatistics().BytesPerSecond(), 0.0);
+    std::size_t EntityCount = 0;
+    while(Reader.ReadEntity(Entity)){
+        EntityCount++;
+    }
+    EXPECT_EQ(EntityCount, 40002);
+    auto Statistics = Reader.ParseStatistics();
+    EXPECT_EQ(Statistics.DBytesParsed, Document.size());
+    EXPECT_LE(Statistics.DPeakQueuedEntities, CXMLReader::DefaultMaxQueuedEntities + 1);
+    EXPECT_LT(0.0, Statistics.BytesPerSecond());
+}
+
 TEST(XMLWriterTest, SimpleTest){
     auto OutStream = std::make_shared<CStringDataSink>();
     CXMLWriter Writer(OutStream);